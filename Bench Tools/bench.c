@@ -0,0 +1,397 @@
+/** @file   bench.c
+ *  @brief  Benchmarks of the hot paths of the labs, with stored baselines.
+ *          Each benchmark gives one number, lower being better, timed with
+ *          the DWT cycle counter as the reference clock:
+ *          - the error of Delay_ms(), Delay_us() and SysTick_Wait10ms()
+ *            against the time asked for, in ppm
+ *          - the time of a step of the traffic light FSM, on the lab's own
+ *            tables in Lights.c: cycles on the LaunchPad, and host time on
+ *            the host, where the emulator does not charge RAM
+ *          - on the LaunchPad only, the cycles of a GPIO toggle, by
+ *            read-modify-write of the port and by one store to the pin's
+ *            DATA aperture, which the emulator charges the same
+ *          - on the host only, the labs' own binaries run on the emulator:
+ *            the time from a press of SW1 to the LED in Functional
+ *            Debugging, with presses at random times, and the error of
+ *            SOS's delay(), which sleeps at a lower clock, against the
+ *            emulator's own clock, both read from their output traces
+ *
+ *          On the host each result is printed as "<name> <value> <unit>",
+ *          and -c checks them against a baseline file of "<name>
+ *          <baseline> <limit>" lines: a result above its limit, or one
+ *          that is missing, fails the check and the exit code is 1. -r
+ *          checks a results file instead, e.g. one written from a
+ *          LaunchPad run. There the results are left in Results[], in the
+ *          same order, for the debugger to read out.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#include "tm4c123.h"
+#include "Pin.h"
+#include "Gpio.h"
+#include "Clock.h"
+#include "Debounce.h"
+#include "../Traffic Light Simulator/Lights.h"
+#include "../SysTick Timer/SysTick.h"
+#include "../SysTick Timer/Delay.h"
+#ifdef HOST_BUILD
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+#define TOGGLES         1000
+#define FSM_STEPS       100000
+#define PRESSES         50
+#define DEBOUNCE_HZ     500         // Functional Debugging samples the switches every 2 ms
+#define MAX_RESULTS     16
+
+/* The labs as their READMEs build them */
+#define DEBUGGING       "../Functional Debugging/debugging"
+#define SOS             "../SOS/sos"
+
+#define LED             PIN(GPIO_PORTF_BASE, 0x02)  // PF1, red LED
+
+typedef struct {
+    const char *Name;
+    const char *Unit;
+    double Value;
+} Result;
+
+Result Results[MAX_RESULTS];
+unsigned long NumResults;
+
+/* PF4 and PF0 through their bit-specific address, as Functional Debugging */
+const unsigned long Switches[1] = {PIN_ADDR(GPIO_PORTF_BASE, 0x11)};
+
+/* Cheap deterministic random numbers */
+static unsigned long Seed = 1;
+static unsigned long rnd(void) {
+    Seed = Seed * 1103515245UL + 12345UL;
+    return (Seed >> 16) & 0x7FFF;
+}
+
+static void result(const char *name, double value, const char *unit) {
+    if (NumResults < MAX_RESULTS) {
+        Results[NumResults].Name = name;
+        Results[NumResults].Unit = unit;
+        Results[NumResults].Value = value;
+        NumResults++;
+    }
+#ifdef HOST_BUILD
+    printf("%s %.2f %s\n", name, value, unit);
+#endif
+}
+
+/* The reference clock, in cycles */
+static unsigned long cycles(void) {
+    return DWT_CYCCNT_R;
+}
+
+#ifndef HOST_BUILD
+static void gpio_toggle(void) {
+    unsigned long i, t, v = 0;
+    t = cycles();
+    for (i = 0; i < TOGGLES; i++) {
+        GPIO_PORTF_DATA_R ^= 0x02;
+    }
+    t = (cycles() - t) & 0xFFFFFFFF;
+    result("gpio_rmw_cycles", (double)t / TOGGLES, "cycles");
+    result("gpio_rmw_max_hz", Clock_Hz() / (2.0 * t / TOGGLES), "Hz");
+    t = cycles();
+    for (i = 0; i < TOGGLES; i++) {
+        v ^= 0x02;
+        LED = v;
+    }
+    t = (cycles() - t) & 0xFFFFFFFF;
+    result("gpio_pin_cycles", (double)t / TOGGLES, "cycles");
+    result("gpio_pin_max_hz", Clock_Hz() / (2.0 * t / TOGGLES), "Hz");
+}
+#endif
+
+/* How far off a wait was from the time wanted, in ppm */
+static double ppm(double took, double wanted) {
+    double e = (took - wanted) * 1e6 / wanted;
+    return e < 0 ? -e : e;
+}
+
+static void delays(void) {
+    unsigned long t, hz = Clock_Hz();
+    t = cycles();
+    Delay_ms(1);
+    t = (cycles() - t) & 0xFFFFFFFF;
+    result("delay_ms_1_error", ppm(t, hz / 1000), "ppm");
+    t = cycles();
+    Delay_ms(50);
+    t = (cycles() - t) & 0xFFFFFFFF;
+    result("delay_ms_50_error", ppm(t, hz / 20), "ppm");
+    t = cycles();
+    Delay_us(100);
+    t = (cycles() - t) & 0xFFFFFFFF;
+    result("delay_us_100_error", ppm(t, hz / 10000), "ppm");
+    t = cycles();
+    SysTick_Wait10ms(1);
+    t = (cycles() - t) & 0xFFFFFFFF;
+    result("systick_wait10ms_error", ppm(t, hz / 100), "ppm");
+}
+
+/* The lab's step: reading the sensors and taking the transition */
+static void fsm_step(void) {
+    unsigned long i, s = goN;
+    volatile unsigned long input;
+#ifdef HOST_BUILD
+    struct timespec a, b;
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    for (i = 0; i < FSM_STEPS; i++) {
+        input = (Debounce_State() ^ i) & 3;
+        s = FSM_INDEXED(Index, LIGHTS_SENSORS, s, input);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    result("fsm_step_host_ns", ((b.tv_sec - a.tv_sec) * 1e9 + (b.tv_nsec - a.tv_nsec)) / FSM_STEPS, "ns");
+#else
+    unsigned long t = cycles();
+    for (i = 0; i < FSM_STEPS; i++) {
+        input = (Debounce_State() ^ i) & 3;
+        s = FSM_INDEXED(Index, LIGHTS_SENSORS, s, input);
+    }
+    t = (cycles() - t) & 0xFFFFFFFF;
+    result("fsm_step_cycles", (double)t / FSM_STEPS, "cycles");
+#endif
+}
+
+#ifdef HOST_BUILD
+/* Runs a lab's own binary on the emulator for the virtual seconds given,
+   with its inputs from a stimulus file, and opens its output changes,
+   "<ns> <cycles> P<port> <hex>" lines. A lab loops forever, so it must
+   end at the time limit; if it does not, it returns 0. */
+static FILE *lab(const char *path, const char *stimulus, const char *seconds) {
+    char trace[] = "/tmp/bench-trace-XXXXXX";
+    int fd = mkstemp(trace), status;
+    pid_t pid;
+    FILE *f;
+    if (fd < 0) {
+        return 0;
+    }
+    close(fd);
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0) {
+        fd = open("/dev/null", O_WRONLY);
+        dup2(fd, 1);
+        dup2(fd, 2);
+        setenv("MMIO_SECONDS", seconds, 1);
+        setenv("MMIO_STIMULUS", stimulus, 1);
+        setenv("MMIO_TRACE", trace, 1);
+        execl(path, path, (char *)0);
+        _exit(127);
+    }
+    if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != MMIO_TIMEOUT) {
+        fprintf(stderr, "%s did not run, build it as its README says\n", path);
+        unlink(trace);
+        return 0;
+    }
+    f = fopen(trace, "r");
+    unlink(trace);
+    return f;
+}
+
+/* Writes a stimulus file to a temporary name */
+static int stimulus(char *name, const double *at, const char *const *change, unsigned long n) {
+    unsigned long i;
+    int fd = mkstemp(name);
+    FILE *f = fd < 0 ? 0 : fdopen(fd, "w");
+    if (!f) {
+        return 0;
+    }
+    for (i = 0; i < n; i++) {
+        fprintf(f, "%.6f %s\n", at[i], change[i]);
+    }
+    fclose(f);
+    return 1;
+}
+
+/* The next change of port F in a trace; 0 at its end */
+static int change(FILE *trace, unsigned long long *ns, unsigned long *out) {
+    char line[128], port;
+    unsigned long long cycles;
+    while (fgets(line, sizeof(line), trace)) {
+        if (sscanf(line, "%llu %llu P%c %lx", ns, &cycles, &port, out) == 4 && port == 'F') {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Functional Debugging: SW1 pressed for 200 ms every 500 ms, at a random
+   time into the first 160 ms, so the release is seen and the LED off
+   before each press. The latency is to the first change that lights PF1. */
+static void fd_latency(void) {
+    char name[] = "/tmp/bench-stimulus-XXXXXX";
+    static const char *const edges[2] = {"PF4=0", "PF4=1"};
+    double at[2 * PRESSES];
+    const char *what[2 * PRESSES];
+    unsigned long i, out = 0;
+    unsigned long long ns = 0, pressed, took, worst = 0, total = 0;
+    FILE *t;
+    for (i = 0; i < PRESSES; i++) {
+        at[2 * i] = 200.0 + i * 500 + rnd() * 160.0 / 0x8000;
+        at[2 * i + 1] = at[2 * i] + 200;
+        what[2 * i] = edges[0];
+        what[2 * i + 1] = edges[1];
+    }
+    if (!stimulus(name, at, what, 2 * PRESSES)) {
+        return;
+    }
+    t = lab(DEBUGGING, name, "26");
+    unlink(name);
+    if (!t) {
+        return;
+    }
+    for (i = 0; i < PRESSES; i++) {
+        pressed = (unsigned long long)(at[2 * i] * 1e6);
+        while (ns < pressed || !(out & 0x02)) {
+            if (!change(t, &ns, &out)) {
+                fclose(t);
+                return;                 // missing, which fails the check
+            }
+        }
+        took = ns - pressed;
+        total += took;
+        worst = took > worst ? took : worst;
+    }
+    fclose(t);
+    result("fd_latency_mean", (double)total / PRESSES / 1e3, "us");
+    result("fd_latency_worst", (double)worst / 1e3, "us");
+}
+
+/* SOS: the first message after a press of SW1. Each change of the LED
+   comes a delay() after the one before, of these half-seconds. */
+static const unsigned char SosHalves[] = {1, 1, 1, 1, 1, 1, 4, 4, 4, 4, 4, 4, 1, 1, 1, 1, 1};
+
+static void sos_delay(void) {
+    char name[] = "/tmp/bench-stimulus-XXXXXX";
+    static const double at[2] = {100, 300};
+    static const char *const what[2] = {"PF4=0", "PF4=1"};
+    unsigned long i, out;
+    unsigned long long ns, last;
+    double e, worst = 0;
+    FILE *t;
+    if (!stimulus(name, at, what, 2)) {
+        return;
+    }
+    t = lab(SOS, name, "18");
+    unlink(name);
+    if (!t) {
+        return;
+    }
+    if (!change(t, &last, &out)) {
+        fclose(t);
+        return;
+    }
+    for (i = 0; i < sizeof(SosHalves); i++) {
+        if (!change(t, &ns, &out)) {
+            fclose(t);
+            return;
+        }
+        e = ppm(ns - last, SosHalves[i] * 5e8);
+        worst = e > worst ? e : worst;
+        last = ns;
+    }
+    fclose(t);
+    result("sos_delay_error", worst, "ppm");
+}
+
+/* Checks results against the baseline file; returns the regressions and
+   the results missing */
+static unsigned long compare(const char *baselines, const char *results) {
+    FILE *f = fopen(baselines, "r"), *r = results ? fopen(results, "r") : 0;
+    char line[256], name[64], rname[64];
+    double base, limit, value;
+    unsigned long i, failed = 0, found;
+    if (!f || (results && !r)) {
+        fprintf(stderr, "cannot open %s\n", !f ? baselines : results);
+        exit(2);
+    }
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#' || sscanf(line, "%63s %lf %lf", name, &base, &limit) != 3) {
+            continue;
+        }
+        found = 0;
+        if (r) {
+            rewind(r);
+            while (!found && fgets(line, sizeof(line), r)) {
+                found = sscanf(line, "%63s %lf", rname, &value) == 2 && !strcmp(rname, name);
+            }
+        } else {
+            for (i = 0; i < NumResults && !found; i++) {
+                if (!strcmp(Results[i].Name, name)) {
+                    value = Results[i].Value;
+                    found = 1;
+                }
+            }
+        }
+        if (!found) {
+            printf("MISSING %s\n", name);
+            failed++;
+        } else if (value > limit) {
+            printf("REGRESSION %s %.2f, baseline %.2f, limit %.2f\n", name, value, base, limit);
+            failed++;
+        }
+    }
+    fclose(f);
+    if (r) {
+        fclose(r);
+    }
+    printf("regressions %lu\n", failed);
+    return failed;
+}
+#endif
+
+static void run(void) {
+    Gpio_Clocks(SYSCTL_RCGC2_GPIOF);
+    GPIO_CONFIG(F, 0x11, 0x0E, 0x11, 0, 0, 0, 0);
+    SysTick_Init();
+    Delay_Init();
+    NVIC_DBG_INT_R |= NVIC_DBG_INT_TRCENA;
+    DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+    Debounce_Start(Switches, 1, 0x11, Clock_Hz() / DEBOUNCE_HZ);
+#ifndef HOST_BUILD
+    gpio_toggle();
+#endif
+    delays();
+    fsm_step();
+#ifdef HOST_BUILD
+    fd_latency();
+    sos_delay();
+#endif
+}
+
+#ifdef HOST_BUILD
+int main(int argc, char **argv) {
+    if (argc == 4 && !strcmp(argv[1], "-r")) {
+        return compare(argv[3], argv[2]) != 0;
+    }
+    if (argc != 1 && !(argc == 3 && !strcmp(argv[1], "-c"))) {
+        fprintf(stderr, "usage: %s [-c baseline]\n       %s -r results baseline\n", argv[0], argv[0]);
+        return 2;
+    }
+    run();
+    if (argc == 3) {
+        return compare(argv[2], 0) != 0;
+    }
+    return 0;
+}
+#else
+int main(void) {
+    run();
+    while (1) {
+        WaitForInterrupt();         // Results[] is ready for the debugger
+    }
+}
+#endif
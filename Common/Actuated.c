@@ -0,0 +1,52 @@
+#include "Actuated.h"
+
+/* Ticks until a gap or the minimum could end the state */
+static unsigned long wait(const Actuated *a, const ActuatedTiming *t) {
+    unsigned long until = a->Held < t->Min ? t->Min - a->Held : 0;
+    if (until > t->Gap) {
+        return until - t->Gap;      // wake a gap early, to time it from the sensors
+    }
+    return until && !t->Gap ? until : 1;
+}
+
+unsigned long Actuated_Start(Actuated *a, const ActuatedTiming *timing, unsigned long s) {
+    a->S = s;
+    a->Held = 0;
+    a->Idle = 0;
+    a->Called = 0;
+    return wait(a, &timing[s]);
+}
+
+unsigned long Actuated_Step(Actuated *a, const FsmState *states, const FsmArc *arcs,
+                            const ActuatedTiming *timing, unsigned long input, unsigned long ticks) {
+    const ActuatedTiming *t = &timing[a->S];
+    unsigned long next = Fsm_Next(states, arcs, a->S, input);
+    a->Held += ticks;
+    a->Idle = (input & t->Extend) ? 0 : a->Idle + ticks;
+    // from the step that first sees the call: the wait before it may be
+    // long, and the call may have come at its very end
+    a->Called = next == a->S ? 0 : a->Called ? a->Called + ticks : 1;
+    if (next != a->S && a->Held >= t->Min && (a->Idle >= t->Gap || a->Called >= t->Max)) {
+        return Actuated_Start(a, timing, next);
+    }
+    return wait(a, t);
+}
+
+/* The step of an ActuatedControl */
+static unsigned long step(FsmControl *control, unsigned long input, unsigned long ticks) {
+    ActuatedControl *c = (ActuatedControl *)control;
+    unsigned long w = Actuated_Step(&c->Ctl, c->States, c->Arcs, c->Timing, input, ticks);
+    control->S = c->Ctl.S;
+    return w;
+}
+
+unsigned long Actuated_Control(ActuatedControl *c, const FsmState *states, const FsmArc *arcs,
+                               const ActuatedTiming *timing, unsigned long s) {
+    c->Control.Step = step;
+    c->Control.S = s;
+    c->Control.Event = 0;
+    c->States = states;
+    c->Arcs = arcs;
+    c->Timing = timing;
+    return Actuated_Start(&c->Ctl, timing, s);
+}
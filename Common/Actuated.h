@@ -0,0 +1,101 @@
+/** @file   Actuated.h
+ *  @brief  Actuated control of a traffic light's FSM. A fixed-time table
+ *          holds every state for its full time and only then reads the
+ *          sensors, so a green with no cars runs on while cars queue on the
+ *          other road. Here each state has a minimum and a maximum, and a
+ *          gap:
+ *          - the state holds at least its minimum
+ *          - after that, it ends as soon as its own road has had no car for
+ *            the gap, or once the other road has waited the maximum
+ *          - while no other road waits, a green rests, however long
+ *          "The other road waits" is the table's own test: an arc of the
+ *          state matches the sensors, or its default leads elsewhere, as for
+ *          a yellow, which with a gap of 0 and its time as the minimum runs
+ *          as before. The cars that hold a green are the inputs in its
+ *          Extend mask.
+ *
+ *          The controller calls Actuated_Step() with the sensors whenever
+ *          the wait it returned is over. The wait is one tick while a gap
+ *          could end the state, and otherwise as long as nothing can happen,
+ *          so the controller sleeps through the minimum. The sensors are
+ *          sampled in the background, e.g. with Common/Debounce.h.
+ *
+ *          Example, goNorth held 10 to 30 s, until 3 s without a car north:
+ *              const ActuatedTiming Actuation[] = {
+ *                  {1000, 3000, 300, 0x02},    // Min, Max, Gap, Extend
+ *                  ...
+ *              };
+ *              wait = Actuated_Start(&Ctl, Actuation, goN);
+ *              ...
+ *              wait = Actuated_Step(&Ctl, FSM, Arcs, Actuation, Input, wait);
+ *              S = Ctl.S;
+ *          or the same through an FsmControl (see Fsm.h), with
+ *          Actuated_Control() in place of Actuated_Start().
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef ACTUATED_H
+#define ACTUATED_H
+
+#include "Fsm.h"
+
+typedef struct {
+    unsigned short Min;             // shortest the state holds, in ticks
+    unsigned short Max;             // longest another road waits for it to end
+    unsigned short Gap;             // ticks without a car on its road that end it
+    unsigned short Extend;          // inputs whose cars are on its road
+} ActuatedTiming;
+
+typedef struct {
+    unsigned long S;                // current state
+    unsigned long Held;             // ticks in it
+    unsigned long Idle;             // ticks since a car on its road
+    unsigned long Called;           // ticks another road has waited, from the step that saw it
+} Actuated;
+
+typedef struct {
+    FsmControl Control;             // first, for its Step()
+    Actuated Ctl;
+    const FsmState *States;
+    const FsmArc *Arcs;
+    const ActuatedTiming *Timing;
+} ActuatedControl;
+
+/** @fn     Actuated_Start(Actuated *, const ActuatedTiming *, unsigned long)
+ *  @brief  Starts a controller.
+ *  @param  Controller.
+ *  @param  Timing of each state.
+ *  @param  State to start in.
+ *  @return Ticks until the first Actuated_Step().
+ */
+unsigned long Actuated_Start(Actuated *a, const ActuatedTiming *timing, unsigned long s);
+
+/** @fn     Actuated_Step(Actuated *, const FsmState *, const FsmArc *, const ActuatedTiming *, unsigned long, unsigned long)
+ *  @brief  Takes the sensors, once the wait returned last time is over,
+ *          and moves to the next state if the current one is done.
+ *  @param  Controller.
+ *  @param  States.
+ *  @param  Arcs.
+ *  @param  Timing of each state.
+ *  @param  Inputs, one per bit.
+ *  @param  Ticks since the last call, the wait it returned.
+ *  @return Ticks until the next call.
+ */
+unsigned long Actuated_Step(Actuated *a, const FsmState *states, const FsmArc *arcs,
+                            const ActuatedTiming *timing, unsigned long input, unsigned long ticks);
+
+/** @fn     Actuated_Control(ActuatedControl *, const FsmState *, const FsmArc *, const ActuatedTiming *, unsigned long)
+ *  @brief  Starts a controller that steps by Actuated_Step() through its
+ *          Control.
+ *  @param  Controller.
+ *  @param  States.
+ *  @param  Arcs.
+ *  @param  Timing of each state.
+ *  @param  State to start in.
+ *  @return Ticks until the first step.
+ */
+unsigned long Actuated_Control(ActuatedControl *c, const FsmState *states, const FsmArc *arcs,
+                               const ActuatedTiming *timing, unsigned long s);
+
+#endif
@@ -0,0 +1,49 @@
+#include "tm4c123.h"
+#include "Clock.h"
+
+/* Crystal frequencies selected by RCC XTAL values 0x06 to 0x1A */
+static const unsigned long Xtal[] = {
+    4000000, 4096000, 4915200, 5000000, 5120000, 6000000, 6144000,
+    7372800, 8000000, 8192000, 10000000, 12000000, 12288000, 13560000,
+    14318180, 16000000, 16384000, 18000000, 20000000, 24000000, 25000000
+};
+
+static unsigned long oscillator(unsigned long rcc, unsigned long src) {
+    unsigned long xtal = (rcc & SYSCTL_RCC_XTAL_M) >> 6;
+    switch (src) {
+    case SYSCTL_RCC2_OSCSRC2_MO:
+        return (xtal >= 0x06 && xtal <= 0x1A) ? Xtal[xtal - 0x06] : PIOSC_HZ;
+    case SYSCTL_RCC2_OSCSRC2_IO:  return PIOSC_HZ;
+    case SYSCTL_RCC2_OSCSRC2_IO4: return PIOSC_HZ / 4;
+    case SYSCTL_RCC2_OSCSRC2_30:  return LFIOSC_HZ;
+    default:                      return HIBOSC_HZ;
+    }
+}
+
+unsigned long Clock_Hz(void) {
+    return Clock_HzOf(SYSCTL_RCC_R, SYSCTL_RCC2_R);
+}
+
+/* RCC2 overrides the matching RCC fields when USERCC2 is set */
+unsigned long Clock_HzOf(unsigned long rcc, unsigned long rcc2) {
+    unsigned long bypass, pwrdn, src, div;
+    if (rcc2 & SYSCTL_RCC2_USERCC2) {
+        bypass = rcc2 & SYSCTL_RCC2_BYPASS2;
+        pwrdn = rcc2 & SYSCTL_RCC2_PWRDN2;
+        src = rcc2 & SYSCTL_RCC2_OSCSRC2_M;
+        div = (rcc2 & SYSCTL_RCC2_SYSDIV2_M) >> 23;
+    } else {
+        bypass = rcc & SYSCTL_RCC_BYPASS;
+        pwrdn = rcc & SYSCTL_RCC_PWRDN;
+        src = rcc & SYSCTL_RCC_OSCSRC_M;
+        div = (rcc & SYSCTL_RCC_SYSDIV_M) >> 23;
+    }
+    if (!bypass && !pwrdn) {
+        if ((rcc2 & SYSCTL_RCC2_USERCC2) && (rcc2 & SYSCTL_RCC2_DIV400)) {
+            return 400000000UL / (((div << 1) | ((rcc2 & SYSCTL_RCC2_SYSDIV2LSB) != 0)) + 1);
+        }
+        return 200000000UL / (div + 1);
+    }
+    src = oscillator(rcc, src);
+    return (rcc & SYSCTL_RCC_USESYSDIV) ? src / (div + 1) : src;
+}
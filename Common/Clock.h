@@ -0,0 +1,34 @@
+/** @file   Clock.h
+ *  @brief  Works out the system clock from the RCC/RCC2 registers, so code
+ *          that depends on the clock rate follows whatever PLL_Init() or
+ *          the reset configuration selected instead of assuming 80 MHz.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#define PIOSC_HZ        16000000    // precision internal oscillator
+#define LFIOSC_HZ       30000       // low-frequency internal oscillator (nominal)
+#define HIBOSC_HZ       32768       // hibernation module oscillator
+
+/** @fn     Clock_Hz(void)
+ *  @brief  Reads the clock source, PLL and divider settings and returns the
+ *          resulting system clock. A PLL that is selected but has not locked
+ *          yet is reported at its final frequency.
+ *  @param  NULL
+ *  @return System clock in Hz.
+ */
+unsigned long Clock_Hz(void);
+
+/** @fn     Clock_HzOf(unsigned long, unsigned long)
+ *  @brief  System clock that the given RCC and RCC2 values would select,
+ *          worked out the same way as Clock_Hz() without touching them.
+ *  @param  RCC value.
+ *  @param  RCC2 value.
+ *  @return System clock in Hz.
+ */
+unsigned long Clock_HzOf(unsigned long rcc, unsigned long rcc2);
+
+#endif
@@ -0,0 +1,76 @@
+#include "Coord.h"
+
+#define DEMAND          0xFFFF      // a car on every input
+
+int Coord_Plan(CoordPlan *p, const FsmState *states, const FsmArc *arcs,
+               unsigned long count, unsigned long cycle, unsigned long offset) {
+    unsigned long s, n, rest = 0;
+    if (!cycle) {
+        return 0;
+    }
+    s = Fsm_Next(states, arcs, 0, DEMAND);
+    for (n = 0; s != 0; n++) {
+        if (n >= count) {
+            return 0;               // a loop that misses state 0
+        }
+        rest += states[s].Time;
+        s = Fsm_Next(states, arcs, s, DEMAND);
+    }
+    if (rest >= cycle) {
+        return 0;
+    }
+    p->Cycle = cycle;
+    p->Offset = offset % cycle;
+    p->Green = cycle - rest;
+    p->Epoch = 0;
+    return 1;
+}
+
+unsigned long Coord_Next(const FsmState *states, const FsmArc *arcs,
+                         unsigned long s, unsigned long input) {
+    return Fsm_Next(states, arcs, s, s == 0 ? input : DEMAND);
+}
+
+unsigned long Coord_Wait(const CoordPlan *p, const FsmState *states,
+                         unsigned long s, unsigned long long now) {
+    unsigned long at, end, wait;
+    if (s != 0) {
+        return states[s].Time;
+    }
+    at = (unsigned long)((now + p->Cycle - p->Epoch) % p->Cycle);  // where the common cycle is
+    end = (p->Offset + p->Green) % p->Cycle;
+    wait = (end + p->Cycle - at) % p->Cycle;
+    if (wait < p->Green / 2) {
+        wait += p->Cycle;           // too short a green: the long way round
+    }
+    return wait;
+}
+
+void Coord_Sync(CoordPlan *p, unsigned long long now) {
+    p->Epoch = (unsigned long)(now % p->Cycle);
+}
+
+/* The step of a CoordControl */
+static unsigned long step(FsmControl *control, unsigned long input, unsigned long ticks) {
+    CoordControl *c = (CoordControl *)control;
+    c->Now += ticks;
+    if (!c->Coordinated) {
+        control->S = Fsm_Next(c->States, c->Arcs, control->S, input);
+        return c->States[control->S].Time;
+    }
+    control->S = Coord_Next(c->States, c->Arcs, control->S, input);
+    return Coord_Wait(&c->Plan, c->States, control->S, c->Now);
+}
+
+unsigned long Coord_Control(CoordControl *c, const FsmState *states, const FsmArc *arcs,
+                            unsigned long count, unsigned long cycle, unsigned long offset,
+                            unsigned long s) {
+    c->Control.Step = step;
+    c->Control.S = s;
+    c->Control.Event = 0;
+    c->Coordinated = Coord_Plan(&c->Plan, states, arcs, count, cycle, offset);
+    c->States = states;
+    c->Arcs = arcs;
+    c->Now = 0;
+    return c->Coordinated ? Coord_Wait(&c->Plan, states, s, 0) : states[s].Time;
+}
@@ -0,0 +1,128 @@
+/** @file   Coord.h
+ *  @brief  Coordination of traffic lights along a corridor. Each controller
+ *          free-running on its own table drifts against its neighbours, and
+ *          a platoon let through one light meets red at the next. Here all
+ *          the controllers share a cycle length and a timebase, and each has
+ *          an offset: the point of the common cycle where its coordinated
+ *          green, state 0 of its table, starts. With offsets that follow the
+ *          travel time between the lights, a platoon finds green all along.
+ *
+ *          The coordinated green ends at a fixed point of the cycle, the
+ *          cycle less the states that follow it, so it takes up whatever the
+ *          rest of the cycle leaves. Every other state keeps the time of
+ *          its table. The coordinated green keeps its arcs, and one with no
+ *          car to hand over to holds until its end point comes round again;
+ *          the other states go on to the next as if a car were waiting on
+ *          every input, so the coordinated green always comes back. A
+ *          controller that got off the plan, at power-up or after the
+ *          timebase moved, comes back to it with its next coordinated
+ *          green, which is never cut below half its planned length.
+ *
+ *          The timebase is a sync pulse at the start of every common cycle,
+ *          e.g. from a master controller or a GPS receiver; each pulse takes
+ *          out the drift of the local clock since the one before. Before the
+ *          first pulse, the controller's own start counts as one.
+ *
+ *          Example, for a controller running on Periodic ticks:
+ *              Coord_Plan(&Plan, FSM, Arcs, 4, 7000, 1200);
+ *              ...
+ *              S = Coord_Next(FSM, Arcs, S, Input);
+ *              wait = Coord_Wait(&Plan, FSM, S, Timing.Releases);
+ *          or the same through an FsmControl (see Fsm.h):
+ *              wait = Coord_Control(&Coord, FSM, Arcs, 4, 7000, 1200, 0);
+ *              ...
+ *              wait = Coord.Control.Step(&Coord.Control, Input, wait);
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef COORD_H
+#define COORD_H
+
+#include "Fsm.h"
+
+typedef struct {
+    unsigned long Cycle;            // common cycle, in ticks
+    unsigned long Offset;           // start of the coordinated green in the common cycle
+    unsigned long Green;            // planned length of the coordinated green
+    volatile unsigned long Epoch;   // local tick of the latest sync pulse, modulo Cycle
+} CoordPlan;
+
+typedef struct {
+    FsmControl Control;             // first, for its Step()
+    CoordPlan Plan;
+    int Coordinated;                // 0 if the plan does not fit the table
+    const FsmState *States;
+    const FsmArc *Arcs;
+    unsigned long long Now;         // ticks since the start
+} CoordControl;
+
+/** @fn     Coord_Plan(CoordPlan *, const FsmState *, const FsmArc *, unsigned long, unsigned long, unsigned long)
+ *  @brief  Makes a controller's plan. The states after the coordinated
+ *          green are those the table goes through, from state 0 back to
+ *          it, with a car on every input.
+ *  @param  Plan to make.
+ *  @param  States, with state 0 the coordinated green.
+ *  @param  Arcs.
+ *  @param  Number of states.
+ *  @param  Common cycle, in the ticks of the states' times.
+ *  @param  Offset, in ticks, taken modulo the cycle.
+ *  @return 1, or 0 if the table does not come back to state 0, or if the
+ *          states after it leave no green in the cycle.
+ */
+int Coord_Plan(CoordPlan *p, const FsmState *states, const FsmArc *arcs,
+               unsigned long count, unsigned long cycle, unsigned long offset);
+
+/** @fn     Coord_Next(const FsmState *, const FsmArc *, unsigned long, unsigned long)
+ *  @brief  One transition of a coordinated controller. The coordinated
+ *          green waits for a car on another road, as the table says, but
+ *          every other state goes on as if the coordinated road had a car
+ *          waiting, so the cycle comes back to it on time.
+ *  @param  States.
+ *  @param  Arcs.
+ *  @param  Current state.
+ *  @param  Inputs, one per bit.
+ *  @return Next state.
+ */
+unsigned long Coord_Next(const FsmState *states, const FsmArc *arcs,
+                         unsigned long s, unsigned long input);
+
+/** @fn     Coord_Wait(const CoordPlan *, const FsmState *, unsigned long, unsigned long long)
+ *  @brief  How long a state just entered holds.
+ *  @param  Plan.
+ *  @param  States.
+ *  @param  State entered.
+ *  @param  Ticks since the controller started.
+ *  @return The state's time, or for state 0 the ticks to its end point.
+ */
+unsigned long Coord_Wait(const CoordPlan *p, const FsmState *states,
+                         unsigned long s, unsigned long long now);
+
+/** @fn     Coord_Sync(CoordPlan *, unsigned long long)
+ *  @brief  Takes a sync pulse, which marks the start of the common cycle.
+ *          It may be called from an interrupt handler.
+ *  @param  Plan.
+ *  @param  Ticks since the controller started, when the pulse came.
+ *  @return NULL
+ */
+void Coord_Sync(CoordPlan *p, unsigned long long now);
+
+/** @fn     Coord_Control(CoordControl *, const FsmState *, const FsmArc *, unsigned long, unsigned long, unsigned long, unsigned long)
+ *  @brief  Starts a controller that steps by Coord_Next() and waits by
+ *          Coord_Wait(), counting the ticks itself, or by the table alone
+ *          if the plan does not fit it. Sync pulses go to its Plan, once
+ *          Coordinated.
+ *  @param  Controller.
+ *  @param  States, with state 0 the coordinated green.
+ *  @param  Arcs.
+ *  @param  Number of states.
+ *  @param  Common cycle, in the ticks of the states' times.
+ *  @param  Offset, in ticks.
+ *  @param  State to start in.
+ *  @return Ticks until the first step.
+ */
+unsigned long Coord_Control(CoordControl *c, const FsmState *states, const FsmArc *arcs,
+                            unsigned long count, unsigned long cycle, unsigned long offset,
+                            unsigned long s);
+
+#endif
@@ -0,0 +1,92 @@
+#include "tm4c123.h"
+#include "Debounce.h"
+
+#define PRIORITY        3       // below SysTick, which must stay the highest
+
+static Debouncer Inputs;
+static unsigned long Ports[DEBOUNCE_LANES];
+static unsigned long Lanes;
+
+void Debounce_Init(Debouncer *d, unsigned long invert, unsigned long sample) {
+    d->Invert = invert;
+    d->State = sample ^ invert;
+    d->Count0 = d->Count1 = 0;
+    d->Pressed = d->Released = 0;
+}
+
+/* Count1:Count0 counts samples in a row that differ from the state, and
+   is cleared by any that does not. It wraps from 3 back to 0 on the fourth,
+   which is when the state toggles. */
+unsigned long Debounce_Step(Debouncer *d, unsigned long sample) {
+    unsigned long state = d->State;
+    unsigned long delta = (sample ^ d->Invert) ^ state;
+    unsigned long toggle;
+    d->Count1 = (d->Count1 ^ d->Count0) & delta;
+    d->Count0 = ~d->Count0 & delta;
+    toggle = delta & ~(d->Count0 | d->Count1);
+    state ^= toggle;
+    d->State = state;
+    d->Pressed |= toggle & state;
+    d->Released |= toggle & ~state;
+    return toggle;
+}
+
+/* All the lanes in one word */
+static unsigned long sample(void) {
+    unsigned long word = 0, i;
+    for (i = 0; i < Lanes; i++) {
+        word |= (HWREG(Ports[i]) & 0xFF) << (8 * i);
+    }
+    return word;
+}
+
+/* Initialize timer 0A as a periodic interrupt */
+void Debounce_Start(const unsigned long *ports, unsigned long lanes, unsigned long invert, unsigned long period) {
+    unsigned long i;
+    Lanes = lanes > DEBOUNCE_LANES ? DEBOUNCE_LANES : lanes;
+    for (i = 0; i < Lanes; i++) {
+        Ports[i] = ports[i];
+    }
+    Debounce_Init(&Inputs, invert, sample());
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R0;  // activate timer 0
+    (void)SYSCTL_RCGCTIMER_R;                   // allow time for clock to start
+    TIMER0_CTL_R = 0;                           // disable timer 0A during setup
+    TIMER0_CFG_R = TIMER_CFG_32_BIT_TIMER;
+    TIMER0_TAMR_R = TIMER_TAMR_TAMR_PERIOD;
+    TIMER0_TAILR_R = period - 1;
+    TIMER0_ICR_R = TIMER_ICR_TATOCINT;          // clear any timeout
+    TIMER0_IMR_R = TIMER_IMR_TATOIM;
+    NVIC_PRI4_R = (NVIC_PRI4_R & ~NVIC_PRI4_INT19_M) | (PRIORITY << NVIC_PRI4_INT19_S);
+    NVIC_EN0_R = NVIC_EN0_INT19;
+    TIMER0_CTL_R = TIMER_CTL_TAEN;
+    EnableInterrupts();
+}
+
+unsigned long Debounce_State(void) {
+    return Inputs.State;
+}
+
+/* The handler sets bits at any time: read and clear with it held off */
+unsigned long Debounce_Pressed(void) {
+    unsigned long pressed;
+    DisableInterrupts();
+    pressed = Inputs.Pressed;
+    Inputs.Pressed = 0;
+    EnableInterrupts();
+    return pressed;
+}
+
+unsigned long Debounce_Released(void) {
+    unsigned long released;
+    DisableInterrupts();
+    released = Inputs.Released;
+    Inputs.Released = 0;
+    EnableInterrupts();
+    return released;
+}
+
+void Timer0A_Handler(void) {
+    TIMER0_ICR_R = TIMER_ICR_TATOCINT;          // acknowledge
+    Debounce_Step(&Inputs, sample());
+    CPU_CYCLES(30);     // the step: a dozen logic instructions, eleven loads and stores
+}
@@ -0,0 +1,98 @@
+/** @file   Debounce.h
+ *  @brief  Switch and sensor debouncing for whole ports at once. The inputs
+ *          are sampled at a fixed rate from the timer 0A interrupt and a pin
+ *          only changes state after DEBOUNCE_SAMPLES samples in a row agree
+ *          on its new level. Each pin has a two-bit counter, but the
+ *          counters are stored "vertically": bit i of Count0 and Count1 is
+ *          pin i's counter. One step updates every pin with the same
+ *          handful of logic instructions, for 8 inputs or 32.
+ *
+ *          Up to DEBOUNCE_LANES ports are sampled into one word, a byte
+ *          each: the first port in bits 7-0, the next in bits 15-8, and so
+ *          on. Inputs are reported active high, 1 meaning pressed or
+ *          detected, with active-low pins inverted on the way in.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef DEBOUNCE_H
+#define DEBOUNCE_H
+
+#define DEBOUNCE_SAMPLES    4   // samples in a row that make a change
+#define DEBOUNCE_LANES      4   // ports sampled into one word
+
+/* State of a set of debounced inputs. Pressed and Released collect the
+   inputs that became active and inactive until they are read. */
+typedef struct {
+    volatile unsigned long State;       // debounced inputs, 1 = active
+    unsigned long Count0, Count1;       // vertical counters, low and high bit
+    unsigned long Invert;               // inputs that are active low
+    volatile unsigned long Pressed;     // became active since the last read
+    volatile unsigned long Released;    // became inactive since the last read
+} Debouncer;
+
+/** @fn     Debounce_Init(Debouncer *, unsigned long, unsigned long)
+ *  @brief  Starts a debouncer whose state is the given sample, so inputs
+ *          already pressed do not show up as presses.
+ *  @param  Debouncer to initialize.
+ *  @param  Inputs that are active low.
+ *  @param  First sample of the inputs, as read from the port.
+ *  @return NULL
+ */
+void Debounce_Init(Debouncer *d, unsigned long invert, unsigned long sample);
+
+/** @fn     Debounce_Step(Debouncer *, unsigned long)
+ *  @brief  Takes in one sample of all the inputs. An input changes state
+ *          on the DEBOUNCE_SAMPLES-th sample in a row that differs from its
+ *          state; any sample that agrees with the state restarts its count.
+ *  @param  Debouncer to update.
+ *  @param  Sample of the inputs, as read from the port.
+ *  @return Inputs that changed state with this sample.
+ */
+unsigned long Debounce_Step(Debouncer *d, unsigned long sample);
+
+/** @fn     Debounce_Start(const unsigned long *, unsigned long, unsigned long, unsigned long)
+ *  @brief  Samples the given ports every period from the timer 0A
+ *          interrupt, at a priority below SysTick, and enables interrupts.
+ *          Each port is given by the address of a DATA aperture, e.g.
+ *          0x40025044 for PF4 and PF0, and only those pins are sampled.
+ *  @param  Addresses of the ports' DATA apertures.
+ *  @param  Number of ports, 1 to DEBOUNCE_LANES.
+ *  @param  Inputs that are active low, as bits of the packed word.
+ *  @param  Sampling period in clock cycles. A change is accepted after
+ *          DEBOUNCE_SAMPLES periods, so 2 ms suits switches.
+ *  @return NULL
+ */
+void Debounce_Start(const unsigned long *ports, unsigned long lanes, unsigned long invert, unsigned long period);
+
+/** @fn     Debounce_State(void)
+ *  @brief  Reads the debounced inputs sampled by Debounce_Start().
+ *  @param  NULL
+ *  @return Debounced inputs, 1 = active.
+ */
+unsigned long Debounce_State(void);
+
+/** @fn     Debounce_Pressed(void)
+ *  @brief  Reads and clears the inputs that became active since the last
+ *          call, so a press is seen even if it ended before the call.
+ *  @param  NULL
+ *  @return Inputs that were pressed.
+ */
+unsigned long Debounce_Pressed(void);
+
+/** @fn     Debounce_Released(void)
+ *  @brief  Reads and clears the inputs that became inactive since the last
+ *          call.
+ *  @param  NULL
+ *  @return Inputs that were released.
+ */
+unsigned long Debounce_Released(void);
+
+/** @fn     Timer0A_Handler(void)
+ *  @brief  Timer 0A interrupt handler. Samples the ports and steps the
+ *          debouncer.
+ *  @return NULL
+ */
+void Timer0A_Handler(void);
+
+#endif
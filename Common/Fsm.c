@@ -0,0 +1,45 @@
+#include "Fsm.h"
+
+unsigned long Fsm_Next(const FsmState *states, const FsmArc *arcs,
+                       unsigned long s, unsigned long input) {
+    const FsmState *st = &states[s];
+    const FsmArc *a = &arcs[st->First];
+    const FsmArc *end = a + st->Count;
+    for (; a < end; a++) {
+        if ((input & a->Mask) == a->Value) {
+            return a->Next;
+        }
+    }
+    return st->Default;
+}
+
+int Fsm_Check(const FsmState *states, unsigned long count, const FsmArc *arcs, unsigned long arcCount) {
+    unsigned long s, i;
+    for (s = 0; s < count; s++) {
+        if (states[s].Default >= count || states[s].First + states[s].Count > arcCount) {
+            return 0;
+        }
+        for (i = states[s].First; i < states[s].First + states[s].Count; i++) {
+            if (arcs[i].Next >= count || (arcs[i].Value & ~arcs[i].Mask)) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+int Fsm_CheckIndex(const FsmState *states, const FsmArc *arcs, unsigned long count,
+                   const unsigned char *next, unsigned long inputs) {
+    unsigned long s, in;
+    if (count > 256 || inputs > FSM_INDEX_INPUTS) {
+        return 0;
+    }
+    for (s = 0; s < count; s++) {
+        for (in = 0; in < (1UL << inputs); in++) {
+            if (FSM_INDEXED(next, inputs, s, in) != Fsm_Next(states, arcs, s, in)) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
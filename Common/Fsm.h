@@ -0,0 +1,107 @@
+/** @file   Fsm.h
+ *  @brief  Moore state machines with compressed transition tables, for
+ *          controllers with many inputs. A full table needs a next state
+ *          for each of the 2^N values of N inputs, 256 for 8 sensors, in
+ *          every state. Here a state has a default next state and a short
+ *          list of arcs, each matching some of the inputs: an arc is taken
+ *          when the inputs under its mask equal its value, the first one
+ *          that matches wins, and the default is taken when none does.
+ *          The table grows with the transitions a state really has, and a
+ *          step looks at no more arcs than the state has, at most
+ *          FSM_MAX_ARCS.
+ *
+ *          States and arcs are const, so they stay in flash. A state takes
+ *          8 bytes and an arc 6, for up to 65536 states and 16 inputs.
+ *
+ *          Example, the traffic light's goNorth, which waits for a car on
+ *          the east road (input bit 0) whatever the north road does:
+ *              const FsmState FSM[] = {
+ *                  {3000, 0x21, 1, goN, 0},    // Time, Out, Count, Default, First
+ *                  ...
+ *              };
+ *              const FsmArc Arcs[] = {
+ *                  {0x01, 0x01, waitN},        // Mask, Value, Next
+ *                  ...
+ *              };
+ *              S = Fsm_Next(FSM, Arcs, S, Input);
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef FSM_H
+#define FSM_H
+
+#define FSM_MAX_ARCS            255 // arcs a state can have
+
+typedef struct {
+    unsigned short Time;            // how long the state holds, in the caller's units
+    unsigned char Out;              // outputs while in the state
+    unsigned char Count;            // number of arcs
+    unsigned short Default;         // next state when no arc matches
+    unsigned short First;           // index of the first arc in the arc table
+} FsmState;
+
+typedef struct {
+    unsigned short Mask;            // inputs the arc looks at
+    unsigned short Value;           // what they must be
+    unsigned short Next;            // state it goes to
+} FsmArc;
+
+/** @fn     Fsm_Next(const FsmState *, const FsmArc *, unsigned long, unsigned long)
+ *  @brief  One transition.
+ *  @param  States.
+ *  @param  Arcs of all states.
+ *  @param  Current state.
+ *  @param  Inputs, one per bit.
+ *  @return Next state.
+ */
+unsigned long Fsm_Next(const FsmState *states, const FsmArc *arcs,
+                       unsigned long s, unsigned long input);
+
+/** @fn     Fsm_Check(const FsmState *, unsigned long, const FsmArc *, unsigned long)
+ *  @brief  Checks that every state and arc points at a state of the table,
+ *          and every state's arcs lie in the arc table, e.g. for tables
+ *          made by a tool.
+ *  @param  States.
+ *  @param  Number of states.
+ *  @param  Arcs.
+ *  @param  Number of arcs.
+ *  @return 1 if the tables hold together, otherwise 0.
+ */
+int Fsm_Check(const FsmState *states, unsigned long count, const FsmArc *arcs, unsigned long arcCount);
+
+/* A machine of up to FSM_INDEX_INPUTS inputs can also keep its next
+   states indexed, as the packed tables did before the arcs: a byte for
+   each state and input, next[(s << inputs) | input], in flash, for up to
+   256 states. A step is then one load, where Fsm_Next() takes a branch
+   for each arc. The arcs still describe the machine, for Fsm_Next() and
+   the modules built on it, and Fsm_CheckIndex() holds the index to them. */
+#define FSM_INDEX_INPUTS        4
+#define FSM_INDEXED(next, inputs, s, input)     ((next)[((s) << (inputs)) | (input)])
+
+/** @fn     Fsm_CheckIndex(const FsmState *, const FsmArc *, unsigned long, const unsigned char *, unsigned long)
+ *  @brief  Checks that an index gives the next state Fsm_Next() does, for
+ *          every state and input.
+ *  @param  States.
+ *  @param  Arcs.
+ *  @param  Number of states, at most 256.
+ *  @param  Index, next[(s << inputs) | input].
+ *  @param  Number of inputs, at most FSM_INDEX_INPUTS.
+ *  @return 1 if they agree, otherwise 0.
+ */
+int Fsm_CheckIndex(const FsmState *states, const FsmArc *arcs, unsigned long count,
+                   const unsigned char *next, unsigned long inputs);
+
+/* A controller that steps a machine by other rules than its table's times,
+   such as Coord.h, Actuated.h and Preempt.h. The caller shows S, waits the
+   ticks Step() returned, or until an interrupt handler makes *Event non-zero
+   when Event is not 0, then calls Step() with the inputs and the ticks it
+   waited. Each controller keeps this first in its own structure, where its
+   Step() finds its tables. */
+typedef struct FsmControl {
+    unsigned long (*Step)(struct FsmControl *c, unsigned long input, unsigned long ticks);
+    unsigned long S;                // current state
+    volatile unsigned long *Event;  // 0, or a word that asks for a step at the next tick
+} FsmControl;
+
+#endif
@@ -0,0 +1,6 @@
+#include "Gpio.h"
+
+void Gpio_Clocks(unsigned long ports) {
+    SYSCTL_RCGC2_R |= ports;            // every port at once
+    (void)SYSCTL_RCGC2_R;               // allow time for the clocks to start
+}
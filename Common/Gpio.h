@@ -0,0 +1,96 @@
+/** @file   Gpio.h
+ *  @brief  GPIO port setup worked out at compile time. GPIO_CONFIG() takes
+ *          what each pin of a port is for and expands to one store per
+ *          register that must leave its reset value, and nothing else: no
+ *          read-modify-writes, no writes of 0. It refuses to compile a port
+ *          that cannot work: a pin that is both input and output, pulled
+ *          both up and down, analog and digital, an alternate function
+ *          without a PCTL value, a pin the port does not have, or the JTAG
+ *          pins PC3-0. Locked pins (PD7, PF0) are unlocked automatically.
+ *
+ *          Gpio_Clocks() starts the clocks of all the ports a program uses
+ *          with a single RCGC2 write. Configure the ports after it, at
+ *          startup: registers GPIO_CONFIG() skips are assumed to be at reset.
+ *
+ *          Example, PF4 and PF0 switches with pull-ups and the LED on PF3-1:
+ *              Gpio_Clocks(SYSCTL_RCGC2_GPIOF);
+ *              GPIO_CONFIG(F, 0x11, 0x0E, 0x11, 0, 0, 0, 0);
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef GPIO_H
+#define GPIO_H
+
+#include "Pin.h"
+
+/* Pins each port has, pins that are locked after reset, and pins that
+   must not be touched (JTAG) */
+#define GPIO_PINS_A             0xFF
+#define GPIO_PINS_B             0xFF
+#define GPIO_PINS_C             0xFF
+#define GPIO_PINS_D             0xFF
+#define GPIO_PINS_E             0x3F
+#define GPIO_PINS_F             0x1F
+#define GPIO_LOCKED_A           0x00
+#define GPIO_LOCKED_B           0x00
+#define GPIO_LOCKED_C           0x0F
+#define GPIO_LOCKED_D           0x80
+#define GPIO_LOCKED_E           0x00
+#define GPIO_LOCKED_F           0x01
+#define GPIO_JTAG_A             0x00
+#define GPIO_JTAG_B             0x00
+#define GPIO_JTAG_C             0x0F
+#define GPIO_JTAG_D             0x00
+#define GPIO_JTAG_E             0x00
+#define GPIO_JTAG_F             0x00
+
+/* Pins whose PCTL field is not 0 */
+#define GPIO_PCTL_PINS(pctl)    ((((pctl) & 0x0000000FUL) ? 0x01 : 0) | (((pctl) & 0x000000F0UL) ? 0x02 : 0) | \
+                                 (((pctl) & 0x00000F00UL) ? 0x04 : 0) | (((pctl) & 0x0000F000UL) ? 0x08 : 0) | \
+                                 (((pctl) & 0x000F0000UL) ? 0x10 : 0) | (((pctl) & 0x00F00000UL) ? 0x20 : 0) | \
+                                 (((pctl) & 0x0F000000UL) ? 0x40 : 0) | (((pctl) & 0xF0000000UL) ? 0x80 : 0))
+
+/* 0, or a compile error if the pin assignment of port x is impossible */
+#define GPIO_CHECK(x, in, out, pullup, pulldown, alt, pctl, analog) ( \
+    PIN_CHECK((((in) | (out) | (pullup) | (pulldown) | (alt) | (analog)) & ~GPIO_PINS_##x) == 0) + \
+    PIN_CHECK((((in) | (out) | (pullup) | (pulldown) | (alt) | (analog)) & GPIO_JTAG_##x) == 0) + \
+    PIN_CHECK(((in) & (out)) == 0) + \
+    PIN_CHECK(((alt) & ((in) | (out))) == 0) + \
+    PIN_CHECK(((analog) & ((in) | (out))) == 0) + \
+    PIN_CHECK(((pullup) & (pulldown)) == 0) + \
+    PIN_CHECK((((pullup) | (pulldown)) & ~((in) | (alt))) == 0) + \
+    PIN_CHECK((GPIO_PCTL_PINS(pctl) & ~(alt)) == 0) + \
+    PIN_CHECK(((alt) & ~(analog) & ~GPIO_PCTL_PINS(pctl)) == 0))
+
+/* Writes a register of port x, unless the value is its reset value 0 */
+#define GPIO_SET(x, reg, v)     if (v) HWREG(GPIO_PORT##x##_BASE + GPIO_O_##reg) = (v)
+
+/* Configures port x (A to F). Each argument is a set of pins: digital
+   inputs, digital outputs, pull-ups, pull-downs, alternate functions with
+   their PCTL value, and analog pins (which may also be alternate
+   functions, as for the ADC). Pins not mentioned stay off. */
+#define GPIO_CONFIG(x, in, out, pullup, pulldown, alt, pctl, analog) do { \
+    (void)GPIO_CHECK(x, in, out, pullup, pulldown, alt, pctl, analog); \
+    if (((in) | (out) | (pullup) | (pulldown) | (alt) | (analog)) & GPIO_LOCKED_##x) { \
+        HWREG(GPIO_PORT##x##_BASE + GPIO_O_LOCK) = GPIO_LOCK_KEY; \
+        HWREG(GPIO_PORT##x##_BASE + GPIO_O_CR) = 0xFF; \
+    } \
+    GPIO_SET(x, AMSEL, analog); \
+    GPIO_SET(x, PCTL, pctl); \
+    GPIO_SET(x, DIR, out); \
+    GPIO_SET(x, AFSEL, alt); \
+    GPIO_SET(x, PUR, pullup); \
+    GPIO_SET(x, PDR, pulldown); \
+    GPIO_SET(x, DEN, ((in) | (out) | (alt)) & ~(analog)); \
+} while (0)
+
+/** @fn     Gpio_Clocks(unsigned long)
+ *  @brief  Starts the clocks of GPIO ports with one RCGC2 write and waits
+ *          until they can be configured.
+ *  @param  SYSCTL_RCGC2_GPIOx bits of every port the program uses.
+ *  @return NULL
+ */
+void Gpio_Clocks(unsigned long ports);
+
+#endif
@@ -0,0 +1,893 @@
+/** @file   HostMMIO.c
+ *  @brief  Host backend for tm4c123.h. Keeps the state of the emulated
+ *          peripherals and a virtual clock in core cycles and picoseconds.
+ *
+ *          A register access hands out a slot holding the register's value.
+ *          Stores into the slot are committed at the start of the next call
+ *          into the emulator, which always happens before the next register
+ *          access, so read-modify-write expressions like DATA |= 0x08 and
+ *          the bit-specific DATA apertures behave as they do on the chip.
+ *          Interrupt handlers get their own set of slots.
+ *
+ *          The cycle model is deliberately simple: every register access
+ *          costs LOAD_CYCLES, a store adds STORE_CYCLES, and taking an
+ *          interrupt costs IRQ_CYCLES on entry and on exit. Plain C code is
+ *          free unless it is annotated with CPU_CYCLES().
+ *
+ *          Handlers do not nest. When several interrupts are pending,
+ *          SysTick is taken first, then the others in IRQ order, and
+ *          PendSV last. PendSV_Handler() may switch to another thread's
+ *          host stack and return there, so its entry, exit and context
+ *          switch are all charged before it is called, and it must not
+ *          touch registers.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "HostMMIO.h"
+
+#define NEVER           0xFFFFFFFFFFFFFFFFULL
+#define PIOSC_HZ        16000000UL
+#define LOAD_CYCLES     2           // any register access
+#define STORE_CYCLES    1           // extra when the access stored a value
+#define IRQ_CYCLES      12          // exception entry, and again on return
+#define SWITCH_CYCLES   22          // PendSV saving and restoring r4-r11, lr and PSP
+#define PLL_LOCK_PS     500000000ULL    // 0.5 ms for the PLL to lock
+#define SLOTS           8           // register accesses in flight per context
+#define DEPTHS          4           // thread mode plus nested handlers
+#define POLL_READS      16          // identical reads in a row taken as polling
+
+typedef struct {
+    unsigned long addr;
+    unsigned long loaded;
+    volatile unsigned long value;
+} Slot;
+
+typedef struct {
+    unsigned long base;
+    unsigned long data, dir, afsel, pur, pdr, den, cr, amsel, pctl;
+    unsigned long is, ibe, iev, im, ris;
+    unsigned long unlocked;
+    unsigned long drive;        // pins driven from outside the chip
+    unsigned long level;        // level of the driven pins
+    unsigned long changes;      // number of changes of the output pins
+} Port;
+
+typedef struct {
+    unsigned long long ps;
+    int port;
+    unsigned long mask;
+    unsigned long level;
+} Event;
+
+typedef struct {
+    unsigned long addr;
+    unsigned long value;
+} Plain;
+
+/* Interrupt handlers the firmware may define */
+extern void SysTick_Handler(void) __attribute__((weak));
+extern void GPIOPortA_Handler(void) __attribute__((weak));
+extern void GPIOPortB_Handler(void) __attribute__((weak));
+extern void GPIOPortC_Handler(void) __attribute__((weak));
+extern void GPIOPortD_Handler(void) __attribute__((weak));
+extern void GPIOPortE_Handler(void) __attribute__((weak));
+extern void GPIOPortF_Handler(void) __attribute__((weak));
+extern void Timer0A_Handler(void) __attribute__((weak));
+extern void PendSV_Handler(void) __attribute__((weak));
+
+static int Ready;
+static Slot Slots[DEPTHS][SLOTS];
+static unsigned long Used[DEPTHS];
+static int Depth;
+
+/* Ports A-F, in the order of their RCGC2 bits */
+static Port Ports[6] = {
+    {0x40004000}, {0x40005000}, {0x40006000},
+    {0x40007000}, {0x40024000}, {0x40025000}
+};
+static unsigned long Warned;
+
+/* NVIC interrupt numbers of the ports and of timer 0A */
+static const unsigned long PortIrqs[6] = {0, 1, 2, 3, 4, 30};
+#define TIMER0A_IRQ     19
+static unsigned long Enabled;           // EN0
+
+static unsigned long Rcgc2;
+static unsigned long Rcc = 0x078E3AD1;      // reset values
+static unsigned long Rcc2 = 0x07C06810;
+static unsigned long Ris;
+static int PllOn;
+static unsigned long long LockAt = NEVER;
+static unsigned long long LockedPs = NEVER, PllPs = NEVER, OutputPs = NEVER;   // boot milestones
+static unsigned long Clock = PIOSC_HZ;
+static unsigned long long PsPerCycle = 1000000000000ULL / PIOSC_HZ;
+
+static unsigned long StCtrl, StReload, StCurrent;
+static int StFlag, StPending;
+static int SvPending;                   // PendSV
+static unsigned long Demcr, DwtCtrl;
+static unsigned long long CycZero;      // Cycles when CYCCNT was 0, while it counts
+static unsigned long CycHeld;           // CYCCNT while it is stopped
+
+/* Timer 0A as a 32-bit one-shot or periodic down-counter */
+static unsigned long TmCtl, TmMode, TmLoad, TmValue, TmImr, TmRis;
+
+static Plain Plains[64];
+static int NumPlains;
+
+static int Primask, Asleep;
+static unsigned long PollAddr, PollValue;
+static int Polls;                       // identical reads in a row
+static unsigned long long Cycles, Picos, SleepCycles, Accesses;
+static unsigned long long LimitPs;
+static Event *Events;
+static size_t NumEvents, NextEvent;
+static FILE *Trace;
+
+static void consume(unsigned long long cycles);
+static unsigned long *plain(unsigned long addr);
+
+/* Clock tree */
+
+static unsigned long xtal_hz(void) {
+    static const unsigned long Xtal[] = {
+        4000000, 4096000, 4915200, 5000000, 5120000, 6000000, 6144000,
+        7372800, 8000000, 8192000, 10000000, 12000000, 12288000, 13560000,
+        14318180, 16000000, 16384000, 18000000, 20000000, 24000000, 25000000
+    };
+    unsigned long field = (Rcc >> 6) & 0x1F;
+    return (field >= 0x06 && field <= 0x1A) ? Xtal[field - 0x06] : 16000000;
+}
+
+static unsigned long osc_hz(unsigned long src) {
+    switch (src) {
+    case 0:  return xtal_hz();
+    case 1:  return PIOSC_HZ;
+    case 2:  return PIOSC_HZ / 4;
+    case 3:  return 30000;
+    default: return 32768;
+    }
+}
+
+/* Works out the system clock from RCC/RCC2 and starts the PLL lock timer */
+static void sysctl_changed(void) {
+    int rcc2 = (Rcc2 & 0x80000000) != 0;
+    unsigned long bypass = rcc2 ? Rcc2 & 0x00000800 : Rcc & 0x00000800;
+    unsigned long pwrdn = rcc2 ? Rcc2 & 0x00002000 : Rcc & 0x00002000;
+    unsigned long src = rcc2 ? (Rcc2 >> 4) & 7 : (Rcc >> 4) & 3;
+    unsigned long div = rcc2 ? (Rcc2 >> 23) & 0x3F : (Rcc >> 23) & 0xF;
+    unsigned long hz;
+
+    if (pwrdn) {
+        PllOn = 0;
+        LockAt = NEVER;
+        Ris &= ~0x40UL;
+    } else if (!PllOn) {
+        PllOn = 1;
+        LockAt = Picos + PLL_LOCK_PS;
+    }
+
+    if (!bypass && !pwrdn) {
+        if (!(Ris & 0x40) && !(Warned & 0x100)) {
+            Warned |= 0x100;
+            fprintf(stderr, "[mmio] warning: PLL selected before it locked\n");
+        }
+        if (PllPs == NEVER) {
+            PllPs = Picos;
+        }
+        if (rcc2 && (Rcc2 & 0x40000000)) {
+            hz = 400000000UL / (((div << 1) | ((Rcc2 >> 22) & 1)) + 1);
+        } else {
+            hz = 200000000UL / (div + 1);
+        }
+    } else {
+        hz = osc_hz(src);
+        if (Rcc & 0x00400000) {     // USESYSDIV
+            hz /= div + 1;
+        }
+    }
+    Clock = hz;
+    PsPerCycle = (1000000000000ULL + hz / 2) / hz;
+}
+
+/* SysTick */
+
+/* Ticks until the counter next reaches zero */
+static unsigned long long st_next(void) {
+    if (!(StCtrl & 1)) {
+        return NEVER;
+    }
+    if (StCurrent) {
+        return StCurrent;
+    }
+    return StReload ? StReload + 1ULL : NEVER;
+}
+
+static void st_tick(unsigned long long n) {
+    if (!(StCtrl & 1)) {
+        return;
+    }
+    while (n) {
+        if (StCurrent == 0) {           // reload on the clock after zero
+            if (StReload == 0) {
+                return;
+            }
+            StCurrent = StReload;
+            n--;
+            continue;
+        }
+        if (n < StCurrent) {
+            StCurrent -= n;
+            return;
+        }
+        n -= StCurrent;
+        StCurrent = 0;
+        StFlag = 1;
+        if (StCtrl & 2) {
+            StPending = 1;
+        }
+        n %= StReload + 1ULL;           // whole periods change nothing else
+    }
+}
+
+/* Timer 0A */
+
+/* Cycles until the counter next times out */
+static unsigned long long tm_next(void) {
+    return (TmCtl & 1) ? TmValue + 1ULL : NEVER;
+}
+
+/* Counts TAILR down to 0 and times out on the clock after it */
+static void tm_tick(unsigned long long n) {
+    if (!(TmCtl & 1)) {
+        return;
+    }
+    if (n <= TmValue) {
+        TmValue -= (unsigned long)n;
+        return;
+    }
+    n -= TmValue + 1ULL;
+    TmRis |= 1;                         // TATORIS
+    if ((TmMode & 3) == 1) {
+        TmCtl &= ~1UL;                  // one-shot: stops
+        TmValue = TmLoad;
+        return;
+    }
+    TmValue = TmLoad - (unsigned long)(n % (TmLoad + 1ULL));
+}
+
+static unsigned long tm_read(unsigned long addr) {
+    switch (addr & 0xFFF) {
+    case 0x004: return TmMode;
+    case 0x00C: return TmCtl;
+    case 0x018: return TmImr;
+    case 0x01C: return TmRis;
+    case 0x020: return TmRis & TmImr;
+    case 0x028: return TmLoad;
+    case 0x048:
+    case 0x050: return TmValue;
+    default:    return *plain(addr);
+    }
+}
+
+static void tm_write(unsigned long addr, unsigned long v) {
+    switch (addr & 0xFFF) {
+    case 0x004: TmMode = v & 0xFFF; break;
+    case 0x00C:
+        if ((v & 1) && !(TmCtl & 1)) {
+            TmValue = TmLoad;           // starts from the load value
+        }
+        TmCtl = v;
+        break;
+    case 0x018: TmImr = v; break;
+    case 0x024: TmRis &= ~v; break;     // write 1 to clear
+    case 0x028: TmLoad = TmValue = v; break;
+    default:    *plain(addr) = v; break;
+    }
+}
+
+/* GPIO */
+
+static unsigned long pins(Port *p) {
+    unsigned long in = (p->drive & p->level) | (~p->drive & p->pur);
+    return ((p->data & p->dir) | (in & ~p->dir)) & p->den & 0xFF;
+}
+
+static unsigned long outputs(Port *p) {
+    return p->data & p->dir & p->den & 0xFF;
+}
+
+static void output_changed(Port *p, unsigned long before) {
+    unsigned long after = outputs(p);
+    if (after != before) {
+        p->changes++;
+        if (OutputPs == NEVER) {
+            OutputPs = Picos;
+        }
+        if (Trace) {
+            fprintf(Trace, "%llu %llu P%c %02lX\n", Picos / 1000, Cycles,
+                    (char)('A' + (p - Ports)), after);
+        }
+    }
+}
+
+/* Latches the edges the port is set to detect between two pin levels */
+static void edges(Port *p, unsigned long before) {
+    unsigned long after = pins(p);
+    unsigned long changed = before ^ after;
+    unsigned long rising = changed & after, falling = changed & before;
+    unsigned long hit = (changed & p->ibe) |
+                        (~p->ibe & ((rising & p->iev) | (falling & ~p->iev)));
+    p->ris |= hit & ~p->is;
+}
+
+/* Raw status: latched edges, plus level-sensitive pins at their level */
+static unsigned long raw(Port *p) {
+    return (p->ris | (p->is & ~(pins(p) ^ p->iev))) & 0xFF;
+}
+
+/* Lowest-numbered interrupt that is enabled and asserted, or -1 */
+static int irq_pending(void) {
+    unsigned long asserted = 0;
+    int i;
+    for (i = 0; i < 6; i++) {
+        if (raw(&Ports[i]) & Ports[i].im) {
+            asserted |= 1UL << PortIrqs[i];
+        }
+    }
+    if (TmRis & TmImr & 1) {
+        asserted |= 1UL << TIMER0A_IRQ;
+    }
+    asserted &= Enabled;
+    for (i = 0; i < 32; i++) {
+        if (asserted & (1UL << i)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* Bits of AFSEL, PUR, PDR and DEN only change where CR allows it */
+static unsigned long commit(Port *p, unsigned long old, unsigned long v) {
+    return ((old & ~p->cr) | (v & p->cr)) & 0xFF;
+}
+
+static Port *port_of(unsigned long addr) {
+    int i;
+    for (i = 0; i < 6; i++) {
+        if ((addr & ~0xFFFUL) == Ports[i].base) {
+            if (!(Rcgc2 & (1UL << i)) && !(Warned & (1UL << i))) {
+                Warned |= 1UL << i;
+                fprintf(stderr, "[mmio] warning: port %c accessed with its "
+                        "clock gated\n", 'A' + i);
+            }
+            return &Ports[i];
+        }
+    }
+    return 0;
+}
+
+/* Everything else is plain memory */
+static unsigned long *plain(unsigned long addr) {
+    int i;
+    for (i = 0; i < NumPlains; i++) {
+        if (Plains[i].addr == addr) {
+            return &Plains[i].value;
+        }
+    }
+    if (NumPlains == (int)(sizeof(Plains) / sizeof(Plains[0]))) {
+        fprintf(stderr, "[mmio] too many registers in use\n");
+        exit(1);
+    }
+    Plains[NumPlains].addr = addr;
+    return &Plains[NumPlains++].value;
+}
+
+static unsigned long port_read(Port *p, unsigned long off, unsigned long addr) {
+    if (off < 0x400) {
+        return pins(p) & (off >> 2);
+    }
+    switch (off) {
+    case 0x400: return p->dir;
+    case 0x404: return p->is;
+    case 0x408: return p->ibe;
+    case 0x40C: return p->iev;
+    case 0x410: return p->im;
+    case 0x414: return raw(p);
+    case 0x418: return raw(p) & p->im;
+    case 0x41C: return 0;
+    case 0x420: return p->afsel;
+    case 0x510: return p->pur;
+    case 0x514: return p->pdr;
+    case 0x51C: return p->den;
+    case 0x520: return !p->unlocked;
+    case 0x524: return p->cr;
+    case 0x528: return p->amsel;
+    case 0x52C: return p->pctl;
+    default:    return *plain(addr);
+    }
+}
+
+static void port_write(Port *p, unsigned long off, unsigned long addr,
+                       unsigned long v) {
+    unsigned long before = outputs(p), level = pins(p);
+    if (off < 0x400) {
+        unsigned long mask = off >> 2;
+        p->data = (p->data & ~mask) | (v & mask);
+        output_changed(p, before);
+        edges(p, level);
+        return;
+    }
+    switch (off) {
+    case 0x400: p->dir = v & 0xFF; output_changed(p, before); break;
+    case 0x404: p->is = v & 0xFF; break;
+    case 0x408: p->ibe = v & 0xFF; break;
+    case 0x40C: p->iev = v & 0xFF; break;
+    case 0x410: p->im = v & 0xFF; break;
+    case 0x414: break;                  // read-only
+    case 0x418: break;
+    case 0x41C: p->ris &= ~v; break;    // write 1 to clear
+    case 0x420: p->afsel = commit(p, p->afsel, v); break;
+    case 0x510: p->pur = commit(p, p->pur, v); p->pdr &= ~p->pur; break;
+    case 0x514: p->pdr = commit(p, p->pdr, v); p->pur &= ~p->pdr; break;
+    case 0x51C: p->den = commit(p, p->den, v); output_changed(p, before); break;
+    case 0x520: p->unlocked = (v == 0x4C4F434B); break;
+    case 0x524: if (p->unlocked) { p->cr = v & 0xFF; } break;
+    case 0x528: p->amsel = v & 0xFF; break;
+    case 0x52C: p->pctl = v; break;
+    default:    *plain(addr) = v; break;
+    }
+    edges(p, level);
+}
+
+/* Register map */
+
+static void reg_write(unsigned long addr, unsigned long v);
+
+/* DWT CYCCNT counts core cycles while TRCENA and CYCCNTENA are both set */
+static int cyc_counting(void) {
+    return (Demcr & 0x01000000) && (DwtCtrl & 1);
+}
+
+static unsigned long cyc_read(void) {
+    return cyc_counting() ? (unsigned long)((Cycles - CycZero) & 0xFFFFFFFFUL) : CycHeld;
+}
+
+static void cyc_set(unsigned long demcr, unsigned long ctrl, unsigned long count) {
+    Demcr = demcr;
+    DwtCtrl = ctrl;
+    CycHeld = count;
+    CycZero = Cycles - count;
+}
+
+/* Register and bit behind a word of the peripheral bit-band alias */
+static int bitband(unsigned long addr, unsigned long *reg, unsigned long *bit) {
+    if (addr < 0x42000000 || addr >= 0x44000000) {
+        return 0;
+    }
+    *reg = 0x40000000 + (((addr - 0x42000000) >> 5) & ~3UL);
+    *bit = ((addr - 0x42000000) >> 2) & 31;
+    return 1;
+}
+
+static unsigned long reg_read(unsigned long addr) {
+    Port *p = port_of(addr);
+    unsigned long v, reg, bit;
+    if (bitband(addr, &reg, &bit)) {
+        return (reg_read(reg) >> bit) & 1;
+    }
+    if (p) {
+        return (Rcgc2 & (1UL << (p - Ports))) ? port_read(p, addr & 0xFFF, addr) : 0;
+    }
+    if ((addr & ~0xFFFUL) == 0x40030000) {
+        return tm_read(addr);
+    }
+    switch (addr) {
+    case 0x400FE050: return Ris;
+    case 0x400FE058: return 0;          // MISC: no interrupts unmasked
+    case 0x400FE060: return Rcc;
+    case 0x400FE070: return Rcc2;
+    case 0x400FE108: return Rcgc2;
+    case 0xE000E010:
+        v = StCtrl | (StFlag ? 0x00010000 : 0);
+        StFlag = 0;                     // COUNT clears when read
+        return v;
+    case 0xE000E014: return StReload;
+    case 0xE000E018: return StCurrent;
+    case 0xE000E100: return Enabled;
+    case 0xE000E180: return Enabled;
+    case 0xE000ED04: return (StPending ? 0x04000000 : 0) | (SvPending ? 0x10000000 : 0);
+    case 0xE000EDFC: return Demcr;
+    case 0xE0001000: return DwtCtrl;
+    case 0xE0001004: return cyc_read();
+    default:         return *plain(addr);
+    }
+}
+
+static void reg_write(unsigned long addr, unsigned long v) {
+    Port *p = port_of(addr);
+    unsigned long reg, bit;
+    if (bitband(addr, &reg, &bit)) {
+        // the bus reads, changes and writes the word in one go
+        reg_write(reg, (reg_read(reg) & ~(1UL << bit)) | ((v & 1) << bit));
+        return;
+    }
+    if (p) {
+        if (Rcgc2 & (1UL << (p - Ports))) {
+            port_write(p, addr & 0xFFF, addr, v);
+        }
+        return;
+    }
+    if ((addr & ~0xFFFUL) == 0x40030000) {
+        tm_write(addr, v);
+        return;
+    }
+    switch (addr) {
+    case 0x400FE050: break;             // read-only
+    case 0x400FE058: Ris &= ~v; break;  // MISC: write 1 to clear
+    case 0x400FE060: Rcc = v; sysctl_changed(); break;
+    case 0x400FE070: Rcc2 = v; sysctl_changed(); break;
+    case 0x400FE108: Rcgc2 = v; break;
+    case 0xE000E010: StCtrl = v & 7; break;
+    case 0xE000E014: StReload = v & 0x00FFFFFF; break;
+    case 0xE000E018: StCurrent = 0; StFlag = 0; break;
+    case 0xE000E100: Enabled |= v; break;      // write 1 to enable
+    case 0xE000E180: Enabled &= ~v; break;     // write 1 to disable
+    case 0xE000ED04:
+        if (v & 0x04000000) {
+            StPending = 1;
+        }
+        if (v & 0x02000000) {
+            StPending = 0;
+        }
+        if (v & 0x10000000) {
+            SvPending = 1;
+        }
+        if (v & 0x08000000) {
+            SvPending = 0;
+        }
+        break;
+    case 0xE000EDFC: cyc_set(v, DwtCtrl, cyc_read()); break;
+    case 0xE0001000: cyc_set(Demcr, v, cyc_read()); break;
+    case 0xE0001004: cyc_set(Demcr, DwtCtrl, v); break;
+    default:         *plain(addr) = v; break;
+    }
+}
+
+/* Virtual time */
+
+static void report(void) {
+    int i;
+    fprintf(stderr, "[mmio] %.6f s virtual, %llu cycles, %lu Hz system clock, "
+            "%.1f%% asleep\n", Picos / 1e12, Cycles, Clock,
+            Cycles ? 100.0 * SleepCycles / Cycles : 0.0);
+    fprintf(stderr, "[mmio] %llu register accesses, output changes:", Accesses);
+    for (i = 0; i < 6; i++) {
+        if (Ports[i].changes) {
+            fprintf(stderr, " P%c %lu", 'A' + i, Ports[i].changes);
+        }
+    }
+    fprintf(stderr, "\n");
+    if (OutputPs != NEVER || LockedPs != NEVER) {
+        fprintf(stderr, "[mmio] boot:");
+        if (LockedPs != NEVER) {
+            fprintf(stderr, " PLL locked at %.3f us,", LockedPs / 1e6);
+        }
+        if (PllPs != NEVER) {
+            fprintf(stderr, " running from it at %.3f us,", PllPs / 1e6);
+        }
+        fprintf(stderr, OutputPs != NEVER ? " first output at %.3f us\n" : " no output\n",
+                OutputPs / 1e6);
+    }
+    if (Trace) {
+        fclose(Trace);
+        Trace = 0;
+    }
+}
+
+static void tick(unsigned long long n) {
+    Cycles += n;
+    Picos += n * PsPerCycle;
+    if (Asleep) {
+        SleepCycles += n;
+    }
+    st_tick(n);
+    tm_tick(n);
+    if (Picos >= LockAt) {
+        LockAt = NEVER;
+        Ris |= 0x40;
+        if (LockedPs == NEVER) {
+            LockedPs = Picos;
+        }
+        sysctl_changed();
+    }
+    while (NextEvent < NumEvents && Events[NextEvent].ps <= Picos) {
+        Event *e = &Events[NextEvent++];
+        Port *p = &Ports[e->port];
+        unsigned long level = pins(p);
+        p->drive |= e->mask;
+        p->level = (p->level & ~e->mask) | e->level;
+        edges(p, level);
+    }
+    if (Picos >= LimitPs) {
+        fprintf(stderr, "[mmio] time limit of %.6f s reached\n", LimitPs / 1e12);
+        exit(MMIO_TIMEOUT);     // a program that ends by itself did not get there
+    }
+}
+
+static unsigned long long cycles_until(unsigned long long ps) {
+    if (ps == NEVER) {
+        return NEVER;
+    }
+    if (ps <= Picos) {
+        return 1;
+    }
+    return (ps - Picos + PsPerCycle - 1) / PsPerCycle;
+}
+
+/* Cycles until something happens that the firmware could notice */
+static unsigned long long next_step(void) {
+    unsigned long long step = st_next();
+    unsigned long long c = cycles_until(LockAt);
+    if (c < step) {
+        step = c;
+    }
+    c = tm_next();
+    if (c < step) {
+        step = c;
+    }
+    if (NextEvent < NumEvents) {
+        c = cycles_until(Events[NextEvent].ps);
+        if (c < step) {
+            step = c;
+        }
+    }
+    c = cycles_until(LimitPs);
+    return c < step ? c : step;
+}
+
+/* Commits the stores made through this context's slots */
+static void sync(void) {
+    int i;
+    for (i = 0; i < SLOTS; i++) {
+        Slot *s = &Slots[Depth][i];
+        if (s->value != s->loaded) {
+            s->loaded = s->value;
+            reg_write(s->addr, s->value & 0xFFFFFFFFUL);
+            tick(STORE_CYCLES);
+            Polls = 0;
+        }
+    }
+}
+
+static void enter(void (*handler)(void)) {
+    tick(IRQ_CYCLES);
+    Depth++;
+    Used[Depth] = 0;
+    if (handler) {
+        handler();
+    }
+    sync();
+    Depth--;
+    tick(IRQ_CYCLES);
+    Polls = 0;
+}
+
+static void (*handler_of(int irq))(void) {
+    switch (irq) {
+    case 0:  return GPIOPortA_Handler;
+    case 1:  return GPIOPortB_Handler;
+    case 2:  return GPIOPortC_Handler;
+    case 3:  return GPIOPortD_Handler;
+    case 4:  return GPIOPortE_Handler;
+    case 19: return Timer0A_Handler;
+    case 30: return GPIOPortF_Handler;
+    default: return 0;
+    }
+}
+
+static void dispatch(void) {
+    int irq;
+    if (Primask || Depth) {
+        return;
+    }
+    for (;;) {
+        if (StPending) {
+            StPending = 0;
+            enter(SysTick_Handler);
+        } else if ((irq = irq_pending()) >= 0) {
+            // stays pending until the handler clears its cause
+            if (!handler_of(irq)) {
+                fprintf(stderr, "[mmio] no handler for interrupt %d\n", irq);
+                exit(1);
+            }
+            enter(handler_of(irq));
+        } else if (SvPending && PendSV_Handler) {
+            SvPending = 0;
+            tick(2 * IRQ_CYCLES + SWITCH_CYCLES);
+            Polls = 0;
+            PendSV_Handler();           // may come back on another stack
+        } else {
+            return;
+        }
+    }
+}
+
+static void consume(unsigned long long cycles) {
+    while (cycles) {
+        unsigned long long step = next_step();
+        if (step > cycles) {
+            step = cycles;
+        }
+        tick(step);
+        cycles -= step;
+        dispatch();
+    }
+}
+
+static int by_time(const void *a, const void *b) {
+    const Event *x = a, *y = b;
+    return (x->ps > y->ps) - (x->ps < y->ps);
+}
+
+static void load_stimulus(const char *path) {
+    FILE *f = fopen(path, "r");
+    char line[128];
+    size_t cap = 0;
+    if (!f) {
+        fprintf(stderr, "[mmio] cannot open stimulus %s\n", path);
+        exit(1);
+    }
+    while (fgets(line, sizeof(line), f)) {
+        double ms;
+        char port;
+        int pin, level;
+        if (line[0] == '#' || sscanf(line, "%lf P%c%d=%d", &ms, &port, &pin, &level) != 4) {
+            continue;
+        }
+        if (port < 'A' || port > 'F' || pin < 0 || pin > 7) {
+            fprintf(stderr, "[mmio] bad stimulus: %s", line);
+            continue;
+        }
+        if (NumEvents == cap) {
+            cap = cap ? 2 * cap : 64;
+            Events = realloc(Events, cap * sizeof(Event));
+        }
+        Events[NumEvents].ps = (unsigned long long)(ms * 1e9);
+        Events[NumEvents].port = port - 'A';
+        Events[NumEvents].mask = 1UL << pin;
+        Events[NumEvents].level = level ? 1UL << pin : 0;
+        NumEvents++;
+    }
+    fclose(f);
+    qsort(Events, NumEvents, sizeof(Event), by_time);
+}
+
+static void init(void) {
+    const char *env;
+    int i;
+    if (Ready) {
+        return;
+    }
+    Ready = 1;
+    for (i = 0; i < 6; i++) {
+        Ports[i].cr = 0xFF;
+    }
+    Ports[2].cr = 0xF0;                 // PC3-0 (JTAG) are locked
+    Ports[3].cr = 0x7F;                 // PD7 (NMI) is locked
+    Ports[5].cr = 0xFE;                 // PF0 (NMI) is locked
+    env = getenv("MMIO_SECONDS");
+    LimitPs = (unsigned long long)((env ? atof(env) : 10.0) * 1e12);
+    env = getenv("MMIO_STIMULUS");
+    if (env) {
+        load_stimulus(env);
+    }
+    env = getenv("MMIO_TRACE");
+    if (env && !(Trace = fopen(env, "w"))) {
+        fprintf(stderr, "[mmio] cannot open trace %s\n", env);
+        exit(1);
+    }
+    atexit(report);
+}
+
+/* Interface */
+
+volatile unsigned long *Mmio_Reg(unsigned long addr) {
+    Slot *s;
+    init();
+    sync();
+    // A loop reading the same value over and over is polling: nothing it
+    // can see changes before the next event, so skip straight to it.
+    if (Polls >= POLL_READS && addr == PollAddr && !Depth) {
+        consume(next_step());
+    }
+    consume(LOAD_CYCLES);
+    Accesses++;
+    s = &Slots[Depth][Used[Depth]++ % SLOTS];
+    s->addr = addr;
+    s->loaded = s->value = reg_read(addr);
+    if (!Depth) {
+        if (addr == PollAddr && s->value == PollValue) {
+            Polls++;
+        } else {
+            PollAddr = addr;
+            PollValue = s->value;
+            Polls = 1;
+        }
+    }
+    return &s->value;
+}
+
+void Mmio_Advance(unsigned long cycles) {
+    init();
+    sync();
+    Polls = 0;
+    consume(cycles);
+}
+
+void Mmio_WaitForInterrupt(void) {
+    init();
+    sync();
+    Asleep = 1;
+    while (!StPending && !SvPending && irq_pending() < 0) {
+        tick(next_step());
+    }
+    Asleep = 0;
+    dispatch();
+}
+
+void Mmio_EnableInterrupts(void) {
+    init();
+    sync();
+    Primask = 0;
+    dispatch();
+}
+
+void Mmio_DisableInterrupts(void) {
+    init();
+    sync();
+    Primask = 1;
+}
+
+unsigned long Mmio_StartCritical(void) {
+    unsigned long was = Primask;
+    Mmio_DisableInterrupts();
+    return was;
+}
+
+void Mmio_EndCritical(unsigned long primask) {
+    if (!primask) {
+        Mmio_EnableInterrupts();
+    }
+}
+
+void Mmio_Drive(char port, unsigned long mask, unsigned long level) {
+    Port *p = &Ports[port - 'A'];
+    unsigned long before;
+    init();
+    before = pins(p);
+    p->drive |= mask;
+    p->level = (p->level & ~mask) | (level & mask);
+    edges(p, before);
+}
+
+unsigned long Mmio_Output(char port) {
+    init();
+    sync();
+    return outputs(&Ports[port - 'A']);
+}
+
+unsigned long long Mmio_Cycles(void) {
+    return Cycles;
+}
+
+unsigned long long Mmio_Nanos(void) {
+    return Picos / 1000;
+}
+
+unsigned long Mmio_SysClock(void) {
+    return Clock;
+}
@@ -0,0 +1,125 @@
+/** @file   HostMMIO.h
+ *  @brief  Host-side emulation of the TM4C123 registers used in this
+ *          repository. When a program is built with HOST_BUILD defined,
+ *          tm4c123.h routes every register access through Mmio_Reg() and
+ *          the firmware runs unmodified on Linux against a virtual clock.
+ *
+ *          Emulated: SYSCTL RCGC2/RCC/RCC2/RIS (including PLL lock and the
+ *          resulting system clock), GPIO ports A-F with the bit-specific
+ *          DATA apertures, PF0's LOCK/CR commit control and edge or level
+ *          interrupts (IS/IBE/IEV/IM/RIS/MIS/ICR, enabled in NVIC EN0 and
+ *          taken by GPIOPort<X>_Handler), SysTick with its interrupt,
+ *          PendSV through PendSV_Handler, the DWT cycle counter, and timer
+ *          0A as a 32-bit one-shot or periodic timer interrupting through
+ *          Timer0A_Handler. The peripheral bit-band alias at
+ *          0x42000000 reaches all of them bit by bit. Time only advances
+ *          when the firmware touches a register, calls CPU_CYCLES() or
+ *          sleeps in WaitForInterrupt().
+ *
+ *          The run is controlled through environment variables:
+ *          - MMIO_SECONDS   virtual seconds to run before exiting with
+ *                           MMIO_TIMEOUT (default 10)
+ *          - MMIO_STIMULUS  file of input changes, one "<ms> P<port><pin>=<0|1>"
+ *                           per line, e.g. "250 PF4=0"
+ *          - MMIO_TRACE     file receiving "<ns> <cycles> P<port> <hex>" for
+ *                           every change of a port's output pins
+ *          A summary of virtual time, cycles and sleep residency is printed
+ *          to stderr when the program exits.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef HOSTMMIO_H
+#define HOSTMMIO_H
+
+/* Exit status when MMIO_SECONDS runs out. A lab that loops forever always
+   ends this way; a check that ends by itself has not finished. */
+#define MMIO_TIMEOUT            3
+
+/** @fn     Mmio_Reg(unsigned long)
+ *  @brief  Returns a pointer through which the register at the given
+ *          address can be read and written. Stores through the pointer take
+ *          effect at the next emulator call, which happens before any other
+ *          register access. Each call costs a register access worth of cycles.
+ *  @param  Address of the register as on the TM4C123.
+ *  @return Pointer to the value of the register.
+ */
+volatile unsigned long *Mmio_Reg(unsigned long addr);
+
+/** @fn     Mmio_Advance(unsigned long)
+ *  @brief  Charges the given number of CPU cycles to the virtual clock.
+ *          Used through CPU_CYCLES() in loops that touch no registers.
+ *  @param  Number of core clock cycles.
+ *  @return NULL
+ */
+void Mmio_Advance(unsigned long cycles);
+
+/** @fn     Mmio_WaitForInterrupt(void)
+ *  @brief  Sleeps until an interrupt is pending, skipping virtual time
+ *          straight to the next event. Counted as sleep in the summary.
+ *  @return NULL
+ */
+void Mmio_WaitForInterrupt(void);
+
+/** @fn     Mmio_EnableInterrupts(void)
+ *  @brief  Clears the emulated PRIMASK and runs any pending handler.
+ *  @return NULL
+ */
+void Mmio_EnableInterrupts(void);
+
+/** @fn     Mmio_DisableInterrupts(void)
+ *  @brief  Sets the emulated PRIMASK.
+ *  @return NULL
+ */
+void Mmio_DisableInterrupts(void);
+
+/** @fn     Mmio_StartCritical(void)
+ *  @brief  Sets the emulated PRIMASK, as Mmio_DisableInterrupts() does.
+ *  @return PRIMASK as it was, for Mmio_EndCritical().
+ */
+unsigned long Mmio_StartCritical(void);
+
+/** @fn     Mmio_EndCritical(unsigned long)
+ *  @brief  Puts the emulated PRIMASK back as Mmio_StartCritical() found
+ *          it, running any pending handler if that leaves it clear.
+ *  @param  PRIMASK as Mmio_StartCritical() returned it.
+ *  @return NULL
+ */
+void Mmio_EndCritical(unsigned long primask);
+
+/** @fn     Mmio_Drive(char, unsigned long, unsigned long)
+ *  @brief  Drives input pins of a port from outside the chip, as a switch
+ *          or sensor would. Undriven pins read their pull-up/down level.
+ *  @param  Port letter ('A' to 'F').
+ *  @param  Pins being driven.
+ *  @param  Level of the driven pins.
+ *  @return NULL
+ */
+void Mmio_Drive(char port, unsigned long mask, unsigned long level);
+
+/** @fn     Mmio_Output(char)
+ *  @brief  Reads the level of the output pins of a port.
+ *  @param  Port letter ('A' to 'F').
+ *  @return Output pins of the port, other bits zero.
+ */
+unsigned long Mmio_Output(char port);
+
+/** @fn     Mmio_Cycles(void)
+ *  @brief  Core clock cycles elapsed since reset.
+ *  @return Number of cycles.
+ */
+unsigned long long Mmio_Cycles(void);
+
+/** @fn     Mmio_Nanos(void)
+ *  @brief  Virtual time elapsed since reset.
+ *  @return Time in nanoseconds.
+ */
+unsigned long long Mmio_Nanos(void);
+
+/** @fn     Mmio_SysClock(void)
+ *  @brief  Current system clock as configured through RCC/RCC2.
+ *  @return Frequency in Hz.
+ */
+unsigned long Mmio_SysClock(void);
+
+#endif
@@ -0,0 +1,371 @@
+#include "tm4c123.h"
+#include "../SysTick Timer/SysTick.h"
+#include "Kernel.h"
+
+#define NEVER           0xFFFFFFFFFFFFFFFFULL
+#define IDLE_WORDS      KERNEL_STACK(64)
+#define EXC_THREAD_PSP  0xFFFFFFFDUL    // return to thread mode on PSP, no FPU frame
+#define XPSR_THUMB      0x01000000UL
+#define EARLY_CYCLES    1024            // the shortest SysTick period
+
+/* Global, not static, for the assembly of PendSV_Handler(). PendSV saves
+   the running thread into Kernel_Current and restores Kernel_Next. */
+Thread *Kernel_Current, *Kernel_Next;
+
+static Thread *ByPriority[KERNEL_PRIORITIES + 1];
+static volatile unsigned long Ready;        // bit p: the thread of priority p is ready
+static Thread *Sleepers;                    // by wake-up time, earliest first
+static Thread Idle;
+static unsigned long IdleStack[IDLE_WORDS];
+
+/* Position of the lowest bit set in a non-zero word, as in Wheel.c */
+static const unsigned char Lowest[32] = {
+    0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+    31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+};
+static unsigned long lowest(unsigned long word) {
+    return Lowest[(((word & (0 - word)) * 0x077CB531UL) & 0xFFFFFFFFUL) >> 27];
+}
+
+/* Pends PendSV if the highest ready thread is not the running one. The
+   idle thread is always ready. Interrupts must be disabled. */
+static void schedule(void) {
+    Kernel_Next = ByPriority[lowest(Ready)];
+    if (Kernel_Next != Kernel_Current) {
+        NVIC_INT_CTRL_R = NVIC_INT_CTRL_PEND_SV;
+    }
+}
+
+static void wake(Thread *t, unsigned long long since) {
+    Ready |= t->Bit;
+#ifdef KERNEL_LATENCY
+    t->Woken = since;
+#else
+    (void)since;
+#endif
+}
+
+#ifdef KERNEL_LATENCY
+/* From being made ready to running, in log2 buckets */
+static void timed(Thread *t) {
+    unsigned long took = (unsigned long)(SysTick_Now() - t->Woken);
+    unsigned long bucket = 0;
+    while (bucket < KERNEL_BUCKETS - 1 && (took >> bucket)) {
+        bucket++;
+    }
+    t->Latency[bucket]++;
+    t->TotalLatency += took;
+    if (took > t->WorstLatency) {
+        t->WorstLatency = took;
+    }
+}
+#endif
+
+/* SysTick alarm: wakes the sleepers that are due, and arms the next.
+   SysTick cannot be armed closer than about a thousand cycles, so those
+   due sooner are woken now and wait out the rest running. */
+static unsigned long long expired(unsigned long long now) {
+    Thread *t;
+    now += EARLY_CYCLES * SysTick_Scale();
+    while (Sleepers && Sleepers->Due < now) {
+        t = Sleepers;
+        Sleepers = t->Next;
+        wake(t, t->Due);
+        t->Due = NEVER;
+    }
+    schedule();
+    return Sleepers ? Sleepers->Due : NEVER;
+}
+
+/* Where a body returns to. Once switched away from, it never runs again. */
+static void finish(void) {
+    Thread *t = Kernel_Current;
+    DisableInterrupts();
+    Ready &= ~t->Bit;
+    ByPriority[t->Priority] = 0;
+    schedule();
+    EnableInterrupts();
+    while (1) {
+        WaitForInterrupt();
+    }
+}
+
+static void idle(void) {
+    while (1) {
+        WaitForInterrupt();
+    }
+}
+
+#ifdef HOST_BUILD
+/* Threads are host contexts, each on its own stack. The emulator calls
+   PendSV_Handler() from thread mode, with nothing of the handler left to
+   run after it, so it can switch contexts right there. */
+static void start(void) {
+    Kernel_Current->Body();
+    finish();
+}
+
+static void frame(Thread *t, unsigned long *stack, unsigned long words) {
+    getcontext(&t->Context);
+    t->Context.uc_stack.ss_sp = stack;
+    t->Context.uc_stack.ss_size = words * sizeof(unsigned long);
+    t->Context.uc_link = 0;
+    makecontext(&t->Context, start, 0);
+    t->Sp = stack;
+}
+
+void PendSV_Handler(void) {
+    Thread *from = Kernel_Current;
+    Kernel_Current = Kernel_Next;
+    Kernel_Current->Switches++;
+    if (from) {
+        swapcontext(&from->Context, &Kernel_Current->Context);
+    } else {
+        setcontext(&Kernel_Current->Context);
+    }
+}
+#else
+/* The stack as PendSV leaves it: the hardware frame the exception return
+   pops, and below it r4-r11 and the EXC_RETURN value PendSV restores */
+static void frame(Thread *t, unsigned long *stack, unsigned long words) {
+    unsigned long *sp = (unsigned long *)((unsigned long)(stack + words) & ~7UL);
+    *--sp = XPSR_THUMB;
+    *--sp = (unsigned long)t->Body & ~1UL;      // PC
+    *--sp = (unsigned long)finish;              // LR
+    sp -= 5;                                    // r12, r3-r0
+    *--sp = EXC_THREAD_PSP;
+    sp -= 8;                                    // r4-r11
+    t->Sp = sp;
+}
+
+/* Saves r4-r11 and EXC_RETURN below the hardware frame on the process
+   stack, with s16-s31 above them if the thread used the FPU (bit 4 of
+   EXC_RETURN clear), then does the same in reverse for the next thread.
+   s0-s15 are the hardware's, stacked lazily. Sp is at offset 0 of a
+   Thread and Switches at 4 on the LaunchPad. Both bodies assemble for the
+   Cortex-M4 with its FPU, and differ only in how they load the two
+   addresses (see Kernel Tools/README.md); the frame above
+   restores to an 8-byte aligned PSP with EXC_RETURN bit 4 set, so the
+   first switch to a thread skips s16-s31. Not yet run on the target. */
+#if defined(__CC_ARM)
+__asm void PendSV_Handler(void) {
+    PRESERVE8
+    THUMB
+    MRS     r0, PSP
+    LDR     r2, =__cpp(&Kernel_Current)
+    LDR     r1, [r2]
+    CBZ     r1, restore             ; the first switch has nothing to save
+    TST     lr, #0x10
+    IT      EQ
+    VSTMDBEQ r0!, {s16-s31}
+    STMDB   r0!, {r4-r11, lr}
+    STR     r0, [r1]
+restore
+    LDR     r3, =__cpp(&Kernel_Next)
+    LDR     r1, [r3]
+    STR     r1, [r2]
+    LDR     r3, [r1, #4]
+    ADDS    r3, r3, #1
+    STR     r3, [r1, #4]
+    LDR     r0, [r1]
+    LDMIA   r0!, {r4-r11, lr}
+    TST     lr, #0x10
+    IT      EQ
+    VLDMIAEQ r0!, {s16-s31}
+    MSR     PSP, r0
+    BX      lr
+    ALIGN
+}
+#else
+__attribute__((naked)) void PendSV_Handler(void) {
+    __asm volatile (
+        "   mrs     r0, psp\n"
+        "   movw    r2, #:lower16:Kernel_Current\n"
+        "   movt    r2, #:upper16:Kernel_Current\n"
+        "   ldr     r1, [r2]\n"
+        "   cbz     r1, 1f\n"
+        "   tst     lr, #0x10\n"
+        "   it      eq\n"
+        "   vstmdbeq r0!, {s16-s31}\n"
+        "   stmdb   r0!, {r4-r11, lr}\n"
+        "   str     r0, [r1]\n"
+        "1: movw    r3, #:lower16:Kernel_Next\n"
+        "   movt    r3, #:upper16:Kernel_Next\n"
+        "   ldr     r1, [r3]\n"
+        "   str     r1, [r2]\n"
+        "   ldr     r3, [r1, #4]\n"
+        "   adds    r3, r3, #1\n"
+        "   str     r3, [r1, #4]\n"
+        "   ldr     r0, [r1]\n"
+        "   ldmia   r0!, {r4-r11, lr}\n"
+        "   tst     lr, #0x10\n"
+        "   it      eq\n"
+        "   vldmiaeq r0!, {s16-s31}\n"
+        "   msr     psp, r0\n"
+        "   bx      lr\n"
+    );
+}
+#endif
+#endif
+
+void Kernel_Init(void) {
+    unsigned long i;
+    for (i = 0; i <= KERNEL_PRIORITIES; i++) {
+        ByPriority[i] = 0;
+    }
+    Ready = 0;
+    Sleepers = 0;
+    Kernel_Current = Kernel_Next = 0;
+    NVIC_SYS_PRI3_R = (NVIC_SYS_PRI3_R & ~(NVIC_SYS_PRI3_TICK_M | NVIC_SYS_PRI3_PENDSV_M)) |
+                      (7 << NVIC_SYS_PRI3_PENDSV_S);
+    SysTick_OnAlarm(expired);
+    Kernel_Create(&Idle, idle, IdleStack, IDLE_WORDS, KERNEL_PRIORITIES, "idle");
+}
+
+void Kernel_Create(Thread *t, void (*body)(void), unsigned long *stack,
+                   unsigned long words, unsigned long priority, const char *name) {
+unsigned long sr;
+#ifdef KERNEL_LATENCY
+    unsigned long i;
+#endif
+    t->Body = body;
+    t->Name = name;
+    t->Priority = priority;
+    t->Bit = 1UL << priority;
+    t->Next = 0;
+    t->Due = NEVER;
+    t->Pending = t->Wait = 0;
+    t->Switches = 0;
+#ifdef KERNEL_LATENCY
+    for (i = 0; i < KERNEL_BUCKETS; i++) {
+        t->Latency[i] = 0;
+    }
+    t->WorstLatency = 0;
+    t->TotalLatency = 0;
+#endif
+    frame(t, stack, words);
+    sr = StartCritical();
+    ByPriority[priority] = t;
+    Ready |= t->Bit;
+    if (Kernel_Current) {
+        schedule();
+    }
+    EndCritical(sr);
+}
+
+void Kernel_Start(void) {
+    DisableInterrupts();
+    schedule();
+    EnableInterrupts();                 // PendSV switches to the first thread
+    while (1) {
+        WaitForInterrupt();
+    }
+}
+
+/* The thread stays ready while it arms the alarm, so being switched away
+   from in between only delays it. If the alarm has already woken it, it
+   carries on. */
+unsigned long long Kernel_SleepUntil(unsigned long long deadline) {
+    Thread *t = Kernel_Current, **p;
+    unsigned long long now;
+    unsigned long sr;
+    int armed, blocked = 0;
+    sr = StartCritical();
+    for (p = &Sleepers; *p && (*p)->Due <= deadline; p = &(*p)->Next) {
+    }
+    t->Due = deadline;
+    t->Next = *p;
+    *p = t;
+    EndCritical(sr);
+    armed = SysTick_Alarm(deadline);
+    sr = StartCritical();
+    if (t->Due != NEVER) {
+        if (armed) {
+            Ready &= ~t->Bit;
+            schedule();
+            blocked = 1;
+        } else {
+            for (p = &Sleepers; *p != t; p = &(*p)->Next) {
+            }
+            *p = t->Next;
+            t->Due = NEVER;
+        }
+    }
+    EndCritical(sr);                    // switches away until the alarm
+    while ((now = SysTick_Now()) < deadline) {}
+#ifdef KERNEL_LATENCY
+    if (blocked) {
+        timed(t);
+    }
+#else
+    (void)blocked;
+#endif
+    return now;
+}
+
+unsigned long Kernel_Wait(unsigned long events) {
+    Thread *t = Kernel_Current;
+    unsigned long got, sr;
+    int blocked = 0;
+    sr = StartCritical();
+    while (!(t->Pending & events)) {
+        t->Wait = events;
+        Ready &= ~t->Bit;
+        schedule();
+        blocked = 1;
+        EndCritical(sr);                // switches away until signalled
+        sr = StartCritical();
+    }
+    t->Wait = 0;
+    got = t->Pending & events;
+    t->Pending &= ~got;
+    EndCritical(sr);
+#ifdef KERNEL_LATENCY
+    if (blocked) {
+        timed(t);
+    }
+#else
+    (void)blocked;
+#endif
+    return got;
+}
+
+unsigned long Kernel_Take(unsigned long events) {
+    Thread *t = Kernel_Current;
+    unsigned long got, sr;
+    sr = StartCritical();
+    got = t->Pending & events;
+    t->Pending &= ~got;
+    EndCritical(sr);
+    return got;
+}
+
+/* Interrupt handlers may nest, so the update is done with them held off,
+   and left as they were: a handler that signals must not enable them. */
+void Kernel_Signal(Thread *t, unsigned long events) {
+    unsigned long sr = StartCritical();
+    t->Pending |= events;
+    if ((t->Wait & events) && !(Ready & t->Bit)) {
+#ifdef KERNEL_LATENCY
+        wake(t, SysTick_Now());
+#else
+        wake(t, 0);
+#endif
+        schedule();
+    }
+    EndCritical(sr);
+}
+
+Thread *Kernel_Self(void) {
+    return Kernel_Current;
+}
+
+unsigned long Kernel_Switches(void) {
+    unsigned long i, n = 0;
+    for (i = 0; i <= KERNEL_PRIORITIES; i++) {
+        if (ByPriority[i]) {
+            n += ByPriority[i]->Switches;
+        }
+    }
+    return n;
+}
@@ -0,0 +1,164 @@
+/** @file   Kernel.h
+ *  @brief  A small preemptive kernel with fixed-priority threads. Each
+ *          thread has its own stack and one priority of its own, 0 being
+ *          the highest. The highest-priority thread that is ready always
+ *          runs: an interrupt handler that makes a higher one ready pends
+ *          PendSV, which switches to it as soon as the handlers are done.
+ *
+ *          PendSV is the lowest-priority exception and SysTick stays the
+ *          highest. The switch saves r4-r11 on the thread's stack, and
+ *          s16-s31 too if the thread has used the FPU; the hardware stacks
+ *          s0-s15 lazily, only if the next thread touches the FPU.
+ *
+ *          SysTick is the kernel tick, tickless: a sleeping thread arms
+ *          its wake-up time with SysTick_Alarm(), and the SysTick handler
+ *          wakes it there. Threads must not call the SysTick waits, which
+ *          share that alarm.
+ *
+ *          Built with KERNEL_LATENCY defined, every wake-up is timed, from
+ *          the Kernel_Signal() call or the alarm to the thread running
+ *          again, into a histogram per thread.
+ *
+ *          Example, a thread woken by an interrupt handler:
+ *              unsigned long Stack[KERNEL_STACK(128)];
+ *              Thread Pacer;
+ *              void pace(void) {
+ *                  while (1) {
+ *                      Kernel_Wait(0x01);
+ *                      ...
+ *                  }
+ *              }
+ *              void GPIOPortF_Handler(void) {
+ *                  GPIO_PORTF_ICR_R = 0x10;
+ *                  Kernel_Signal(&Pacer, 0x01);
+ *              }
+ *              ...
+ *              Kernel_Create(&Pacer, pace, Stack, sizeof(Stack) / sizeof(Stack[0]), 0, "pacer");
+ *              Kernel_Start();
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#ifdef HOST_BUILD
+#include <ucontext.h>
+#endif
+
+#define KERNEL_PRIORITIES       31  // 0 to 30; the idle thread has 31
+#define KERNEL_BUCKETS          24  // latency histogram: bucket i is 2^(i-1) to 2^i - 1 cycles
+
+/* Stack size in words for a thread that needs 'words' on the LaunchPad.
+   On the host, the emulator and the C library run on it too. */
+#ifdef HOST_BUILD
+#define KERNEL_STACK(words)     ((words) + 16384)
+#else
+#define KERNEL_STACK(words)     (words)
+#endif
+
+typedef struct Thread {
+    unsigned long *Sp;              // saved stack pointer, first for PendSV
+    unsigned long Switches;         // times it was switched to, second for PendSV
+#ifdef HOST_BUILD
+    ucontext_t Context;
+#endif
+    void (*Body)(void);
+    const char *Name;
+    unsigned long Priority;
+    unsigned long Bit;              // 1 << Priority, in the ready set
+    struct Thread *Next;            // in the list of sleepers
+    unsigned long long Due;         // wake-up time while sleeping, else all ones
+    volatile unsigned long Pending; // events signalled and not yet taken
+    unsigned long Wait;             // events it is blocked on
+#ifdef KERNEL_LATENCY
+    unsigned long long Woken;       // when it was made ready
+    unsigned long Latency[KERNEL_BUCKETS];
+    unsigned long WorstLatency;     // in cycles
+    unsigned long long TotalLatency;
+#endif
+} Thread;
+
+/** @fn     Kernel_Init(void)
+ *  @brief  Sets PendSV to the lowest priority and SysTick to the highest,
+ *          and takes over the SysTick alarm. SysTick_Init() must have been
+ *          called.
+ *  @param  NULL
+ *  @return NULL
+ */
+void Kernel_Init(void);
+
+/** @fn     Kernel_Create(Thread *, void (*)(void), unsigned long *, unsigned long, unsigned long, const char *)
+ *  @brief  Adds a thread, ready to run. A thread whose body returns is
+ *          removed. Can be called from a running thread.
+ *  @param  Thread, which the caller owns and keeps.
+ *  @param  Body of the thread.
+ *  @param  Stack, 8-byte aligned.
+ *  @param  Size of the stack in words, from KERNEL_STACK(). Switches
+ *          take up to 51 words of it with the FPU in use, 17 without.
+ *  @param  Priority, 0 to KERNEL_PRIORITIES - 1, not used by another thread.
+ *  @param  Name, for statistics.
+ *  @return NULL
+ */
+void Kernel_Create(Thread *t, void (*body)(void), unsigned long *stack,
+                   unsigned long words, unsigned long priority, const char *name);
+
+/** @fn     Kernel_Start(void)
+ *  @brief  Switches to the highest-priority thread. The core sleeps when
+ *          no thread is ready. The stack of the caller is left to the
+ *          interrupt handlers.
+ *  @param  NULL
+ *  @return Does not return.
+ */
+void Kernel_Start(void);
+
+/** @fn     Kernel_SleepUntil(unsigned long long)
+ *  @brief  Blocks the calling thread until the given SysTick time. Times
+ *          less than about a thousand cycles away are waited out running.
+ *  @param  Time, in cycles since SysTick_Init().
+ *  @return The time the thread runs again.
+ */
+unsigned long long Kernel_SleepUntil(unsigned long long deadline);
+
+/** @fn     Kernel_Wait(unsigned long)
+ *  @brief  Blocks the calling thread until one of the events is signalled
+ *          to it. Events signalled before the call are not lost: it then
+ *          returns at once.
+ *  @param  Events, one per bit.
+ *  @return The events among them that were signalled, which are taken.
+ */
+unsigned long Kernel_Wait(unsigned long events);
+
+/** @fn     Kernel_Take(unsigned long)
+ *  @brief  Takes events signalled to the calling thread without waiting,
+ *          e.g. to drop stale ones before arming their interrupt.
+ *  @param  Events.
+ *  @return The events among them that were signalled.
+ */
+unsigned long Kernel_Take(unsigned long events);
+
+/** @fn     Kernel_Signal(Thread *, unsigned long)
+ *  @brief  Signals events to a thread, and makes it ready if it waits for
+ *          one of them. Safe to call from interrupt handlers, where the
+ *          switch happens once all handlers are done.
+ *  @param  Thread.
+ *  @param  Events.
+ *  @return NULL
+ */
+void Kernel_Signal(Thread *t, unsigned long events);
+
+/** @fn     Kernel_Self(void)
+ *  @brief  The running thread.
+ *  @param  NULL
+ *  @return Thread, or the idle thread.
+ */
+Thread *Kernel_Self(void);
+
+/** @fn     Kernel_Switches(void)
+ *  @brief  Number of context switches so far.
+ *  @param  NULL
+ *  @return Switches.
+ */
+unsigned long Kernel_Switches(void);
+
+#endif
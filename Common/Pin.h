@@ -0,0 +1,50 @@
+/** @file   Pin.h
+ *  @brief  Atomic access to GPIO pins through addresses worked out at
+ *          compile time, so that setting or clearing pins is a single
+ *          store instead of a load, an OR or AND, and a store.
+ *
+ *          PIN() uses the GPIO DATA aperture: address bits 9-2 of a
+ *          DATA access select the pins it reads or writes, and the other
+ *          pins of the port are left alone. Any set of pins of one port
+ *          can be written at once, e.g. PIN(GPIO_PORTF_BASE, 0x0E) = 0x08
+ *          turns on green and turns off red and blue. BITBAND() uses the
+ *          Cortex-M4 bit-band alias, where each bit of a peripheral
+ *          register has a word of its own, and works on any register bit.
+ *
+ *          Because a store through either one only changes the selected
+ *          bits, an interrupt handler changing other pins of the same port
+ *          in between can no longer be undone, as it can with
+ *          GPIO_PORTF_DATA_R |= 0x02. Pins outside 0x01-0xFF and bits
+ *          outside the peripheral bit-band region fail to compile.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef PIN_H
+#define PIN_H
+
+#include "tm4c123.h"
+
+/* 0 if the condition holds, a compile error (array of size -1) if not */
+#define PIN_CHECK(cond)         (0 * sizeof(char[(cond) ? 1 : -1]))
+
+/* Address of the DATA aperture of the given pins of a port */
+#define PIN_ADDR(base, pins)    ((base) + ((pins) << 2) + \
+                                 PIN_CHECK(((base) & 0xFFF) == 0 && (pins) >= 1 && (pins) <= 0xFF))
+
+/* The given pins of a port: reads return them with the other pins 0,
+   writes change only them */
+#define PIN(base, pins)         HWREG(PIN_ADDR(base, pins))
+
+/* Bit-band alias of bit n of a peripheral register */
+#define BITBAND_ADDR(addr, n)   (0x42000000 + (((addr) - 0x40000000) << 5) + ((n) << 2) + \
+                                 PIN_CHECK((addr) >= 0x40000000 && (addr) < 0x40100000 && (n) < 32))
+
+/* Bit n of a peripheral register: reads 0 or 1, writing 0 or 1 changes
+   only that bit */
+#define BITBAND(addr, n)        HWREG(BITBAND_ADDR(addr, n))
+
+/* Pin n of a port through the bit-band alias of its DATA register */
+#define PIN_BIT(base, n)        BITBAND((base) + 0x3FC, n)
+
+#endif
@@ -0,0 +1,167 @@
+#include "tm4c123.h"
+#include "Preempt.h"
+
+/* A state that goes on by itself once its time is up, such as a yellow */
+static int clearance(const FsmState *states, unsigned long s) {
+    return states[s].Count == 0 && states[s].Default != s;
+}
+
+/* How long a state holds, at most, before a request moves it on */
+static unsigned long hold(const FsmState *states, unsigned long s, const PreemptRequest *r) {
+    unsigned long limit = states[s].Time;
+    if (!clearance(states, s) && r->Min < limit) {
+        limit = r->Min;
+    }
+    return limit;
+}
+
+/* The states from s to the target by the fewest transitions, found
+   breadth first; path[0] is s. Returns their number, or 0 if there is
+   no way. */
+static unsigned long route(const FsmState *states, const FsmArc *arcs, unsigned long count,
+                           unsigned long s, unsigned long target, unsigned char *path) {
+    unsigned char from[PREEMPT_MAX_STATES], queue[PREEMPT_MAX_STATES];
+    unsigned long head = 0, tail = 0, x, y, i, n;
+    if (count > PREEMPT_MAX_STATES || s >= count || target >= count) {
+        return 0;
+    }
+    for (i = 0; i < count; i++) {
+        from[i] = 0xFF;
+    }
+    from[s] = (unsigned char)s;
+    queue[tail++] = (unsigned char)s;
+    while (head < tail && from[target] == 0xFF) {
+        x = queue[head++];
+        for (i = 0; i <= states[x].Count; i++) {
+            y = i < states[x].Count ? arcs[states[x].First + i].Next : states[x].Default;
+            if (from[y] == 0xFF) {
+                from[y] = (unsigned char)x;
+                queue[tail++] = (unsigned char)y;
+            }
+        }
+    }
+    if (from[target] == 0xFF) {
+        return 0;
+    }
+    for (n = 1, x = target; x != s; x = from[x]) {
+        n++;
+    }
+    for (i = n, x = target; i > 0; x = from[x]) {
+        path[--i] = (unsigned char)x;
+    }
+    return n;
+}
+
+unsigned long Preempt_Start(Preempt *p, const FsmState *states, unsigned long s) {
+    p->S = s;
+    p->Held = 0;
+    p->Serving = PREEMPT_NONE;
+    p->Served = 0;
+    p->Requests = 0;
+    p->Changed = 0;
+    return states[s].Time;
+}
+
+void Preempt_Set(Preempt *p, unsigned long raise, unsigned long drop) {
+    p->Requests = (p->Requests | raise) & ~drop;
+    p->Changed = 1;
+}
+
+unsigned long Preempt_Step(Preempt *p, const FsmState *states, const FsmArc *arcs, unsigned long count,
+                           const PreemptRequest *requests, unsigned long input, unsigned long ticks) {
+    unsigned char path[PREEMPT_MAX_STATES];
+    unsigned long n, k, raised, next, limit, sr;
+    p->Held += ticks;
+    if (p->Serving != PREEMPT_NONE && p->S == requests[p->Serving].Target) {
+        p->Served += ticks;
+    }
+    for (n = 0; n <= count + 1; n++) {
+        raised = p->Requests;
+        for (k = 0; k < 32 && !(raised >> k & 1); k++) {}
+        k = k < 32 ? k : PREEMPT_NONE;
+        if (k != p->Serving) {
+            p->Serving = k;         // a new request, or one of higher priority
+            p->Served = 0;
+        }
+        if (k == PREEMPT_NONE) {
+            if (p->Held < states[p->S].Time) {
+                return states[p->S].Time - p->Held;
+            }
+            next = Fsm_Next(states, arcs, p->S, input);
+        } else if (p->S == requests[k].Target) {
+            if (!requests[k].Hold) {
+                return PREEMPT_IDLE;
+            }
+            if (p->Served < requests[k].Hold) {
+                return requests[k].Hold - p->Served;
+            }
+            sr = StartCritical();   // handlers raise requests at any time
+            p->Requests &= ~(1UL << k);
+            EndCritical(sr);
+            continue;               // done: the next request, or the table
+        } else {
+            limit = hold(states, p->S, &requests[k]);
+            if (p->Held < limit) {
+                return limit - p->Held;
+            }
+            next = route(states, arcs, count, p->S, requests[k].Target, path) ? path[1]
+                 : Fsm_Next(states, arcs, p->S, input);
+        }
+        p->S = next;
+        p->Held = 0;
+        p->Served = 0;
+    }
+    return 1;                       // states of no time: look again next tick
+}
+
+void Preempt_Bound(const FsmState *states, const FsmArc *arcs, unsigned long count,
+                   const PreemptRequest *request, unsigned long *first, unsigned long *target) {
+    unsigned char path[PREEMPT_MAX_STATES];
+    unsigned long s, i, n, total;
+    *first = *target = 0;
+    for (s = 0; s < count; s++) {
+        if (s == request->Target) {
+            continue;
+        }
+        n = route(states, arcs, count, s, request->Target, path);
+        if (!n) {
+            *first = *target = 0;
+            return;
+        }
+        // the request comes as the state starts
+        total = 0;
+        for (i = 0; i + 1 < n; i++) {
+            total += hold(states, path[i], request);
+        }
+        if (hold(states, s, request) > *first) {
+            *first = hold(states, s, request);
+        }
+        if (total > *target) {
+            *target = total;
+        }
+    }
+}
+
+/* The step of a PreemptControl */
+static unsigned long step(FsmControl *control, unsigned long input, unsigned long ticks) {
+    PreemptControl *c = (PreemptControl *)control;
+    unsigned long w;
+    c->Ctl.Changed = 0;
+    w = Preempt_Step(&c->Ctl, c->States, c->Arcs, c->Count, c->Requests, input, ticks);
+    control->S = c->Ctl.S;
+    return w == PREEMPT_IDLE ? c->Idle : w;
+}
+
+unsigned long Preempt_Control(PreemptControl *c, const FsmState *states, const FsmArc *arcs,
+                              unsigned long count, const PreemptRequest *requests,
+                              unsigned long idle, unsigned long s) {
+    c->Control.Step = step;
+    c->Control.S = s;
+    c->Control.Event = &c->Ctl.Changed;
+    c->States = states;
+    c->Arcs = arcs;
+    c->Count = count;
+    c->Requests = requests;
+    c->Idle = idle;
+    return Preempt_Start(&c->Ctl, states, s);
+}
@@ -0,0 +1,136 @@
+/** @file   Preempt.h
+ *  @brief  Preemption of a traffic light's FSM by requests that cannot wait
+ *          for the end of a 30 s green: an emergency vehicle coming up a
+ *          road, or a pedestrian who wants to cross. Each request names
+ *          the state that serves it, and the requests are in priority
+ *          order, so an emergency takes over from a pedestrian.
+ *
+ *          A request never skips a state of the table. The controller goes
+ *          to the target by the shortest way the table's transitions allow,
+ *          and the states on the way are of two kinds:
+ *          - a state that goes on by itself once its time is up, a default
+ *            elsewhere and no arcs, is a clearance interval, the yellows.
+ *            It always runs its full time.
+ *          - a state that waits for its inputs, a green, is cut short as
+ *            soon as it has held the request's minimum.
+ *          The target then holds for as long as the request is raised, or
+ *          for the request's hold time after which the request is done,
+ *          e.g. a walk interval for a button press. With no request left,
+ *          the table takes over again from the state it is in.
+ *
+ *          The worst time from a request to the first change of the lights
+ *          and to the target is known from the tables alone: Preempt_Bound()
+ *          works it out.
+ *
+ *          Interrupt handlers raise and drop requests with Preempt_Set(),
+ *          which marks Changed; the controller sleeps until its state's
+ *          time is up or Changed is set, then calls Preempt_Step(). Through
+ *          an FsmControl (see Fsm.h), Changed is its Event.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef PREEMPT_H
+#define PREEMPT_H
+
+#include "Fsm.h"
+
+#define PREEMPT_MAX_STATES      32
+#define PREEMPT_NONE            0xFFFFFFFF  // no request is being served
+#define PREEMPT_IDLE            0xFFFFFFFF  // wait: only a change of the requests ends it
+
+typedef struct {
+    unsigned short Target;          // state that serves the request
+    unsigned short Min;             // ticks a green must have held before the request cuts it
+    unsigned short Hold;            // 0: the target holds while the request is raised;
+                                    // otherwise it holds this long and the request is done
+} PreemptRequest;
+
+typedef struct {
+    unsigned long S;                // current state
+    unsigned long Held;             // ticks in it
+    unsigned long Serving;          // request being served, or PREEMPT_NONE
+    unsigned long Served;           // ticks the target has held for it
+    volatile unsigned long Requests;    // raised, one bit each, bit 0 the highest priority
+    volatile unsigned long Changed;     // set by Preempt_Set(), cleared by the controller
+} Preempt;
+
+typedef struct {
+    FsmControl Control;             // first, for its Step()
+    Preempt Ctl;
+    const FsmState *States;
+    const FsmArc *Arcs;
+    unsigned long Count;
+    const PreemptRequest *Requests;
+    unsigned long Idle;             // ticks to wait for PREEMPT_IDLE
+} PreemptControl;
+
+/** @fn     Preempt_Start(Preempt *, const FsmState *, unsigned long)
+ *  @brief  Starts a controller with no requests.
+ *  @param  Controller.
+ *  @param  States.
+ *  @param  State to start in.
+ *  @return Ticks until the first Preempt_Step().
+ */
+unsigned long Preempt_Start(Preempt *p, const FsmState *states, unsigned long s);
+
+/** @fn     Preempt_Set(Preempt *, unsigned long, unsigned long)
+ *  @brief  Raises and drops requests, e.g. from an interrupt handler, and
+ *          sets Changed.
+ *  @param  Controller.
+ *  @param  Requests to raise, one bit each.
+ *  @param  Requests to drop.
+ *  @return NULL
+ */
+void Preempt_Set(Preempt *p, unsigned long raise, unsigned long drop);
+
+/** @fn     Preempt_Step(Preempt *, const FsmState *, const FsmArc *, unsigned long, const PreemptRequest *, unsigned long, unsigned long)
+ *  @brief  Takes the requests and the sensors, when the wait returned last
+ *          time is over or the requests have changed, and makes the
+ *          transitions that are due.
+ *  @param  Controller.
+ *  @param  States.
+ *  @param  Arcs.
+ *  @param  Number of states.
+ *  @param  Requests, highest priority first.
+ *  @param  Inputs, one per bit.
+ *  @param  Ticks since the last call.
+ *  @return Ticks until the next call, or PREEMPT_IDLE.
+ */
+unsigned long Preempt_Step(Preempt *p, const FsmState *states, const FsmArc *arcs, unsigned long count,
+                           const PreemptRequest *requests, unsigned long input, unsigned long ticks);
+
+/** @fn     Preempt_Bound(const FsmState *, const FsmArc *, unsigned long, const PreemptRequest *, unsigned long *, unsigned long *)
+ *  @brief  Worst case of a request, over every state and every point in it
+ *          that the request may come, with no request of higher priority.
+ *  @param  States.
+ *  @param  Arcs.
+ *  @param  Number of states.
+ *  @param  Request.
+ *  @param  Ticks to the first change of state, or 0 if it cannot reach
+ *          its target from some state.
+ *  @param  Ticks to the target.
+ *  @return NULL
+ */
+void Preempt_Bound(const FsmState *states, const FsmArc *arcs, unsigned long count,
+                   const PreemptRequest *request, unsigned long *first, unsigned long *target);
+
+/** @fn     Preempt_Control(PreemptControl *, const FsmState *, const FsmArc *, unsigned long, const PreemptRequest *, unsigned long, unsigned long)
+ *  @brief  Starts a controller with no requests, that steps by
+ *          Preempt_Step() through its Control, with Changed as its Event.
+ *          Requests go to its Ctl with Preempt_Set().
+ *  @param  Controller.
+ *  @param  States.
+ *  @param  Arcs.
+ *  @param  Number of states.
+ *  @param  Requests, highest priority first.
+ *  @param  Ticks until it looks again when only a change of the requests
+ *          could end the wait, e.g. to sample the sensors.
+ *  @param  State to start in.
+ *  @return Ticks until the first step.
+ */
+unsigned long Preempt_Control(PreemptControl *c, const FsmState *states, const FsmArc *arcs,
+                              unsigned long count, const PreemptRequest *requests,
+                              unsigned long idle, unsigned long s);
+
+#endif
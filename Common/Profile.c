@@ -0,0 +1,89 @@
+#include "Profile.h"
+#ifdef HOST_BUILD
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+#define CALIBRATE       16          // empty regions timed to find the overhead
+
+#if defined(__CC_ARM)
+#define CLZ(x)          __clz(x)
+#else
+#define CLZ(x)          __builtin_clz(x)
+#endif
+
+Region Profile_Regions[PROFILE_REGIONS];
+unsigned long Profile_Overhead;
+
+#ifdef HOST_BUILD
+/* Prints every region that ran, and its histogram */
+static void report(void) {
+    unsigned long r, i;
+    for (r = 0; r < PROFILE_REGIONS; r++) {
+        Region *g = &Profile_Regions[r];
+        if (!g->Count) {
+            continue;
+        }
+        fprintf(stderr, "[profile] %s: %lu runs, min %lu, mean %.1f, max %lu cycles\n",
+                g->Name ? g->Name : "?", g->Count, g->Min, (double)g->Total / g->Count, g->Max);
+        for (i = 0; i < PROFILE_BUCKETS; i++) {
+            if (g->Hist[i]) {
+                fprintf(stderr, "[profile]   < %lu: %lu\n", 1UL << i, g->Hist[i]);
+            }
+        }
+    }
+}
+#endif
+
+void Profile_Init(void) {
+    unsigned long i;
+    NVIC_DBG_INT_R |= NVIC_DBG_INT_TRCENA;
+    DWT_CYCCNT_R = 0;
+    DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+    Profile_Overhead = 0;
+    Profile_Clear();
+    for (i = 0; i < CALIBRATE; i++) {
+        Profile_Regions[0].Start = DWT_CYCCNT_R;
+        Profile_Add(0, DWT_CYCCNT_R - Profile_Regions[0].Start);
+    }
+    Profile_Overhead = Profile_Regions[0].Min;
+    Profile_Clear();
+#ifdef HOST_BUILD
+    atexit(report);
+#endif
+}
+
+void Profile_Add(unsigned long r, unsigned long cycles) {
+    Region *g = &Profile_Regions[r];
+    unsigned long bucket;
+    cycles &= 0xFFFFFFFF;           // across a wrap of CYCCNT, where longs are wider
+    cycles = cycles > Profile_Overhead ? cycles - Profile_Overhead : 0;
+    bucket = cycles ? 32 - CLZ(cycles) : 0;
+    if (bucket >= PROFILE_BUCKETS) {
+        bucket = PROFILE_BUCKETS - 1;
+    }
+    g->Hist[bucket]++;
+    g->Count++;
+    g->Total += cycles;
+    if (cycles < g->Min) {
+        g->Min = cycles;
+    }
+    if (cycles > g->Max) {
+        g->Max = cycles;
+    }
+    CPU_CYCLES(16);     // a dozen instructions, the 64-bit add and the stores
+}
+
+void Profile_Clear(void) {
+    unsigned long r, i;
+    for (r = 0; r < PROFILE_REGIONS; r++) {
+        Region *g = &Profile_Regions[r];
+        g->Count = 0;
+        g->Min = 0xFFFFFFFF;
+        g->Max = 0;
+        g->Total = 0;
+        for (i = 0; i < PROFILE_BUCKETS; i++) {
+            g->Hist[i] = 0;
+        }
+    }
+}
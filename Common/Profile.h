@@ -0,0 +1,92 @@
+/** @file   Profile.h
+ *  @brief  Cycle profiling of named code regions with the DWT cycle
+ *          counter of the Cortex-M4. Each region keeps its count, min, max
+ *          and mean in cycles, and a log2 histogram, in a fixed table in
+ *          RAM that the debugger can read at any time.
+ *
+ *          The probes only exist when the program is built with PROFILE
+ *          defined; otherwise the macros below expand to nothing and
+ *          Profile.c need not be linked. A start probe is one load of
+ *          CYCCNT and one store. A stop probe loads CYCCNT before calling
+ *          Profile_Add(), and the cost of an empty start/stop pair, timed
+ *          by PROFILE_INIT(), is taken off every region, so an empty region
+ *          reads 0. Interrupts taken inside a region are counted in it.
+ *
+ *          On the host, CYCCNT is the emulator's cycle count, so the
+ *          numbers compare with the LaunchPad's as far as the emulator's
+ *          cycle model goes. The table is printed to stderr on exit.
+ *
+ *          Example:
+ *              enum {PROF_STEP};
+ *              PROFILE_INIT();
+ *              PROFILE_NAME(PROF_STEP, "step");
+ *              while (1) {
+ *                  PROFILE_START(PROF_STEP);
+ *                  S = FSM[S].Next[Input];
+ *                  PROFILE_STOP(PROF_STEP);
+ *              }
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "tm4c123.h"
+
+#ifndef PROFILE_REGIONS
+#define PROFILE_REGIONS         8   // regions 0 to 7
+#endif
+#define PROFILE_BUCKETS         32  // bucket i is 2^(i-1) to 2^i - 1 cycles, the last one up
+
+typedef struct {
+    const char *Name;
+    unsigned long Start;            // CYCCNT at the latest start probe
+    unsigned long Count;            // times it was run
+    unsigned long Min, Max;         // in cycles
+    unsigned long long Total;
+    unsigned long Hist[PROFILE_BUCKETS];
+} Region;
+
+extern Region Profile_Regions[PROFILE_REGIONS];
+extern unsigned long Profile_Overhead;
+
+#ifdef PROFILE
+#define PROFILE_INIT()          Profile_Init()
+#define PROFILE_NAME(r, name)   (Profile_Regions[r].Name = (name))
+#define PROFILE_START(r)        (Profile_Regions[r].Start = DWT_CYCCNT_R)
+#define PROFILE_STOP(r)         Profile_Add(r, DWT_CYCCNT_R - Profile_Regions[r].Start)
+#else
+#define PROFILE_INIT()
+#define PROFILE_NAME(r, name)
+#define PROFILE_START(r)
+#define PROFILE_STOP(r)
+#endif
+
+/** @fn     Profile_Init(void)
+ *  @brief  Starts the cycle counter, times an empty region to find the
+ *          cost of the probes themselves, and clears the table. Called
+ *          through PROFILE_INIT().
+ *  @param  NULL
+ *  @return NULL
+ */
+void Profile_Init(void);
+
+/** @fn     Profile_Add(unsigned long, unsigned long)
+ *  @brief  Adds one run of a region. Called through PROFILE_STOP(). Runs
+ *          of one region must not overlap, e.g. in a handler and in the
+ *          code it interrupts.
+ *  @param  Region, below PROFILE_REGIONS.
+ *  @param  Cycles counted by the probes, before the overhead is taken off.
+ *  @return NULL
+ */
+void Profile_Add(unsigned long r, unsigned long cycles);
+
+/** @fn     Profile_Clear(void)
+ *  @brief  Clears the counts of all regions and keeps their names.
+ *  @param  NULL
+ *  @return NULL
+ */
+void Profile_Clear(void);
+
+#endif
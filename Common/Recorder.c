@@ -0,0 +1,51 @@
+#include "Recorder.h"
+
+void Recorder_Init(Recorder *r, Event *buf, unsigned long capacity, int mode) {
+    r->Buf = buf;
+    r->Mask = capacity - 1;
+    r->Mode = mode;
+    r->Head = r->Tail = 0;
+    r->Dropped = 0;
+    r->Lost = 0;
+}
+
+/* Fill the slot first, then publish it by moving Head */
+int Recorder_Record(Recorder *r, unsigned long long time, unsigned long data) {
+    unsigned long head = r->Head;
+    volatile Event *e;
+    if (r->Mode == RECORDER_STOP && head - r->Tail > r->Mask) {
+        r->Dropped++;
+        return 0;
+    }
+    e = &r->Buf[head & r->Mask];
+    e->Time = time;
+    e->Data = data;
+    r->Head = head + 1;
+    return 1;
+}
+
+unsigned long Recorder_Drain(Recorder *r, Event *out, unsigned long max) {
+    unsigned long tail = r->Tail;
+    unsigned long head;
+    unsigned long n = 0;
+    while (n < max) {
+        head = r->Head;
+        if (r->Mode == RECORDER_WRAP && head - tail > r->Mask) {
+            // the slot at tail may be getting overwritten: skip past it
+            r->Lost += head - tail - r->Mask;
+            tail = head - r->Mask;
+        }
+        if (tail == head) {
+            break;
+        }
+        out[n].Time = r->Buf[tail & r->Mask].Time;
+        out[n].Data = r->Buf[tail & r->Mask].Data;
+        if (r->Mode == RECORDER_WRAP && r->Head - tail > r->Mask) {
+            continue;                   // overwritten while copying
+        }
+        tail++;
+        n++;
+    }
+    r->Tail = tail;
+    return n;
+}
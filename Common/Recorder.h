@@ -0,0 +1,74 @@
+/** @file   Recorder.h
+ *  @brief  Event recorder for debugging dumps that can stay in production
+ *          builds. Events go into a single-producer/single-consumer ring
+ *          buffer: one context records (main loop or an interrupt handler)
+ *          and one context drains (a UART task, or the debugger reading
+ *          memory). Neither side ever disables interrupts or waits for the
+ *          other, and recording takes the same few instructions every time.
+ *
+ *          RECORDER_WRAP overwrites the oldest events like a flight recorder,
+ *          so the latest ones are always available. RECORDER_STOP keeps the
+ *          first events and drops new ones while the buffer is full.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#define RECORDER_WRAP   0       // overwrite the oldest events when full
+#define RECORDER_STOP   1       // drop new events when full
+
+/* One recorded event */
+typedef struct {
+    unsigned long long Time;    // when it happened, e.g. SysTick_Now()
+    unsigned long Data;         // what happened, e.g. the port bits
+} Event;
+
+/* State of a recorder. Head is only written by the producer and Tail only
+   by the consumer; both count events and are reduced modulo the capacity
+   when indexing. */
+typedef struct {
+    volatile Event *Buf;            // storage, a power of two of events
+    unsigned long Mask;             // capacity - 1
+    int Mode;                       // RECORDER_WRAP or RECORDER_STOP
+    volatile unsigned long Head;    // events recorded so far
+    volatile unsigned long Tail;    // events drained or skipped so far
+    volatile unsigned long Dropped; // events refused while full (stop mode)
+    unsigned long Lost;             // events overwritten before being drained (wrap mode)
+} Recorder;
+
+/** @fn     Recorder_Init(Recorder *, Event *, unsigned long, int)
+ *  @brief  Starts an empty recorder on the given storage.
+ *  @param  Recorder to initialize.
+ *  @param  Storage for the events.
+ *  @param  Number of events the storage holds, a power of two.
+ *  @param  RECORDER_WRAP or RECORDER_STOP.
+ *  @return NULL
+ */
+void Recorder_Init(Recorder *r, Event *buf, unsigned long capacity, int mode);
+
+/** @fn     Recorder_Record(Recorder *, unsigned long long, unsigned long)
+ *  @brief  Records an event. Must only be called from one context, which
+ *          may be an interrupt handler.
+ *  @param  Recorder to record into.
+ *  @param  Time of the event.
+ *  @param  Data of the event.
+ *  @return 1 if the event was stored, 0 if it was dropped (stop mode, full).
+ */
+int Recorder_Record(Recorder *r, unsigned long long time, unsigned long data);
+
+/** @fn     Recorder_Drain(Recorder *, Event *, unsigned long)
+ *  @brief  Moves the oldest recorded events out of the buffer, while
+ *          recording carries on. Must only be called from one context. In
+ *          wrap mode, events the producer overwrote are counted in Lost and
+ *          skipped, and the oldest slot of a full buffer counts as
+ *          overwritten, so at most capacity - 1 events come out at once.
+ *  @param  Recorder to drain.
+ *  @param  Where to copy the events, oldest first.
+ *  @param  Most events to copy.
+ *  @return Number of events copied.
+ */
+unsigned long Recorder_Drain(Recorder *r, Event *out, unsigned long max);
+
+#endif
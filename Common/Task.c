@@ -0,0 +1,178 @@
+#include "../SysTick Timer/SysTick.h"
+#include "Task.h"
+
+static Task *Head, *Tail;                   // run queue, oldest first
+static Task *Tasks;                         // every task
+static volatile unsigned long Pending;      // events signalled, not yet handed out
+static unsigned long Rearm;                 // the wheel changed since its next tick was read
+static unsigned long long Idle;
+static unsigned long Switches;
+
+static void enqueue(Task *t) {
+    if (t->Queued || t->Exited) {
+        return;
+    }
+    t->Queued = 1;
+    t->Next = 0;
+    if (Tail) {
+        Tail->Next = t;
+    } else {
+        Head = t;
+    }
+    Tail = t;
+}
+
+/* Timer of a sleep or a timeout */
+static void expired(void *arg) {
+    Task *t = arg;
+    t->Wait = 0;
+    t->Got = 0;
+    enqueue(t);
+}
+
+/* Hands the events signalled so far to the tasks waiting for them */
+static void dispatch(void) {
+    unsigned long events, sr;
+    Task *t;
+    sr = StartCritical();
+    events = Pending;
+    Pending = 0;
+    EndCritical(sr);
+    for (t = Tasks; t; t = t->All) {
+        if (t->Wait & events) {
+            t->Got = t->Wait & events;
+            t->Wait = 0;
+            Wheel_Cancel(&t->Timer);
+            Rearm = 1;
+            enqueue(t);
+        }
+    }
+}
+
+void Task_Init(unsigned long tick) {
+    Head = Tail = Tasks = 0;
+    Pending = 0;
+    Idle = 0;
+    Switches = 0;
+    Rearm = 1;
+    Wheel_Init(tick);
+}
+
+/* A task created again after it exited is already in the list */
+void Task_Create(Task *t, char (*body)(Task *), const char *name) {
+    Task *u;
+    t->Body = body;
+    t->Name = name;
+    t->Line = 0;
+    t->Queued = t->Exited = 0;
+    t->Wait = t->Got = 0;
+    t->Timer.Prev = 0;
+    t->Cycles = 0;
+    t->Runs = t->WorstRun = 0;
+    for (u = Tasks; u && u != t; u = u->All) {
+    }
+    if (!u) {
+        t->All = Tasks;
+        Tasks = t;
+    }
+    enqueue(t);
+}
+
+/* Interrupt handlers may nest, so the update is done with them held off,
+   and left as they were: a handler that signals must not enable them. */
+void Task_Signal(unsigned long events) {
+    unsigned long sr = StartCritical();
+    Pending |= events;
+    EndCritical(sr);
+}
+
+void Task_Ready(Task *t) {
+    t->Wait = 0;
+    Wheel_Cancel(&t->Timer);
+    Rearm = 1;
+    enqueue(t);
+}
+
+void Task_Sleep(Task *t, unsigned long ticks) {
+    Wheel_Start(&t->Timer, ticks, 0, expired, t);
+    Rearm = 1;
+}
+
+void Task_SleepUntil(Task *t, unsigned long long tick) {
+    unsigned long long now = Wheel_Ticks();
+    Task_Sleep(t, tick > now ? (unsigned long)(tick - now) : 1);
+}
+
+void Task_Wait(Task *t, unsigned long events, unsigned long ticks) {
+    t->Wait = events;
+    t->Got = 0;
+    if (ticks) {
+        Task_Sleep(t, ticks);
+    }
+}
+
+unsigned long long Task_Tick(unsigned long long time) {
+    return Wheel_TickAt(time);
+}
+
+/* The time between two readings of SysTick goes to the task that ran in
+   between, or to Idle; what is left (timers and events) is the cost of
+   the scheduler. The next timer is only looked up again after the wheel
+   changed. */
+void Task_Run(void) {
+    unsigned long long now = SysTick_Now(), at = WHEEL_NEVER, next = WHEEL_NEVER, end;
+    unsigned long took;
+    Task *t;
+    for (;;) {
+        if (Pending) {
+            dispatch();
+        }
+        if (Rearm) {
+            Rearm = 0;
+            next = Wheel_Next();
+            at = next == WHEEL_NEVER ? WHEEL_NEVER : Wheel_Time(next);
+        }
+        if (now >= at) {
+            Wheel_Advance(next);
+            Rearm = 1;
+            now = SysTick_Now();
+            continue;
+        }
+        t = Head;
+        if (t) {
+            Head = t->Next;
+            if (!Head) {
+                Tail = 0;
+            }
+            t->Queued = 0;
+            CPU_CYCLES(20);     // dequeue, call through the pointer, switch on Line, return
+            if (t->Body(t) == TASK_EXITED) {
+                t->Exited = 1;
+                t->Wait = 0;
+                Wheel_Cancel(&t->Timer);
+                Rearm = 1;
+            }
+            end = SysTick_Now();
+            took = (unsigned long)(end - now);
+            t->Cycles += took;
+            t->Runs++;
+            if (took > t->WorstRun) {
+                t->WorstRun = took;
+            }
+            Switches++;
+            now = end;
+            continue;
+        }
+        end = SysTick_WaitEvent(at, &Pending);
+        Idle += end - now;
+        now = end;
+    }
+}
+
+unsigned long long Task_Idle(void) {
+    return Idle;
+}
+
+unsigned long Task_Switches(void) {
+    return Switches;
+}
@@ -0,0 +1,173 @@
+/** @file   Task.h
+ *  @brief  Cooperative tasks without stacks of their own (protothreads).
+ *          A task is a function that runs until it has to wait, records
+ *          where it stopped, and returns; the next time it runs, a switch
+ *          on that line number takes it back there. All tasks share the
+ *          one stack, and a switch between them is a return and a call.
+ *
+ *          Tasks wait for a number of ticks of the timer wheel (Wheel.h),
+ *          for an absolute tick, or for events that interrupt handlers
+ *          signal with Task_Signal(). Task_Run() runs the tasks that are
+ *          ready in turn, and sleeps in between until the next timer or
+ *          event. It counts the cycles each task runs for, and the time
+ *          the core sleeps.
+ *
+ *          Local variables of a task body do not survive a wait: keep its
+ *          state in static variables, or in a struct that embeds the Task.
+ *          A wait cannot be inside a switch statement of the body.
+ *
+ *          Example, blinking PF2 every 500 ms:
+ *              static char Blink(Task *t) {
+ *                  TASK_BEGIN(t);
+ *                  while (1) {
+ *                      PIN(GPIO_PORTF_BASE, 0x04) ^= 0x04;
+ *                      TASK_SLEEP(t, 500000);      // in 1 us ticks
+ *                  }
+ *                  TASK_END(t);
+ *              }
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef TASK_H
+#define TASK_H
+
+#include "../SysTick Timer/Wheel.h"
+
+/* What a task body returns */
+#define TASK_WAITING            0   // stopped at a wait, to be resumed
+#define TASK_EXITED             1   // reached TASK_END(), or TASK_EXIT()
+
+typedef struct Task {
+    char (*Body)(struct Task *t);
+    const char *Name;
+    struct Task *Next;              // in the run queue
+    struct Task *All;               // in the list of every task
+    unsigned short Line;            // where the body resumes, 0 at the start
+    unsigned char Queued;           // in the run queue
+    unsigned char Exited;
+    unsigned long Wait;             // events the task is waiting for
+    unsigned long Got;              // events that woke it, 0 if its timer did
+    WheelTimer Timer;               // wakes it after a sleep or timeout
+    unsigned long long Cycles;      // time spent running it
+    unsigned long Runs;             // times it ran
+    unsigned long WorstRun;         // longest single run, in cycles
+} Task;
+
+/* The body of a task is written between TASK_BEGIN() and TASK_END() */
+#define TASK_BEGIN(t)           switch ((t)->Line) { case 0:
+#define TASK_END(t)             } (t)->Line = 0; return TASK_EXITED
+
+/* Stops at this line and returns; the next run starts right after it */
+#define TASK_RESUME_HERE(t)     (t)->Line = __LINE__; return TASK_WAITING; case __LINE__:
+
+/* Lets the other ready tasks run first */
+#define TASK_YIELD(t)           do { Task_Ready(t); TASK_RESUME_HERE(t); } while (0)
+
+/* Sleeps for a number of ticks, or until an absolute tick */
+#define TASK_SLEEP(t, ticks)    do { Task_Sleep(t, ticks); TASK_RESUME_HERE(t); } while (0)
+#define TASK_SLEEP_UNTIL(t, tick) do { Task_SleepUntil(t, tick); TASK_RESUME_HERE(t); } while (0)
+
+/* Waits for any of the events, for at most 'ticks' (0: no limit). Which
+   events came is in (t)->Got afterwards, 0 after a timeout. */
+#define TASK_WAIT_EVENT(t, events, ticks) do { Task_Wait(t, events, ticks); TASK_RESUME_HERE(t); } while (0)
+
+/* Ends the task */
+#define TASK_EXIT(t)            do { (t)->Line = 0; return TASK_EXITED; } while (0)
+
+/** @fn     Task_Init(unsigned long)
+ *  @brief  Starts the timer wheel the tasks sleep on. SysTick_Init() must
+ *          have been called.
+ *  @param  Length of a tick in clock cycles.
+ *  @return NULL
+ */
+void Task_Init(unsigned long tick);
+
+/** @fn     Task_Create(Task *, char (*)(Task *), const char *)
+ *  @brief  Adds a task, or starts one that exited again, ready to run
+ *          from the start of its body.
+ *  @param  Task, which the caller owns and keeps.
+ *  @param  Body of the task.
+ *  @param  Name, for statistics.
+ *  @return NULL
+ */
+void Task_Create(Task *t, char (*body)(Task *), const char *name);
+
+/** @fn     Task_Run(void)
+ *  @brief  Runs the tasks for ever: the ready ones in the order they became
+ *          ready, and the timers and events that make others ready. Sleeps
+ *          when none is ready.
+ *  @param  NULL
+ *  @return Does not return.
+ */
+void Task_Run(void);
+
+/** @fn     Task_Signal(unsigned long)
+ *  @brief  Signals events, one per bit. Every task waiting for one of them
+ *          is made ready. An event no task is waiting for is dropped, so
+ *          check the condition before waiting for it. Safe to call from
+ *          interrupt handlers.
+ *  @param  Events.
+ *  @return NULL
+ */
+void Task_Signal(unsigned long events);
+
+/** @fn     Task_Ready(Task *)
+ *  @brief  Makes a task ready to run, cancelling what it waits for.
+ *          TASK_YIELD() uses it. Not for interrupt handlers.
+ *  @param  Task.
+ *  @return NULL
+ */
+void Task_Ready(Task *t);
+
+/** @fn     Task_Sleep(Task *, unsigned long)
+ *  @brief  Arms the task's timer to make it ready after a number of ticks.
+ *          TASK_SLEEP() uses it.
+ *  @param  Task.
+ *  @param  Ticks, at least 1.
+ *  @return NULL
+ */
+void Task_Sleep(Task *t, unsigned long ticks);
+
+/** @fn     Task_SleepUntil(Task *, unsigned long long)
+ *  @brief  Arms the task's timer to make it ready at an absolute tick, or
+ *          at the next one if it has passed. TASK_SLEEP_UNTIL() uses it.
+ *  @param  Task.
+ *  @param  Tick, as from Task_Tick().
+ *  @return NULL
+ */
+void Task_SleepUntil(Task *t, unsigned long long tick);
+
+/** @fn     Task_Wait(Task *, unsigned long, unsigned long)
+ *  @brief  Makes the task wait for events, with a timeout if 'ticks' is
+ *          not 0. TASK_WAIT_EVENT() uses it.
+ *  @param  Task.
+ *  @param  Events.
+ *  @param  Timeout in ticks, or 0.
+ *  @return NULL
+ */
+void Task_Wait(Task *t, unsigned long events, unsigned long ticks);
+
+/** @fn     Task_Tick(unsigned long long)
+ *  @brief  The first tick at or after a SysTick time, e.g. to sleep until
+ *          a time stamped by an interrupt handler plus a delay.
+ *  @param  Time in cycles since SysTick_Init().
+ *  @return Tick.
+ */
+unsigned long long Task_Tick(unsigned long long time);
+
+/** @fn     Task_Idle(void)
+ *  @brief  Time the core has slept in Task_Run(), in cycles.
+ *  @param  NULL
+ *  @return Cycles.
+ */
+unsigned long long Task_Idle(void);
+
+/** @fn     Task_Switches(void)
+ *  @brief  Number of task runs so far, over all tasks.
+ *  @param  NULL
+ *  @return Runs.
+ */
+unsigned long Task_Switches(void);
+
+#endif
@@ -0,0 +1,163 @@
+#include "Trace.h"
+
+#define LONG_GAP        0x80    // 10000 sss: full gap follows
+#define LONG_DATA       0x88    // 10001 000: full gap and data follow
+#define MAX_VARINT      10      // bytes of a 64-bit varint
+#define MAX_RECORD      (1 + 2 * MAX_VARINT)    // header, gap, data as long as the host's 64 bits
+
+void Trace_Init(Trace *t, unsigned char *buf, unsigned long size, int mode, unsigned long shift) {
+    t->Buf = buf;
+    t->Mask = size / TRACE_BLOCK - 1;
+    t->Mode = mode;
+    t->Shift = shift;
+    t->Head = t->Tail = 0;
+    t->Used = 0;
+    t->Time = t->Gap = 0;
+    t->Events = 0;
+    t->Dropped = 0;
+    t->Lost = 0;
+}
+
+/* Writes v as a varint, returns its length */
+static unsigned long put(unsigned char *p, unsigned long long v) {
+    unsigned long n = 0;
+    while (v >= 0x80) {
+        p[n++] = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (unsigned char)v;
+    return n;
+}
+
+/* Encodes an event relative to the block's latest one */
+static unsigned long encode(Trace *t, unsigned char *p, unsigned long long q, unsigned long data) {
+    unsigned long long gap = q - t->Time;
+    unsigned long long dod = gap - t->Gap + 8;  // 0..15 when it fits
+    unsigned long n;
+    if (data < 8) {
+        if (dod < 16) {
+            p[0] = (unsigned char)((dod << 3) | data);
+            return 1;
+        }
+        p[0] = (unsigned char)(LONG_GAP | data);
+        return 1 + put(p + 1, gap);
+    }
+    p[0] = LONG_DATA;
+    n = 1 + put(p + 1, gap);
+    return n + put(p + n, data);
+}
+
+int Trace_Record(Trace *t, unsigned long long time, unsigned long data) {
+    unsigned char rec[MAX_RECORD];
+    unsigned long long q = time >> t->Shift;
+    unsigned long n, i;
+    volatile unsigned char *block;
+    if (t->Used) {
+        n = encode(t, rec, q, data);
+        if (t->Used + n > TRACE_BLOCK) {
+            t->Head = t->Head + 1;      // full: hand it to the consumer
+            t->Used = 0;
+        }
+    }
+    if (!t->Used) {
+        if (t->Mode == TRACE_STOP && t->Head - t->Tail > t->Mask) {
+            t->Dropped++;
+            return 0;
+        }
+        t->Buf[(t->Head & t->Mask) * TRACE_BLOCK] = (unsigned char)(TRACE_TAG | t->Shift);
+        t->Used = 1;
+        t->Time = t->Gap = 0;           // the first gap counts from zero
+        n = encode(t, rec, q, data);
+    }
+    block = &t->Buf[(t->Head & t->Mask) * TRACE_BLOCK];
+    for (i = 0; i < n; i++) {
+        block[t->Used + i] = rec[i];
+    }
+    t->Used += n;
+    if (t->Used < TRACE_BLOCK) {
+        block[t->Used] = TRACE_END;     // so a memory dump decodes too
+    }
+    t->Gap = q - t->Time;
+    t->Time = q;
+    t->Events++;
+    return 1;
+}
+
+int Trace_Drain(Trace *t, unsigned char *out) {
+    unsigned long tail = t->Tail;
+    unsigned long head;
+    unsigned long i;
+    volatile unsigned char *block;
+    for (;;) {
+        head = t->Head;
+        if (t->Mode == TRACE_WRAP && head - tail > t->Mask) {
+            // the block at tail may be getting overwritten: skip past it
+            t->Lost += head - tail - t->Mask;
+            tail = head - t->Mask;
+        }
+        if (tail == head) {
+            t->Tail = tail;
+            return 0;
+        }
+        block = &t->Buf[(tail & t->Mask) * TRACE_BLOCK];
+        for (i = 0; i < TRACE_BLOCK; i++) {
+            out[i] = block[i];
+        }
+        if (t->Mode == TRACE_WRAP && t->Head - tail > t->Mask) {
+            continue;                   // overwritten while copying
+        }
+        t->Tail = tail + 1;
+        return 1;
+    }
+}
+
+/* Reads a varint that must end inside the block, returns its length or 0 */
+static unsigned long get(const unsigned char *p, unsigned long room, unsigned long long *v) {
+    unsigned long n = 0;
+    *v = 0;
+    while (n < room && n < MAX_VARINT) {
+        *v |= (unsigned long long)(p[n] & 0x7F) << (7 * n);
+        if (!(p[n++] & 0x80)) {
+            return n;
+        }
+    }
+    return 0;
+}
+
+unsigned long Trace_Decode(const unsigned char *block, Event *out, unsigned long max) {
+    unsigned long shift, pos = 1, n = 0, len;
+    unsigned long long time = 0, gap = 0, v;
+    unsigned char b;
+    if ((block[0] & TRACE_TAG_M) != TRACE_TAG) {
+        return 0;
+    }
+    shift = block[0] & ~TRACE_TAG_M;
+    while (pos < TRACE_BLOCK && n < max && (b = block[pos++]) != TRACE_END) {
+        if (!(b & 0x80)) {
+            gap += (unsigned long long)(b >> 3) - 8;
+            out[n].Data = b & 7;
+        } else if ((b & 0xF8) == LONG_GAP) {
+            if (!(len = get(block + pos, TRACE_BLOCK - pos, &gap))) {
+                break;
+            }
+            pos += len;
+            out[n].Data = b & 7;
+        } else if (b == LONG_DATA) {
+            if (!(len = get(block + pos, TRACE_BLOCK - pos, &gap))) {
+                break;
+            }
+            pos += len;
+            if (!(len = get(block + pos, TRACE_BLOCK - pos, &v))) {
+                break;
+            }
+            pos += len;
+            out[n].Data = (unsigned long)v;
+        } else {
+            break;                      // reserved
+        }
+        time += gap;
+        out[n].Time = time << shift;
+        n++;
+    }
+    return n;
+}
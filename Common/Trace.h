@@ -0,0 +1,96 @@
+/** @file   Trace.h
+ *  @brief  Compressed event trace, holding roughly ten times as many events
+ *          as Recorder.h in the same RAM when the data is a few pin bits
+ *          and the events come at a steady rate.
+ *
+ *          Times are kept in units of 2^shift cycles. Every event stores
+ *          its time as the change from the previous gap (delta of delta),
+ *          so a periodic signal costs one byte per event:
+ *          - 0dddd sss             gap = previous gap + dddd (-8..7), data sss
+ *          - 10000 sss + varint    gap given in full (large gaps), data sss
+ *          - 10001 000 + varint + varint   gap and data given in full
+ *          - 11111 111             end of the block
+ *          Varints hold 7 bits per byte, lowest first, with the top bit set
+ *          on all but the last byte.
+ *
+ *          The buffer is split into TRACE_BLOCK byte blocks. A block starts
+ *          with TRACE_TAG | shift, and its first gap counts from time zero,
+ *          so every block decodes on its own. Whole blocks are handed to the
+ *          consumer, or overwritten in wrap mode, the same way Recorder.h
+ *          does it for single events: one producer, one consumer, no locks.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "Recorder.h"
+
+#define TRACE_BLOCK     64      // bytes per block
+#define TRACE_TAG       0xC0    // first byte of a block, or'ed with the shift
+#define TRACE_TAG_M     0xE0
+#define TRACE_END       0xFF    // ends a block that is not full
+#define TRACE_WRAP      RECORDER_WRAP
+#define TRACE_STOP      RECORDER_STOP
+
+/* State of a trace. Head and Tail count blocks; the producer fills block
+   Head while the consumer reads the ones before it. */
+typedef struct {
+    volatile unsigned char *Buf;    // storage, a power of two of blocks
+    unsigned long Mask;             // blocks - 1
+    int Mode;                       // TRACE_WRAP or TRACE_STOP
+    unsigned long Shift;            // times are in units of 2^Shift cycles
+    volatile unsigned long Head;    // blocks completed
+    volatile unsigned long Tail;    // blocks drained or skipped
+    unsigned long Used;             // bytes written to block Head, 0 if not started
+    unsigned long long Time;        // time of the latest event, in units
+    unsigned long long Gap;         // gap before the latest event, in units
+    unsigned long Events;           // events recorded so far
+    volatile unsigned long Dropped; // events refused while full (stop mode)
+    unsigned long Lost;             // blocks overwritten before being drained (wrap mode)
+} Trace;
+
+/** @fn     Trace_Init(Trace *, unsigned char *, unsigned long, int, unsigned long)
+ *  @brief  Starts an empty trace on the given storage.
+ *  @param  Trace to initialize.
+ *  @param  Storage for the blocks.
+ *  @param  Size of the storage in bytes, a power of two of TRACE_BLOCK.
+ *  @param  TRACE_WRAP or TRACE_STOP.
+ *  @param  Time resolution: times are rounded down to 2^shift cycles (0-31).
+ *  @return NULL
+ */
+void Trace_Init(Trace *t, unsigned char *buf, unsigned long size, int mode, unsigned long shift);
+
+/** @fn     Trace_Record(Trace *, unsigned long long, unsigned long)
+ *  @brief  Appends an event. Must only be called from one context, which
+ *          may be an interrupt handler, with times that never go backwards.
+ *  @param  Trace to record into.
+ *  @param  Time of the event in cycles.
+ *  @param  Data of the event. Values below 8 are packed with the time.
+ *  @return 1 if the event was stored, 0 if it was dropped (stop mode, full).
+ */
+int Trace_Record(Trace *t, unsigned long long time, unsigned long data);
+
+/** @fn     Trace_Drain(Trace *, unsigned char *)
+ *  @brief  Moves the oldest completed block out of the trace, while
+ *          recording carries on. Must only be called from one context. In
+ *          wrap mode, blocks the producer overwrote are counted in Lost.
+ *  @param  Trace to drain.
+ *  @param  Where to copy the block, TRACE_BLOCK bytes.
+ *  @return 1 if a block was copied, 0 if none is complete.
+ */
+int Trace_Drain(Trace *t, unsigned char *out);
+
+/** @fn     Trace_Decode(const unsigned char *, Event *, unsigned long)
+ *  @brief  Expands one block back into events with absolute times, in
+ *          cycles rounded down to the trace's resolution. Stops at the end
+ *          of the block or at the first malformed record.
+ *  @param  Block of TRACE_BLOCK bytes.
+ *  @param  Where to write the events.
+ *  @param  Most events to write.
+ *  @return Number of events decoded, 0 for a block that was never written.
+ */
+unsigned long Trace_Decode(const unsigned char *block, Event *out, unsigned long max);
+
+#endif
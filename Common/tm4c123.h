@@ -0,0 +1,225 @@
+/** @file   tm4c123.h
+ *  @brief  Register definitions for the TM4C123GH6PM peripherals used by the
+ *          programs in this repository. Every register goes through HWREG()
+ *          so the same source builds for the LaunchPad or, with HOST_BUILD
+ *          defined, against the emulated registers in HostMMIO.c.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef TM4C123_H
+#define TM4C123_H
+
+/* StartCritical() disables interrupts and returns PRIMASK as it was, and
+   EndCritical() puts it back, so a critical section can be entered from
+   a handler, or with interrupts already disabled, and leave them so. */
+#ifdef HOST_BUILD
+#include "HostMMIO.h"
+
+#define HWREG(addr)             (*Mmio_Reg(addr))
+#define EnableInterrupts()      Mmio_EnableInterrupts()
+#define DisableInterrupts()     Mmio_DisableInterrupts()
+#define StartCritical()         Mmio_StartCritical()
+#define EndCritical(sr)         Mmio_EndCritical(sr)
+#define WaitForInterrupt()      Mmio_WaitForInterrupt()
+#define CPU_CYCLES(n)           Mmio_Advance(n)
+#else
+#define HWREG(addr)             (*((volatile unsigned long *)(addr)))
+#if defined(__CC_ARM)
+#define EnableInterrupts()      __enable_irq()
+#define DisableInterrupts()     __disable_irq()
+#define WaitForInterrupt()      __wfi()
+/* CMSIS's way to PRIMASK with this compiler: a named register variable */
+static __inline unsigned long StartCritical(void) {
+    register unsigned long primask __asm("primask");
+    unsigned long sr = primask;
+    __disable_irq();
+    return sr;
+}
+static __inline void EndCritical(unsigned long sr) {
+    register unsigned long primask __asm("primask");
+    primask = sr;
+}
+#else
+#define EnableInterrupts()      __asm volatile ("cpsie i")
+#define DisableInterrupts()     __asm volatile ("cpsid i")
+#define WaitForInterrupt()      __asm volatile ("wfi")
+static inline unsigned long StartCritical(void) {
+    unsigned long sr;
+    __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (sr) :: "memory");
+    return sr;
+}
+static inline void EndCritical(unsigned long sr) {
+    __asm volatile ("msr primask, %0" :: "r" (sr) : "memory");
+}
+#endif
+// Only the host emulator needs to be told what plain C code costs.
+#define CPU_CYCLES(n)
+#endif
+
+/* GPIO port base addresses, for the pin macros in Pin.h */
+#define GPIO_PORTA_BASE         0x40004000
+#define GPIO_PORTB_BASE         0x40005000
+#define GPIO_PORTC_BASE         0x40006000
+#define GPIO_PORTD_BASE         0x40007000
+#define GPIO_PORTE_BASE         0x40024000
+#define GPIO_PORTF_BASE         0x40025000
+
+/* GPIO register offsets from a port base */
+#define GPIO_O_DATA             0x000003FC
+#define GPIO_O_DIR              0x00000400
+#define GPIO_O_AFSEL            0x00000420
+#define GPIO_O_PUR              0x00000510
+#define GPIO_O_PDR              0x00000514
+#define GPIO_O_DEN              0x0000051C
+#define GPIO_O_LOCK             0x00000520
+#define GPIO_O_CR               0x00000524
+#define GPIO_O_AMSEL            0x00000528
+#define GPIO_O_PCTL             0x0000052C
+
+/* Port B */
+#define GPIO_PORTB_DATA_R       HWREG(0x400053FC)
+#define GPIO_PORTB_DIR_R        HWREG(0x40005400)
+#define GPIO_PORTB_AFSEL_R      HWREG(0x40005420)
+#define GPIO_PORTB_PUR_R        HWREG(0x40005510)
+#define GPIO_PORTB_DEN_R        HWREG(0x4000551C)
+#define GPIO_PORTB_AMSEL_R      HWREG(0x40005528)
+#define GPIO_PORTB_PCTL_R       HWREG(0x4000552C)
+
+/* Port E */
+#define GPIO_PORTE_DATA_R       HWREG(0x400243FC)
+#define GPIO_PORTE_DIR_R        HWREG(0x40024400)
+#define GPIO_PORTE_IS_R         HWREG(0x40024404)
+#define GPIO_PORTE_IBE_R        HWREG(0x40024408)
+#define GPIO_PORTE_IEV_R        HWREG(0x4002440C)
+#define GPIO_PORTE_IM_R         HWREG(0x40024410)
+#define GPIO_PORTE_RIS_R        HWREG(0x40024414)
+#define GPIO_PORTE_MIS_R        HWREG(0x40024418)
+#define GPIO_PORTE_ICR_R        HWREG(0x4002441C)
+#define GPIO_PORTE_AFSEL_R      HWREG(0x40024420)
+#define GPIO_PORTE_PUR_R        HWREG(0x40024510)
+#define GPIO_PORTE_DEN_R        HWREG(0x4002451C)
+#define GPIO_PORTE_AMSEL_R      HWREG(0x40024528)
+#define GPIO_PORTE_PCTL_R       HWREG(0x4002452C)
+
+/* Port F */
+#define GPIO_PORTF_DATA_R       HWREG(0x400253FC)
+#define GPIO_PORTF_DIR_R        HWREG(0x40025400)
+#define GPIO_PORTF_IS_R         HWREG(0x40025404)
+#define GPIO_PORTF_IBE_R        HWREG(0x40025408)
+#define GPIO_PORTF_IEV_R        HWREG(0x4002540C)
+#define GPIO_PORTF_IM_R         HWREG(0x40025410)
+#define GPIO_PORTF_RIS_R        HWREG(0x40025414)
+#define GPIO_PORTF_MIS_R        HWREG(0x40025418)
+#define GPIO_PORTF_ICR_R        HWREG(0x4002541C)
+#define GPIO_PORTF_AFSEL_R      HWREG(0x40025420)
+#define GPIO_PORTF_PUR_R        HWREG(0x40025510)
+#define GPIO_PORTF_DEN_R        HWREG(0x4002551C)
+#define GPIO_PORTF_LOCK_R       HWREG(0x40025520)
+#define GPIO_PORTF_CR_R         HWREG(0x40025524)
+#define GPIO_PORTF_AMSEL_R      HWREG(0x40025528)
+#define GPIO_PORTF_PCTL_R       HWREG(0x4002552C)
+#define GPIO_LOCK_KEY           0x4C4F434B  // unlocks the GPIO_CR register
+
+/* System control */
+#define SYSCTL_RIS_R            HWREG(0x400FE050)
+#define SYSCTL_RIS_PLLLRIS      0x00000040  // PLL Lock Raw Interrupt Status
+#define SYSCTL_MISC_R           HWREG(0x400FE058)
+#define SYSCTL_MISC_PLLLMIS     0x00000040  // PLL Lock Masked Interrupt Status
+#define SYSCTL_RCC_R            HWREG(0x400FE060)
+#define SYSCTL_RCC_SYSDIV_M     0x07800000  // System Clock Divisor
+#define SYSCTL_RCC_USESYSDIV    0x00400000  // Enable System Clock Divider
+#define SYSCTL_RCC_PWRDN        0x00002000  // PLL Power Down
+#define SYSCTL_RCC_BYPASS       0x00000800  // PLL Bypass
+#define SYSCTL_RCC_XTAL_M       0x000007C0  // Crystal Value
+#define SYSCTL_RCC_XTAL_6MHZ    0x000002C0  // 6 MHz Crystal
+#define SYSCTL_RCC_XTAL_8MHZ    0x00000380  // 8 MHz Crystal
+#define SYSCTL_RCC_XTAL_16MHZ   0x00000540  // 16 MHz Crystal
+#define SYSCTL_RCC_OSCSRC_M     0x00000030  // Oscillator Source
+#define SYSCTL_RCC2_R           HWREG(0x400FE070)
+#define SYSCTL_RCC2_USERCC2     0x80000000  // Use RCC2
+#define SYSCTL_RCC2_DIV400      0x40000000  // Divide PLL as 400 MHz vs. 200
+                                            // MHz
+#define SYSCTL_RCC2_SYSDIV2_M   0x1F800000  // System Clock Divisor 2
+#define SYSCTL_RCC2_SYSDIV2LSB  0x00400000  // Additional LSB for SYSDIV2
+#define SYSCTL_RCC2_USBPWRDN    0x00004000  // Power-Down USB PLL
+#define SYSCTL_RCC2_PWRDN2      0x00002000  // Power-Down PLL 2
+#define SYSCTL_RCC2_BYPASS2     0x00000800  // PLL Bypass 2
+#define SYSCTL_RCC2_OSCSRC2_M   0x00000070  // Oscillator Source 2
+#define SYSCTL_RCC2_OSCSRC2_MO  0x00000000  // MOSC
+#define SYSCTL_RCC2_OSCSRC2_IO  0x00000010  // PIOSC
+#define SYSCTL_RCC2_OSCSRC2_IO4 0x00000020  // PIOSC/4
+#define SYSCTL_RCC2_OSCSRC2_30  0x00000030  // LFIOSC
+#define SYSCTL_RCC2_OSCSRC2_32  0x00000070  // 32.768 kHz
+#define SYSCTL_RCGC2_R          HWREG(0x400FE108)
+#define SYSCTL_RCGC2_GPIOF      0x00000020  // port F Clock Gating Control
+#define SYSCTL_RCGC2_GPIOE      0x00000010  // port E Clock Gating Control
+#define SYSCTL_RCGC2_GPIOD      0x00000008  // port D Clock Gating Control
+#define SYSCTL_RCGC2_GPIOC      0x00000004  // port C Clock Gating Control
+#define SYSCTL_RCGC2_GPIOB      0x00000002  // port B Clock Gating Control
+#define SYSCTL_RCGC2_GPIOA      0x00000001  // port A Clock Gating Control
+#define SYSCTL_RCGCTIMER_R      HWREG(0x400FE604)
+#define SYSCTL_RCGCTIMER_R0     0x00000001  // Timer 0 Run Mode Clock Gating
+                                            // Control
+
+/* Timer 0 */
+#define TIMER0_CFG_R            HWREG(0x40030000)
+#define TIMER_CFG_32_BIT_TIMER  0x00000000  // 32-bit timer configuration
+#define TIMER0_TAMR_R           HWREG(0x40030004)
+#define TIMER_TAMR_TAMR_1_SHOT  0x00000001  // One-Shot Timer mode
+#define TIMER_TAMR_TAMR_PERIOD  0x00000002  // Periodic Timer mode
+#define TIMER0_CTL_R            HWREG(0x4003000C)
+#define TIMER_CTL_TAEN          0x00000001  // GPTM Timer A Enable
+#define TIMER0_IMR_R            HWREG(0x40030018)
+#define TIMER_IMR_TATOIM        0x00000001  // GPTM Timer A Time-Out Interrupt
+                                            // Mask
+#define TIMER0_RIS_R            HWREG(0x4003001C)
+#define TIMER0_ICR_R            HWREG(0x40030024)
+#define TIMER_ICR_TATOCINT      0x00000001  // GPTM Timer A Time-Out Raw
+                                            // Interrupt
+#define TIMER0_TAILR_R          HWREG(0x40030028)
+#define TIMER0_TAR_R            HWREG(0x40030048)
+
+/* SysTick */
+#define NVIC_ST_CTRL_R          HWREG(0xE000E010)
+#define NVIC_ST_CTRL_COUNT      0x00010000  // Count Flag
+#define NVIC_ST_CTRL_CLK_SRC    0x00000004  // Clock Source
+#define NVIC_ST_CTRL_INTEN      0x00000002  // Interrupt Enable
+#define NVIC_ST_CTRL_ENABLE     0x00000001  // Enable
+#define NVIC_ST_RELOAD_R        HWREG(0xE000E014)
+#define NVIC_ST_RELOAD_M        0x00FFFFFF  // Reload Value
+#define NVIC_ST_CURRENT_R       HWREG(0xE000E018)
+#define NVIC_INT_CTRL_R         HWREG(0xE000ED04)
+#define NVIC_INT_CTRL_PEND_SV   0x10000000  // Set pending PendSV interrupt
+#define NVIC_INT_CTRL_UNPEND_SV 0x08000000  // Clear pending PendSV interrupt
+#define NVIC_INT_CTRL_PENDSTSET 0x04000000  // Set pending SysTick interrupt
+#define NVIC_INT_CTRL_PENDSTCLR 0x02000000  // Clear pending SysTick interrupt
+#define NVIC_SYS_PRI3_R         HWREG(0xE000ED20)
+#define NVIC_SYS_PRI3_TICK_M    0xE0000000  // SysTick Exception Priority Mask
+#define NVIC_SYS_PRI3_PENDSV_M  0x00E00000  // PendSV Priority Mask
+#define NVIC_SYS_PRI3_PENDSV_S  21
+
+/* Debug: the DWT cycle counter, enabled through DEMCR */
+#define NVIC_DBG_INT_R          HWREG(0xE000EDFC)   // Debug Exception and Monitor Control (DEMCR)
+#define NVIC_DBG_INT_TRCENA     0x01000000  // Enable the DWT and ITM
+#define DWT_CTRL_R              HWREG(0xE0001000)
+#define DWT_CTRL_CYCCNTENA      0x00000001  // Cycle Counter Enable
+#define DWT_CYCCNT_R            HWREG(0xE0001004)
+
+/* NVIC */
+#define NVIC_EN0_R              HWREG(0xE000E100)
+#define NVIC_EN0_INT4           0x00000010  // Interrupt 4 enable (GPIO E)
+#define NVIC_EN0_INT19          0x00080000  // Interrupt 19 enable (Timer 0A)
+#define NVIC_EN0_INT30          0x40000000  // Interrupt 30 enable (GPIO F)
+#define NVIC_DIS0_R             HWREG(0xE000E180)
+#define NVIC_PRI1_R             HWREG(0xE000E404)
+#define NVIC_PRI1_INT4_M        0x000000E0  // Interrupt 4 Priority Mask
+#define NVIC_PRI1_INT4_S        5
+#define NVIC_PRI4_R             HWREG(0xE000E410)
+#define NVIC_PRI4_INT19_M       0xE0000000  // Interrupt 19 Priority Mask
+#define NVIC_PRI4_INT19_S       29
+#define NVIC_PRI7_R             HWREG(0xE000E41C)
+#define NVIC_PRI7_INT30_M       0x00E00000  // Interrupt 30 Priority Mask
+#define NVIC_PRI7_INT30_S       21
+
+#endif
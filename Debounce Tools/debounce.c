@@ -0,0 +1,261 @@
+/** @file   debounce.c
+ *  @brief  Host-side check and benchmark of the vertical-counter debouncer
+ *          in Common/Debounce.c. By default it feeds the debouncer 32
+ *          inputs of synthetic switch waveforms, with contact bounce after
+ *          every change and short glitches in between, and checks that
+ *          every change comes out exactly once, in the right direction and
+ *          within DEBOUNCE_SAMPLES samples of the bounce settling, and that
+ *          no glitch gets through. With -b it measures the cost of a sample
+ *          for 8 and 32 inputs against one counter per pin.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TSC() __rdtsc()
+#endif
+#include "Debounce.h"
+
+#define PINS            32
+#define CHECK_SAMPLES   2000000UL
+#define BENCH_SAMPLES   20000000UL
+#define MAX_BOUNCE      12          // samples of bounce after a change
+#define QUIET           8           // samples without glitches around a change
+#define GLITCH_ODDS     200         // one sample in this many starts a glitch
+#define INVERT          0x55555555UL    // every other input active low
+
+/* Cheap deterministic random numbers */
+static unsigned long Seed = 1;
+static unsigned long rnd(void) {
+    Seed = Seed * 1103515245UL + 12345UL;
+    return (Seed >> 16) & 0x7FFF;
+}
+
+/* One input: the level the switch is really at, and what the pin shows */
+typedef struct {
+    unsigned long Level;            // true level
+    unsigned long Out;              // level on the pin
+    unsigned long long Next;        // sample of the next change
+    unsigned long long Settle;      // first sample after the latest bounce
+    unsigned long Run;              // samples left in the current bounce run or glitch
+    int Pending;                    // latest change not reported yet
+} Pin;
+
+/* Level of the pin for sample s. Bounce and glitches come in runs of 1 to
+   DEBOUNCE_SAMPLES - 1 samples, so none of them is a change. */
+static unsigned long waveform(Pin *p, unsigned long long s, unsigned long *missed) {
+    if (s == p->Next) {
+        if (p->Pending) {
+            (*missed)++;
+        }
+        p->Level ^= 1;
+        p->Settle = s + rnd() % (MAX_BOUNCE + 1);
+        p->Next = p->Settle + 2 * QUIET + DEBOUNCE_SAMPLES + rnd() % 400;
+        p->Pending = 1;
+        p->Out = p->Level;          // first contact
+        p->Run = 1 + rnd() % (DEBOUNCE_SAMPLES - 1);
+    }
+    if (s == p->Settle) {
+        p->Run = 0;                 // bounce over
+    }
+    if (s < p->Settle) {
+        if (!p->Run) {
+            p->Out ^= 1;            // bounce
+            p->Run = 1 + rnd() % (DEBOUNCE_SAMPLES - 1);
+        }
+        p->Run--;
+        return p->Out;
+    }
+    if (p->Run) {
+        p->Run--;                   // in a glitch
+        return p->Out;
+    }
+    if (p->Out != p->Level) {
+        p->Out = p->Level;          // glitches are apart
+        return p->Out;
+    }
+    if (s >= p->Settle + QUIET && s + QUIET + DEBOUNCE_SAMPLES < p->Next &&
+        rnd() % GLITCH_ODDS == 0) {
+        p->Out ^= 1;
+        p->Run = rnd() % (DEBOUNCE_SAMPLES - 1);
+    }
+    return p->Out;
+}
+
+static unsigned long popcount(unsigned long v) {
+    unsigned long n = 0;
+    while (v) {
+        v &= v - 1;
+        n++;
+    }
+    return n;
+}
+
+static int check(unsigned long long samples) {
+    static Pin pins[PINS];
+    Debouncer d;
+    unsigned long long s, latency, worst = 0;
+    unsigned long word, prev = 0, toggle, pressed, released;
+    unsigned long changes = 0, presses = 0, releases = 0, missed = 0, wrong = 0, late = 0;
+    unsigned long long raw = 0;
+    int i;
+    for (i = 0; i < PINS; i++) {
+        pins[i].Level = pins[i].Out = rnd() & 1;
+        pins[i].Next = rnd() % 400;
+        pins[i].Settle = 0;
+        pins[i].Run = 0;
+        pins[i].Pending = 0;
+        prev |= pins[i].Level << i;
+    }
+    Debounce_Init(&d, INVERT, prev);
+    for (s = 0; s < samples; s++) {
+        word = 0;
+        for (i = 0; i < PINS; i++) {
+            unsigned long long next = pins[i].Next;
+            word |= waveform(&pins[i], s, &missed) << i;
+            changes += s == next;
+        }
+        raw += popcount(word ^ prev);
+        prev = word;
+        toggle = Debounce_Step(&d, word);
+        pressed = d.Pressed;
+        released = d.Released;
+        d.Pressed = d.Released = 0;
+        presses += popcount(pressed);
+        releases += popcount(released);
+        for (i = 0; toggle >> i; i++) {
+            Pin *p = &pins[i];
+            if (!((toggle >> i) & 1)) {
+                continue;
+            }
+            // the state must now be the true level, and only once per change
+            if (!p->Pending || ((d.State >> i) & 1) != (p->Level ^ ((INVERT >> i) & 1)) ||
+                ((pressed >> i) & 1) != ((d.State >> i) & 1)) {
+                wrong++;
+                continue;
+            }
+            p->Pending = 0;
+            latency = s >= p->Settle ? s - p->Settle + 1 : 0;
+            if (latency > worst) {
+                worst = latency;
+            }
+            if (latency > DEBOUNCE_SAMPLES) {
+                late++;
+            }
+        }
+    }
+    for (i = 0; i < PINS; i++) {
+        if (pins[i].Pending && samples - pins[i].Settle > DEBOUNCE_SAMPLES) {
+            missed++;
+        }
+    }
+    printf("samples %llu\n", samples);
+    printf("inputs %d\n", PINS);
+    printf("changes %lu\n", changes);
+    printf("raw_edges %llu\n", raw);
+    printf("presses %lu\n", presses);
+    printf("releases %lu\n", releases);
+    printf("missed %lu\n", missed);
+    printf("spurious %lu\n", wrong);
+    printf("late %lu\n", late);
+    printf("worst_latency_samples %llu\n", worst);
+    return missed || wrong || late;
+}
+
+static double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Keeps the loops from being optimized away */
+static volatile unsigned long Sink;
+
+/* The usual alternative: a counter per pin, reset when the pin agrees
+   with its state */
+static unsigned long State, Counts[PINS];
+static unsigned long per_pin(unsigned long sample, int pins) {
+    unsigned long toggle = 0;
+    int i;
+    for (i = 0; i < pins; i++) {
+        if (((sample ^ State) >> i) & 1) {
+            if (++Counts[i] == DEBOUNCE_SAMPLES) {
+                Counts[i] = 0;
+                toggle |= 1UL << i;
+            }
+        } else {
+            Counts[i] = 0;
+        }
+    }
+    State ^= toggle;
+    return toggle;
+}
+
+static void report(const char *name, int pins, double secs, unsigned long long ticks, unsigned long n) {
+    printf("%s_%d_ns_per_sample %.2f\n", name, pins, secs * 1e9 / n);
+    if (ticks) {
+        printf("%s_%d_tsc_per_sample %.2f\n", name, pins, (double)ticks / n);
+    }
+}
+
+static int bench(unsigned long n) {
+    unsigned long *in = malloc(n * sizeof(unsigned long));
+    unsigned long i;
+    int widths[2] = {8, 32}, w;
+    Debouncer d;
+    double t0;
+    unsigned long long ticks = 0;
+#ifdef TSC
+    unsigned long long c0;
+#endif
+    for (i = 0; i < n; i++) {
+        in[i] = (rnd() << 17) ^ (rnd() << 2) ^ rnd();  // bouncing all the time
+    }
+    printf("samples %lu\n", n);
+    for (w = 0; w < 2; w++) {
+        unsigned long mask = widths[w] == 32 ? 0xFFFFFFFFUL : 0xFFUL;
+        Debounce_Init(&d, 0, 0);
+        t0 = seconds();
+#ifdef TSC
+        c0 = TSC();
+#endif
+        for (i = 0; i < n; i++) {
+            Sink = Debounce_Step(&d, in[i] & mask);
+        }
+#ifdef TSC
+        ticks = TSC() - c0;
+#endif
+        report("vertical", widths[w], seconds() - t0, ticks, n);
+        State = 0;
+        memset(Counts, 0, sizeof(Counts));
+        t0 = seconds();
+#ifdef TSC
+        c0 = TSC();
+#endif
+        for (i = 0; i < n; i++) {
+            Sink = per_pin(in[i] & mask, widths[w]);
+        }
+#ifdef TSC
+        ticks = TSC() - c0;
+#endif
+        report("per_pin", widths[w], seconds() - t0, ticks, n);
+    }
+    free(in);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 2 && !strcmp(argv[1], "-b")) {
+        return bench(argc >= 3 ? strtoul(argv[2], 0, 0) : BENCH_SAMPLES);
+    }
+    if (argc > 2 || (argc == 2 && argv[1][0] == '-')) {
+        fprintf(stderr, "usage: %s [samples]\n       %s -b [samples]\n", argv[0], argv[0]);
+        return 2;
+    }
+    return check(argc == 2 ? strtoull(argv[1], 0, 0) : CHECK_SAMPLES);
+}
@@ -0,0 +1,196 @@
+/** @file   arcs.c
+ *  @brief  Host-side check and benchmark of the compressed transitions in
+ *          Common/Fsm.c. It checks that the traffic light's table of
+ *          defaults and arcs gives the same next state as the full table it
+ *          replaced, for every state and sensor input, and does the same
+ *          for random controllers with 8 and 16 sensors against their full
+ *          tables. For those it prints the bytes of both, the most arcs a
+ *          step looks at, and the steps per second of both.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Fsm.h"
+#include "../Traffic Light Simulator/Lights.h"
+
+#define STATES          64
+#define MAX_ARCS        6           // per random state
+#define STEPS           50000000UL
+#define INPUTS_LOG2     20
+
+/* The traffic light's full table, as it was */
+static const unsigned long Full4[4][4] = {
+    {goN, waitN, goN, waitN},
+    {goE, goE, goE, goE},
+    {goE, goE, waitE, waitE},
+    {goN, goN, goN, goN}
+};
+
+static FsmState States[STATES];
+static FsmArc RandArcs[STATES * MAX_ARCS];
+static unsigned char FullTable[STATES << 16];
+static unsigned short Inputs[1 << INPUTS_LOG2];
+static unsigned long NumArcs, Errors;
+
+/* Cheap deterministic random numbers */
+static unsigned long Seed = 1;
+static unsigned long rnd(void) {
+    Seed = Seed * 1103515245UL + 12345UL;
+    return (Seed >> 16) & 0x7FFF;
+}
+
+static double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Random states with up to MAX_ARCS arcs each, looking at 1 to 3 of the
+   sensors like a phase that waits for a car or a button */
+static void build(unsigned long sensors) {
+    unsigned long s, i, k, m;
+    NumArcs = 0;
+    for (s = 0; s < STATES; s++) {
+        States[s].Time = rnd() % 3001;
+        States[s].Out = rnd() & 0x3F;
+        States[s].Default = rnd() % STATES;
+        States[s].First = NumArcs;
+        States[s].Count = rnd() % (MAX_ARCS + 1);
+        for (i = 0; i < States[s].Count; i++) {
+            FsmArc *a = &RandArcs[NumArcs++];
+            a->Mask = 0;
+            for (k = 1 + rnd() % 3; k; k--) {
+                a->Mask |= 1 << (rnd() % sensors);
+            }
+            m = rnd() << 1 | (rnd() & 1);
+            a->Value = m & a->Mask;
+            a->Next = rnd() % STATES;
+        }
+    }
+}
+
+/* The full table the arcs stand for: the first arc that matches */
+static void expand(unsigned long sensors) {
+    unsigned long s, in, i;
+    for (s = 0; s < STATES; s++) {
+        for (in = 0; in < (1UL << sensors); in++) {
+            unsigned long next = States[s].Default;
+            for (i = States[s].First + States[s].Count; i-- > States[s].First; ) {
+                if ((in & RandArcs[i].Mask) == RandArcs[i].Value) {
+                    next = RandArcs[i].Next;    // the last match seen is the first arc
+                }
+            }
+            FullTable[s << sensors | in] = (unsigned char)next;
+        }
+    }
+}
+
+/* The lab's tables in Lights.c: the arcs against the full table, and
+   the index the lab steps with against the arcs */
+static void check4(void) {
+    unsigned long s, in, i, st;
+    unsigned int x = 1;
+    unsigned long long sum = 0;
+    double t, indexed, arcs;
+    if (!Fsm_Check(FSM, LIGHTS_STATES, Arcs, LIGHTS_ARCS)) {
+        printf("traffic light table does not hold together\n");
+        Errors++;
+    }
+    for (s = 0; s < LIGHTS_STATES; s++) {
+        for (in = 0; in < 4; in++) {
+            if (Fsm_Next(FSM, Arcs, s, in) != Full4[s][in]) {
+                printf("traffic light state %lu input %lu: %lu, expected %lu\n",
+                       s, in, Fsm_Next(FSM, Arcs, s, in), Full4[s][in]);
+                Errors++;
+            }
+        }
+    }
+    if (!Fsm_CheckIndex(FSM, Arcs, LIGHTS_STATES, Index, LIGHTS_SENSORS)) {
+        printf("traffic light index does not match the arcs\n");
+        Errors++;
+    }
+    for (i = 0; i < (1UL << INPUTS_LOG2); i++) {
+        x ^= x << 13;                   // xorshift, leaving rnd() to the random controllers
+        x ^= x >> 17;
+        x ^= x << 5;
+        Inputs[i] = x & 3;
+    }
+    st = goN;
+    t = seconds();
+    for (i = 0; i < STEPS; i++) {
+        st = FSM_INDEXED(Index, LIGHTS_SENSORS, st, Inputs[i & ((1 << INPUTS_LOG2) - 1)]);
+        sum += st;
+    }
+    indexed = STEPS / (seconds() - t);
+    st = goN;
+    t = seconds();
+    for (i = 0; i < STEPS; i++) {
+        st = Fsm_Next(FSM, Arcs, st, Inputs[i & ((1 << INPUTS_LOG2) - 1)]);
+        sum -= st;
+    }
+    arcs = STEPS / (seconds() - t);
+    if (sum) {
+        printf("traffic light: indexed and compressed runs differ\n");
+        Errors++;
+    }
+    printf("traffic_light_bytes %lu, was %lu, index %lu, %.1f M steps/s indexed, %.1f M compressed\n",
+           (unsigned long)(sizeof(FSM) + sizeof(Arcs)), 4UL * 8, (unsigned long)sizeof(Index),
+           indexed / 1e6, arcs / 1e6);
+}
+
+static void random_controller(unsigned long sensors) {
+    unsigned long s, in, i, mask = (1UL << sensors) - 1, worst = 0, st;
+    unsigned long long sum = 0;
+    double t, full, arcs;
+    build(sensors);
+    expand(sensors);
+    if (!Fsm_Check(States, STATES, RandArcs, NumArcs)) {
+        printf("%lu sensors: tables do not hold together\n", sensors);
+        Errors++;
+    }
+    for (s = 0; s < STATES; s++) {
+        worst = States[s].Count > worst ? States[s].Count : worst;
+        for (in = 0; in <= mask; in++) {
+            if (Fsm_Next(States, RandArcs, s, in) != FullTable[s << sensors | in]) {
+                Errors++;
+            }
+        }
+    }
+    for (i = 0; i < (1UL << INPUTS_LOG2); i++) {
+        Inputs[i] = (rnd() << 1 | (rnd() & 1)) & mask;
+    }
+    st = 0;
+    t = seconds();
+    for (i = 0; i < STEPS; i++) {
+        st = FullTable[st << sensors | Inputs[i & ((1 << INPUTS_LOG2) - 1)]];
+        sum += st;
+    }
+    full = STEPS / (seconds() - t);
+    st = 0;
+    t = seconds();
+    for (i = 0; i < STEPS; i++) {
+        st = Fsm_Next(States, RandArcs, st, Inputs[i & ((1 << INPUTS_LOG2) - 1)]);
+        sum -= st;
+    }
+    arcs = STEPS / (seconds() - t);
+    if (sum) {
+        printf("%lu sensors: full and compressed runs differ\n", sensors);
+        Errors++;
+    }
+    printf("%2lu sensors %lu states: full %lu bytes, compressed %lu bytes (%lu arcs), "
+           "at most %lu arcs a step, %.1f M steps/s full, %.1f M compressed\n",
+           sensors, (unsigned long)STATES, (unsigned long)STATES * ((1UL << sensors) + 3),
+           (unsigned long)(STATES * sizeof(FsmState) + NumArcs * sizeof(FsmArc)), NumArcs,
+           worst, full / 1e6, arcs / 1e6);
+}
+
+int main(void) {
+    check4();
+    random_controller(8);
+    random_controller(16);
+    printf("errors %lu\n", Errors);
+    return Errors != 0;
+}
@@ -0,0 +1,294 @@
+/** @file   batch.c
+ *  @brief  Batch simulator of many traffic light controllers on the host,
+ *          for sizing a deployment. Every instance runs the FSM[] of the
+ *          Traffic Light Simulator on a random sensor trace of its own.
+ *          A step reads the sensors, takes the transition and adds the new
+ *          state's time to the instance's clock, as the controller does.
+ *
+ *          The instances are kept as arrays of states, clocks and random
+ *          number states, one entry each, so 8 of them fit a 256-bit
+ *          register. With AVX2, a step of 8 instances is a xorshift for
+ *          their sensors, a gather of their next states from the table
+ *          expanded with Fsm_Next(), a gather of the times, and a compare
+ *          to count the state changes. Without AVX2, the same step runs one
+ *          instance at a time and gives the same results. The instances
+ *          are split into one contiguous part per thread, and each thread
+ *          takes its part in blocks that stay in the L1 cache for all the
+ *          steps.
+ *
+ *          By default it checks that both kernels and any number of threads
+ *          give the same states, clocks and changes, then prints the
+ *          transitions per second for a range of instance and thread
+ *          counts. With arguments it runs one: instances, steps, threads.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include "Fsm.h"
+#include "../Traffic Light Simulator/Lights.h"
+
+#define MAX_THREADS     64
+#define BLOCK           2048        // instances a thread steps together: 24 KB
+#define INPUTS          4
+
+/* The table expanded for gathers: next state by state * INPUTS + input,
+   and time by state */
+static int Next[4 * INPUTS];
+static int Time[4];
+
+/* The instances */
+typedef struct {
+    unsigned int *State;
+    unsigned int *Clock;            // 10 ms units since the start
+    unsigned int *Rng;              // xorshift32 state, never 0
+    unsigned long Count;
+} Batch;
+
+typedef struct {
+    Batch *b;
+    unsigned long Lo, Hi;
+    unsigned long Steps;
+    int Avx2;
+    unsigned long long Changes;
+    pthread_t Thread;
+} Part;
+
+static unsigned long Errors;
+
+static double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void expand(void) {
+    unsigned long s, in;
+    for (s = 0; s < 4; s++) {
+        Time[s] = FSM[s].Time;
+        for (in = 0; in < INPUTS; in++) {
+            Next[s * INPUTS + in] = (int)Fsm_Next(FSM, Arcs, s, in);
+        }
+    }
+}
+
+static void batch_init(Batch *b, unsigned long count) {
+    unsigned long i;
+    b->Count = count;
+    b->State = aligned_alloc(32, (count * 4 + 31) & ~31UL);
+    b->Clock = aligned_alloc(32, (count * 4 + 31) & ~31UL);
+    b->Rng = aligned_alloc(32, (count * 4 + 31) & ~31UL);
+    if (!b->State || !b->Clock || !b->Rng) {
+        fprintf(stderr, "out of memory for %lu instances\n", count);
+        exit(2);
+    }
+    for (i = 0; i < count; i++) {
+        b->State[i] = goN;
+        b->Clock[i] = 0;
+        b->Rng[i] = (unsigned int)(i * 2654435761UL + 1) | 1;
+    }
+}
+
+static void batch_free(Batch *b) {
+    free(b->State);
+    free(b->Clock);
+    free(b->Rng);
+}
+
+/* One instance at a time */
+static unsigned long long scalar(Batch *b, unsigned long lo, unsigned long hi, unsigned long steps) {
+    unsigned long i, n;
+    unsigned long long changes = 0;
+    for (i = lo; i < hi; i++) {
+        unsigned int s = b->State[i], clock = b->Clock[i], r = b->Rng[i], next;
+        for (n = 0; n < steps; n++) {
+            r ^= r << 13;
+            r ^= r >> 17;
+            r ^= r << 5;
+            next = (unsigned int)Next[s * INPUTS + (r >> 30)];
+            changes += next != s;
+            s = next;
+            clock += (unsigned int)Time[s];
+        }
+        b->State[i] = s;
+        b->Clock[i] = clock;
+        b->Rng[i] = r;
+    }
+    return changes;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/* Eight instances at a time; lo and hi are multiples of 8 */
+__attribute__((target("avx2")))
+static unsigned long long avx2(Batch *b, unsigned long lo, unsigned long hi, unsigned long steps) {
+    unsigned long i, n;
+    unsigned long long changes = 0;
+    for (i = lo; i < hi; i += 8) {
+        __m256i s = _mm256_load_si256((const __m256i *)&b->State[i]);
+        __m256i clock = _mm256_load_si256((const __m256i *)&b->Clock[i]);
+        __m256i r = _mm256_load_si256((const __m256i *)&b->Rng[i]);
+        __m256i same = _mm256_setzero_si256();      // lanes' steps without a change, negated
+        for (n = 0; n < steps; n++) {
+            __m256i next, idx;
+            r = _mm256_xor_si256(r, _mm256_slli_epi32(r, 13));
+            r = _mm256_xor_si256(r, _mm256_srli_epi32(r, 17));
+            r = _mm256_xor_si256(r, _mm256_slli_epi32(r, 5));
+            idx = _mm256_add_epi32(_mm256_slli_epi32(s, 2), _mm256_srli_epi32(r, 30));
+            next = _mm256_i32gather_epi32(Next, idx, 4);
+            same = _mm256_add_epi32(same, _mm256_cmpeq_epi32(next, s));
+            s = next;
+            clock = _mm256_add_epi32(clock, _mm256_i32gather_epi32(Time, s, 4));
+        }
+        _mm256_store_si256((__m256i *)&b->State[i], s);
+        _mm256_store_si256((__m256i *)&b->Clock[i], clock);
+        _mm256_store_si256((__m256i *)&b->Rng[i], r);
+        {
+            int lanes[8], k;
+            _mm256_storeu_si256((__m256i *)lanes, same);
+            for (k = 0; k < 8; k++) {
+                changes += steps + lanes[k];        // each equal step added -1
+            }
+        }
+    }
+    return changes;
+}
+#endif
+
+/* A thread's part, block by block; AVX2 takes the whole groups of 8 */
+static void *run_part(void *arg) {
+    Part *p = arg;
+    unsigned long lo, hi, mid;
+    for (lo = p->Lo; lo < p->Hi; lo = hi) {
+        hi = lo + BLOCK < p->Hi ? lo + BLOCK : p->Hi;
+        mid = lo;
+#if defined(__x86_64__) || defined(__i386__)
+        if (p->Avx2) {
+            mid = lo + ((hi - lo) & ~7UL);
+            p->Changes += avx2(p->b, lo, mid, p->Steps);
+        }
+#endif
+        p->Changes += scalar(p->b, mid, hi, p->Steps);
+    }
+    return 0;
+}
+
+/* Steps every instance; returns the state changes */
+static unsigned long long run(Batch *b, unsigned long steps, unsigned long threads, int useAvx2) {
+    static Part parts[MAX_THREADS];
+    unsigned long t, per = ((b->Count + threads - 1) / threads + 7) & ~7UL;
+    unsigned long long changes = 0;
+    for (t = 0; t < threads; t++) {
+        parts[t].b = b;
+        parts[t].Lo = t * per < b->Count ? t * per : b->Count;
+        parts[t].Hi = (t + 1) * per < b->Count ? (t + 1) * per : b->Count;
+        parts[t].Steps = steps;
+        parts[t].Avx2 = useAvx2;
+        parts[t].Changes = 0;
+        if (t && pthread_create(&parts[t].Thread, 0, run_part, &parts[t])) {
+            fprintf(stderr, "cannot start thread %lu\n", t);
+            exit(2);
+        }
+    }
+    run_part(&parts[0]);
+    for (t = 0; t < threads; t++) {
+        if (t) {
+            pthread_join(parts[t].Thread, 0);
+        }
+        changes += parts[t].Changes;
+    }
+    return changes;
+}
+
+static int have_avx2(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#else
+    return 0;
+#endif
+}
+
+/* Both kernels and several thread counts must agree exactly */
+static void check(int avx) {
+    static const unsigned long threads[] = {1, 3, 8};
+    Batch ref, b;
+    unsigned long long want, got;
+    unsigned long i, k;
+    batch_init(&ref, 10007);                // not a multiple of 8 or of BLOCK
+    want = run(&ref, 1000, 1, 0);
+    for (k = 0; k < sizeof(threads) / sizeof(threads[0]); k++) {
+        batch_init(&b, 10007);
+        got = run(&b, 1000, threads[k], avx);
+        if (got != want || memcmp(b.State, ref.State, 10007 * 4) ||
+            memcmp(b.Clock, ref.Clock, 10007 * 4) || memcmp(b.Rng, ref.Rng, 10007 * 4)) {
+            printf("%s with %lu threads differs from scalar\n", avx ? "avx2" : "scalar", threads[k]);
+            Errors++;
+        }
+        batch_free(&b);
+    }
+    // each instance went through states the controller can reach, with their times
+    for (i = 0; i < ref.Count; i++) {
+        if (ref.State[i] > waitE || ref.Clock[i] < 500 * 1000 || ref.Clock[i] > 3000 * 1000) {
+            Errors++;
+        }
+    }
+    printf("changes %llu of %lu steps\n", want, ref.Count * 1000);
+    batch_free(&ref);
+}
+
+static double measure(unsigned long instances, unsigned long steps, unsigned long threads, int avx) {
+    Batch b;
+    double t;
+    batch_init(&b, instances);
+    t = seconds();
+    run(&b, steps, threads, avx);
+    t = seconds() - t;
+    batch_free(&b);
+    return (double)instances * steps / t;
+}
+
+int main(int argc, char **argv) {
+    static const unsigned long sizes[] = {1024, 65536, 1048576, 16777216};
+    unsigned long cores = (unsigned long)sysconf(_SC_NPROCESSORS_ONLN), i, t;
+    int avx = have_avx2();
+    expand();
+    if (argc == 4) {
+        unsigned long n = strtoul(argv[1], 0, 0), steps = strtoul(argv[2], 0, 0);
+        t = strtoul(argv[3], 0, 0);
+        if (!n || !t || t > MAX_THREADS) {
+            fprintf(stderr, "usage: %s [instances steps threads]\n", argv[0]);
+            return 2;
+        }
+        printf("%lu instances %lu threads %s: %.1f M transitions/s\n", n, t, avx ? "avx2" : "scalar",
+               measure(n, steps, t, avx) / 1e6);
+        return 0;
+    }
+    check(0);
+    if (avx) {
+        check(1);
+    }
+    printf("errors %lu\n", Errors);
+    if (Errors) {
+        return 1;
+    }
+    printf("cores %lu, avx2 %s\n", cores, avx ? "yes" : "no");
+    for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        unsigned long steps = 268435456UL / sizes[i];
+        printf("%8lu instances: scalar %.1f M/s", sizes[i], measure(sizes[i], steps, 1, 0) / 1e6);
+        for (t = 1; t <= cores && t <= MAX_THREADS; t *= 2) {
+            if (avx) {
+                printf(", avx2 %lu thread%s %.1f M/s", t, t > 1 ? "s" : "", measure(sizes[i], steps, t, 1) / 1e6);
+            }
+        }
+        printf("\n");
+    }
+    return 0;
+}
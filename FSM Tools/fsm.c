@@ -0,0 +1,145 @@
+/** @file   fsm.c
+ *  @brief  Host-side check and benchmark of the packed FSM tables of the
+ *          traffic light, against the layout they replaced. A state used
+ *          to take 24 bytes of RAM: Out, Time and Next[4] as unsigned long.
+ *          Packed, it takes 8 bytes of flash, with byte next states, or 12
+ *          with 16-bit next states beyond 256 states. For random tables of
+ *          4 to 4096 states, it checks that every layout goes through the
+ *          same states for the same inputs, and prints the steps per second
+ *          and bytes per state of each.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define MAX_STATES      4096
+#define INPUTS_LOG2     20          // a million random inputs, used over and over
+#define STEPS           100000000UL
+
+/* The layout before, with the 32-bit unsigned long of the LaunchPad */
+typedef struct {
+    unsigned int Out;
+    unsigned int Time;
+    unsigned int Next[4];
+} Wide;
+
+/* Packed, up to 256 states */
+typedef struct {
+    unsigned short Time;
+    unsigned char Out;
+    unsigned char Next[4];
+} Packed8;
+
+/* Packed, up to 65536 states */
+typedef struct {
+    unsigned short Time;
+    unsigned char Out;
+    unsigned short Next[4];
+} Packed16;
+
+static Wide WideFsm[MAX_STATES];
+static Packed8 Fsm8[256];
+static Packed16 Fsm16[MAX_STATES];
+static unsigned char Inputs[1 << INPUTS_LOG2];
+static unsigned long Errors;
+
+/* Cheap deterministic random numbers */
+static unsigned long Seed = 1;
+static unsigned long rnd(void) {
+    Seed = Seed * 1103515245UL + 12345UL;
+    return (Seed >> 16) & 0x7FFF;
+}
+
+static double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* The same random table in each layout */
+static void build(unsigned long states) {
+    unsigned long s, i;
+    for (s = 0; s < states; s++) {
+        WideFsm[s].Out = rnd() & 0x3F;
+        WideFsm[s].Time = rnd() % 3001;
+        for (i = 0; i < 4; i++) {
+            WideFsm[s].Next[i] = (rnd() << 15 | rnd()) % states;
+        }
+        Fsm16[s].Out = (unsigned char)WideFsm[s].Out;
+        Fsm16[s].Time = (unsigned short)WideFsm[s].Time;
+        for (i = 0; i < 4; i++) {
+            Fsm16[s].Next[i] = (unsigned short)WideFsm[s].Next[i];
+        }
+        if (states <= 256) {
+            Fsm8[s].Out = (unsigned char)WideFsm[s].Out;
+            Fsm8[s].Time = (unsigned short)WideFsm[s].Time;
+            for (i = 0; i < 4; i++) {
+                Fsm8[s].Next[i] = (unsigned char)WideFsm[s].Next[i];
+            }
+        }
+    }
+}
+
+/* Each step reads the lights and the time too, as the controller does */
+#define RUN(table, steps, sum) do {                                     \
+        unsigned long n_, s_ = 0;                                       \
+        for (n_ = 0; n_ < (steps); n_++) {                              \
+            (sum) += (table)[s_].Out + (table)[s_].Time;                \
+            s_ = (table)[s_].Next[Inputs[n_ & ((1 << INPUTS_LOG2) - 1)]]; \
+        }                                                               \
+        (sum) += s_;                                                    \
+    } while (0)
+
+static void check(unsigned long states) {
+    unsigned long long wide = 0, p8 = 0, p16 = 0;
+    RUN(WideFsm, 1000000UL, wide);
+    RUN(Fsm16, 1000000UL, p16);
+    if (states <= 256) {
+        RUN(Fsm8, 1000000UL, p8);
+    } else {
+        p8 = wide;
+    }
+    if (wide != p16 || wide != p8) {
+        printf("%lu states: layouts disagree\n", states);
+        Errors++;
+    }
+}
+
+static void bench(const char *layout, unsigned long states, unsigned long bytes, double took,
+                  unsigned long long sum) {
+    printf("%-8s %5lu states %2lu bytes/state %6lu bytes %7.1f M steps/s (%llu)\n",
+           layout, states, bytes, bytes * states, STEPS / took / 1e6, sum & 0xF);
+}
+
+int main(void) {
+    static const unsigned long sizes[] = {4, 16, 256, 1024, 4096};
+    unsigned long i, k;
+    unsigned long long sum;
+    double t;
+    for (i = 0; i < (1UL << INPUTS_LOG2); i++) {
+        Inputs[i] = rnd() & 3;
+    }
+    for (k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+        build(sizes[k]);
+        check(sizes[k]);
+        sum = 0;
+        t = seconds();
+        RUN(WideFsm, STEPS, sum);
+        bench("wide", sizes[k], sizeof(Wide), seconds() - t, sum);
+        if (sizes[k] <= 256) {
+            sum = 0;
+            t = seconds();
+            RUN(Fsm8, STEPS, sum);
+            bench("packed8", sizes[k], sizeof(Packed8), seconds() - t, sum);
+        }
+        sum = 0;
+        t = seconds();
+        RUN(Fsm16, STEPS, sum);
+        bench("packed16", sizes[k], sizeof(Packed16), seconds() - t, sum);
+    }
+    printf("errors %lu\n", Errors);
+    return Errors != 0;
+}
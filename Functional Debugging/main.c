@@ -3,38 +3,41 @@
  *          at 10 Hz when either of the two switches are pressed. The
  *          main purpose of writing this program was to learn functional
  *          debugging and learn how to record data. The program dumps 
- *          recorded I/O data into a buffer. The data includes the time
- *          between when the switches are pressed or when the LED turns
- *          on/off. The time elapsed is calculated by using the SysTick
- *          timer present in all Cortex M microcontrollers.
+ *          recorded I/O data into a compressed ring buffer. The data includes the time
+ *          when the switches are pressed or when the LED turns on/off. The
+ *          time is read from the SysTick timer present in all Cortex M
+ *          microcontrollers.
  *          NOTE: Functions for Port F and SysTick initialization were
  *          provided as part of the lab.
  *  @author Mustafa Siddiqui, and Jon Valvano & Ramesh Yerraballi (instructors)
  *  @date   07/12/2020
  */
 
+#include "../Common/tm4c123.h"
+#include "../SysTick Timer/SysTick.h"
+#include "../SysTick Timer/Delay.h"
+#include "../Common/Trace.h"
+#include "../Common/Clock.h"
+#include "../Common/Debounce.h"
+#include "../Common/Pin.h"
+#include "../Common/Gpio.h"
+#include "../Common/Profile.h"
+#ifdef HOST_BUILD
+#include <stdio.h>
+#endif
+
 /* Global Variables */
-// first data point is wrong, the other 49 will be correct
-unsigned long Time[50];
-unsigned long Data[50];
+// the latest ~850 changes in the same 1 KB that held 64 Events, times
+// in units of 256 cycles (16 us) since SysTick_Init()
+unsigned char Log[1024];
+Trace Blackbox;
 unsigned long Led;
 
-/* Define ports */
-#define GPIO_PORTF_DATA_R       (*((volatile unsigned long*) 0x400253FC))
-#define GPIO_PORTF_DIR_R        (*((volatile unsigned long*) 0x40025400))
-#define GPIO_PORTF_AFSEL_R      (*((volatile unsigned long*) 0x40025420))
-#define GPIO_PORTF_PUR_R        (*((volatile unsigned long*) 0x40025510))
-#define GPIO_PORTF_DEN_R        (*((volatile unsigned long*) 0x4002551C))
-#define GPIO_PORTF_LOCK_R       (*((volatile unsigned long*) 0x40025520))
-#define GPIO_PORTF_CR_R         (*((volatile unsigned long*) 0x40025524))
-#define GPIO_PORTF_AMSEL_R      (*((volatile unsigned long*) 0x40025528))
-#define GPIO_PORTF_PCTL_R       (*((volatile unsigned long*) 0x4002552C))
-#define SYSCTL_RCGC2_R          (*((volatile unsigned long*) 0x400FE108))
+/* PF4 and PF0 through their bit-specific address, sampled every 2 ms */
+const unsigned long Switches[1] = {PIN_ADDR(GPIO_PORTF_BASE, 0x11)};
 
-/* Define SysTick registers */
-#define NVIC_ST_CTRL_R          (*((volatile unsigned long*) 0xE000E010))
-#define NVIC_ST_RELOAD_R        (*((volatile unsigned long*) 0xE000E014))
-#define NVIC_ST_CURRENT_R       (*((volatile unsigned long*) 0xE000E018))
+/* Profiled regions, when built with PROFILE */
+enum {PROF_PORTF_INIT, PROF_LOOP};
 
 /** @fn     PortF_Init(void)
  *  @brief  This functions initializes Port F on the launchpad such that
@@ -43,102 +46,109 @@ unsigned long Led;
  */
 void PortF_Init(void);
 
-/** @fn     SysTick_Init(void)
- *  @brief  This function initializes SysTick with busy wait running
- *          at bus clock.
+/** @fn     Delay(void)
+ *  @brief  A function which causes a delay of 0.05 sec, calibrated
+ *          against SysTick for the clock in use.
  *  @return NULL
  */
-void SysTick_Init(void);
+void Delay(void);
 
-/** @fn     Delay(void)
- *  @brief  A function which causes a delay of 0.05 sec.
- *          51 ms on the Kiel µVision IDE simulator/debugger to be exact.
+#ifdef HOST_BUILD
+/** @fn     Stream(void)
+ *  @brief  Stands in for a UART on the host: drains completed trace blocks
+ *          and prints their events to stdout as "<cycles> <hex>" lines
+ *          while recording carries on.
  *  @return NULL
  */
-void Delay(void);
+void Stream(void);
+#endif
 
 /** @fn     main(void)
  *  @brief  This is the main function of the program. It initializes Port F
  *          and SysTick by calling the functions declared above. In an
  *          infinite loop, it checks if either or both the switches are pressed
  *          (negative logic) and flashes the LED at 10 Hz - meaning it turns on
- *          for 0.05 seconds and turns off for 0.05 seconds. 
+ *          for 0.05 seconds and turns off for 0.05 seconds. The switches are
+ *          read debounced, from Common/Debounce.c.
  *          Recording Debugging Data:
  *          If there is a difference in the previous and current values of PF0, 
  *          PF1, or PF4 - meaning if either of the switches are pressed/released
  *          and the LED turned on/off - the time and value of this bits will be
- *          recorded in the Time and Data arrays. Time lapsed is calculated using
- *          the SysTick Timer present in Cortex M microcontrollers.
+ *          recorded in the Blackbox trace. It keeps the latest events for
+ *          as long as the program runs; the time between two of them is the
+ *          difference of their SysTick times.
  *  @return An integer when successfully run.
  */
 int main(void) {  
-	unsigned long i,last,now;
+	unsigned long in;
 	unsigned long SW1, SW2;
-	unsigned long prevGPIO_PORTF_DATA_R;
+	unsigned long state, prevState;
 	
+  PROFILE_INIT();
+  PROFILE_NAME(PROF_PORTF_INIT, "PortF_Init");
+  PROFILE_NAME(PROF_LOOP, "loop");
+  PROFILE_START(PROF_PORTF_INIT);
   PortF_Init();		// initialize PF1 to output
-  SysTick_Init(); 	// initialize SysTick, runs at 16 MHz
+  PROFILE_STOP(PROF_PORTF_INIT);
+  SysTick_Init(); 	// initialize SysTick, counts at 16 MHz
+  Delay_Init();		// calibrate Delay() for that clock
+  Trace_Init(&Blackbox, Log, sizeof(Log), TRACE_WRAP, 8);
+  Debounce_Start(Switches, 1, 0x11, Clock_Hz() / 500);	// negative logic
 	
-  i = 0;          	// array index
-  last = NVIC_ST_CURRENT_R;
+  prevState = ~Debounce_State() & 0x11;
   
 	while(1) {
-		SW1 = (GPIO_PORTF_DATA_R & 0x10) >> 4;			// PF4
-		SW2 = (GPIO_PORTF_DATA_R & 0x1);		    	// PF0
-		prevGPIO_PORTF_DATA_R = GPIO_PORTF_DATA_R & 0x13;	// store PF0, PF1, and PF4
-		Led = GPIO_PORTF_DATA_R;				// read previous
+		PROFILE_START(PROF_LOOP);				// one pass, without the delay
+		in = GPIO_PORTF_DATA_R;					// the LED as last written
+		in = (in & ~0x11) | (~Debounce_State() & 0x11);	// the switches, debounced
+		SW1 = (in & 0x10) >> 4;					// PF4
+		SW2 = (in & 0x1);		    			// PF0
 		if ((SW1 & SW2) == 0x0) {				// if either of the switches are pressed (negative logic)
-			Led = Led^0x02;					// toggle red LED
+			Led = in^0x02;					// toggle red LED
 		}
 		else {
 			Led = 0x0;
 		}
     GPIO_PORTF_DATA_R = Led;   				      		// output
 		
-		// check for change in PF0, PF1, and PF4
-		if (prevGPIO_PORTF_DATA_R != (GPIO_PORTF_DATA_R & 0x13)) {
-			if(i < 50) {
-				now = NVIC_ST_CURRENT_R;
-				Time[i] = (last-now) & 0x00FFFFFF;  // 24-bit time difference
-				Data[i] = GPIO_PORTF_DATA_R & 0x13; // record PF4, PF1, and PF0
-				last = now;
-				i++;
-			}
+		// check for change in PF0, PF1, and PF4 since the last pass
+		state = (in & 0x11) | (Led & 0x02);
+		if (state != prevState) {
+			Trace_Record(&Blackbox, SysTick_Now(), ((state >> 2) & 0x04) | (state & 0x03));  // PF4,PF1,PF0 as 3 bits
+			prevState = state;
 		}
+#ifdef HOST_BUILD
+		Stream();
+#endif
+		PROFILE_STOP(PROF_LOOP);
     Delay();
   }
 }
 
 /* Port F initialization */
 void PortF_Init(void) {
-  volatile unsigned long delay;
-  SYSCTL_RCGC2_R |= 0x00000020;       // activate clock for Port F
-  delay = SYSCTL_RCGC2_R;             // allow time for clock to start
-  GPIO_PORTF_LOCK_R = 0x4C4F434B;     // unlock GPIO Port F
-  GPIO_PORTF_CR_R = 0x1F;             // allow changes to PF4-0
-  // only PF0 needs to be unlocked, other bits can't be locked
-  GPIO_PORTF_AMSEL_R = 0x00;          // disable analog on PF
-  GPIO_PORTF_PCTL_R = 0x00000000;     // PCTL GPIO on PF4-0
-  GPIO_PORTF_DIR_R = 0x0E;            // PF4,PF0 in, PF3-1 out
-  GPIO_PORTF_AFSEL_R = 0x00;          // disable alt funct on PF7-0
-  GPIO_PORTF_PUR_R = 0x11;            // enable pull-up on PF0 and PF4
-  GPIO_PORTF_DEN_R = 0x1F;            // enable digital I/O on PF4-0
+  Gpio_Clocks(SYSCTL_RCGC2_GPIOF);    // activate clock for Port F
+  // PF4,PF0 in with pull-ups, PF3-1 out; PF0 gets unlocked
+  GPIO_CONFIG(F, 0x11, 0x0E, 0x11, 0, 0, 0, 0);
 }
 
-/* SysTick Timer initialization */
-void SysTick_Init(void) {
-  NVIC_ST_CTRL_R = 0;                   // disable SysTick during setup
-  NVIC_ST_RELOAD_R = 0x00FFFFFF;        // maximum reload value (24 bits)
-  NVIC_ST_CURRENT_R = 0;                // any write to current clears it             
-  NVIC_ST_CTRL_R = 0x00000005;          // enable SysTick with core clock
+/* Delay of 0.05 sec */
+void Delay(void) {
+  // was a loop of 75000 passes, 51 ms on the simulator
+  Delay_ms(50);
 }
 
-/* Delay of ~0.05 sec */
-void Delay(void) {
-  unsigned long volatile time;
-  //time = 160000;  // 0.1sec
-	time = 75000;			// 0.05 sec
-  while (time) {
-    time--;
+#ifdef HOST_BUILD
+/* Decode each block as it is completed */
+void Stream(void) {
+  unsigned char block[TRACE_BLOCK];
+  Event e[TRACE_BLOCK];
+  unsigned long n, k;
+  while (Trace_Drain(&Blackbox, block)) {
+    n = Trace_Decode(block, e, TRACE_BLOCK);
+    for (k = 0; k < n; k++) {
+      printf("%llu %02lX\n", e[k].Time, ((e[k].Data & 0x04) << 2) | (e[k].Data & 0x03));
+    }
   }
 }
+#endif
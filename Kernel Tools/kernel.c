@@ -0,0 +1,230 @@
+/** @file   kernel.c
+ *  @brief  Host-side check and benchmark of the preemptive kernel in
+ *          Common/Kernel.c, run on the register emulator and built with
+ *          KERNEL_LATENCY. By default it runs a high-priority thread woken
+ *          by the timer 0A interrupt at random times, sleepers at middle
+ *          priorities, a thread that exits and is created again, and a
+ *          low-priority thread that never blocks, like a long trace
+ *          drain. It checks that each interrupt wakes the high thread and
+ *          no signal is lost, that no sleeper wakes early, that a thread
+ *          only runs while no higher one is ready, and that the busy
+ *          thread never holds the high one off. It then prints the
+ *          interrupt-to-thread latency histogram. With -b it measures the
+ *          cost of a switch between two threads that signal each other,
+ *          in emulated cycles and in host time.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tm4c123.h"
+#include "SysTick.h"
+#include "Kernel.h"
+
+#define SLEEPERS        4
+#define CHECK_IRQS      20000UL
+#define BENCH_SWITCHES  1000000UL
+#define MAX_LATENCY     200         // cycles the busy thread may add to a wake-up
+#define EVENT_IRQ       0x01
+#define EVENT_PING      0x02
+
+/* Cheap deterministic random numbers */
+static unsigned long Seed = 1;
+static unsigned long rnd(void) {
+    Seed = Seed * 1103515245UL + 12345UL;
+    return (Seed >> 16) & 0x7FFF;
+}
+
+static unsigned long HighStack[KERNEL_STACK(256)], BusyStack[KERNEL_STACK(256)];
+static unsigned long SleeperStacks[SLEEPERS][KERNEL_STACK(256)], ExiterStack[KERNEL_STACK(256)];
+static Thread High, Busy, Sleepers[SLEEPERS], Exiter;
+
+static volatile unsigned long Irqs;         // timer interrupts taken
+static volatile unsigned long long IrqTime; // when the latest one was
+static unsigned long Handled, Wakes, Exits, Errors;
+static unsigned long Running;               // priority of the thread running, as it last said
+static unsigned long ExiterAlive;
+
+static void error(const char *what, const Thread *t, unsigned long long late) {
+    if (Errors++ < 10) {
+        printf("%s: thread %s at %llu, by %llu cycles\n", what, t->Name, SysTick_Now(), late);
+    }
+}
+
+/* Fires once, at a random time 2000-34000 cycles ahead */
+static void arm(void) {
+    TIMER0_CTL_R = 0;
+    TIMER0_TAILR_R = 2000 + rnd();
+    TIMER0_ICR_R = TIMER_ICR_TATOCINT;
+    TIMER0_CTL_R = TIMER_CTL_TAEN;
+}
+
+void Timer0A_Handler(void) {
+    IrqTime = SysTick_Now();
+    TIMER0_ICR_R = TIMER_ICR_TATOCINT;
+    Irqs++;
+    Kernel_Signal(&High, EVENT_IRQ);
+}
+
+/* Running is what the threads last said about themselves. A thread that
+   was preempted while ready finds a lower one there if that one ran in
+   between. */
+static void mark(Thread *t) {
+    Running = t->Priority;
+}
+
+static void high(void) {
+    unsigned long long late;
+    unsigned long i, woken = 0;
+    while (Handled < CHECK_IRQS) {
+        arm();
+        Kernel_Wait(EVENT_IRQ);
+        mark(&High);
+        late = SysTick_Now() - IrqTime;
+        Handled++;
+        if (Handled != Irqs) {
+            error("lost interrupt", &High, Irqs - Handled);
+        }
+        if (late > MAX_LATENCY) {
+            error("late", &High, late);
+        }
+    }
+    TIMER0_CTL_R = 0;
+    printf("interrupts %lu\n", Irqs);
+    printf("handled %lu\n", Handled);
+    printf("wakes %lu\n", Wakes);
+    printf("exits %lu\n", Exits);
+    printf("switches %lu\n", Kernel_Switches());
+    for (i = 0; i < KERNEL_BUCKETS; i++) {
+        woken += High.Latency[i];
+    }
+    printf("latency_mean %.1f\n", (double)High.TotalLatency / woken);
+    printf("latency_worst %lu\n", High.WorstLatency);
+    for (i = 0; i < KERNEL_BUCKETS; i++) {
+        if (High.Latency[i]) {
+            printf("latency_below_%lu %lu\n", 1UL << i, High.Latency[i]);
+        }
+    }
+    printf("errors %lu\n", Errors);
+    exit(Errors || !Wakes || !Exits || Handled != CHECK_IRQS);
+}
+
+static void sleeper(void) {
+    Thread *t = Kernel_Self();
+    unsigned long long due, now;
+    while (1) {
+        due = SysTick_Now() + 500 + rnd() * 4;
+        now = Kernel_SleepUntil(due);
+        mark(t);
+        Wakes++;
+        if (now < due) {
+            error("early", t, due - now);
+        }
+        CPU_CYCLES(rnd() % 3000);       // preempted by the high thread in here
+        if (Running > t->Priority) {
+            error("lower thread ran while it was ready", t, 0);
+        }
+    }
+}
+
+/* Sleeps a while and returns; the busy thread creates it again */
+static void exiter(void) {
+    Kernel_SleepUntil(SysTick_Now() + 10000 + rnd());
+    mark(&Exiter);
+    Exits++;
+    ExiterAlive = 0;
+}
+
+static void busy(void) {
+    while (1) {
+        mark(&Busy);
+        CPU_CYCLES(100000);             // a long drain, in one piece
+        if (Running > Busy.Priority) {
+            error("lower thread ran while it was ready", &Busy, 0);
+        }
+        if (!ExiterAlive) {
+            ExiterAlive = 1;
+            Kernel_Create(&Exiter, exiter, ExiterStack, KERNEL_STACK(256), 10, "exiter");
+        }
+    }
+}
+
+static int check(void) {
+    unsigned long i;
+    static const char *names[SLEEPERS] = {"sleeper1", "sleeper2", "sleeper3", "sleeper4"};
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R0;
+    (void)SYSCTL_RCGCTIMER_R;
+    TIMER0_CTL_R = 0;
+    TIMER0_CFG_R = TIMER_CFG_32_BIT_TIMER;
+    TIMER0_TAMR_R = TIMER_TAMR_TAMR_1_SHOT;
+    TIMER0_IMR_R = TIMER_IMR_TATOIM;
+    NVIC_EN0_R = NVIC_EN0_INT19;
+    Kernel_Init();
+    Kernel_Create(&High, high, HighStack, KERNEL_STACK(256), 0, "high");
+    for (i = 0; i < SLEEPERS; i++) {
+        Kernel_Create(&Sleepers[i], sleeper, SleeperStacks[i], KERNEL_STACK(256), 1 + i, names[i]);
+    }
+    Kernel_Create(&Busy, busy, BusyStack, KERNEL_STACK(256), 20, "busy");
+    Kernel_Start();
+    return 1;
+}
+
+static double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static Thread Ping, Pong;
+static unsigned long Left, Switches;
+static unsigned long long Cycles0;
+static double Host0;
+
+/* Pong is higher: each signal from Ping switches to it, and each wait of
+   Pong switches back */
+static void pong(void) {
+    while (1) {
+        Kernel_Wait(EVENT_PING);
+    }
+}
+
+static void ping(void) {
+    unsigned long long cycles;
+    while (Left) {
+        Left--;
+        Kernel_Signal(&Pong, EVENT_PING);
+    }
+    cycles = SysTick_Now() - Cycles0;
+    printf("switches %lu\n", Kernel_Switches() - Switches);
+    printf("cycles_per_switch %.2f\n", (double)cycles / (Kernel_Switches() - Switches));
+    printf("pong_wake_cycles %.2f\n", (double)Pong.TotalLatency / Pong.Switches);
+    printf("host_ns_per_switch %.2f\n", (seconds() - Host0) * 1e9 / (Kernel_Switches() - Switches));
+    exit(0);
+}
+
+static int bench(unsigned long switches) {
+    Left = switches / 2;
+    Kernel_Init();
+    Kernel_Create(&Ping, ping, HighStack, KERNEL_STACK(256), 2, "ping");
+    Kernel_Create(&Pong, pong, BusyStack, KERNEL_STACK(256), 1, "pong");
+    Switches = 2;                       // the first switches into each
+    Cycles0 = SysTick_Now();
+    Host0 = seconds();
+    Kernel_Start();
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    SysTick_Init();
+    if (argc >= 2 && !strcmp(argv[1], "-b")) {
+        return bench(argc >= 3 ? strtoul(argv[2], 0, 0) : BENCH_SWITCHES);
+    }
+    if (argc > 1) {
+        fprintf(stderr, "usage: %s\n       %s -b [switches]\n", argv[0], argv[0]);
+        return 2;
+    }
+    return check();
+}
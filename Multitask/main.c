@@ -0,0 +1,338 @@
+/** @file   main.c
+ *  @brief  The Pacemaker, SOS and Functional Debugging programs running
+ *          together on one LaunchPad, each as a cooperative task
+ *          (Common/Task.h) instead of a main() of its own:
+ *          - Pacer: the pacemaker. SW1 (PF4) is the atrial sensor, sensed
+ *            by its edge interrupt; green (PF3) is Ready and red (PF1) is
+ *            the ventricular trigger, 250 ms after the sense for 250 ms.
+ *          - Status: the SOS sequencer. Pressing SW2 (PF0) starts SOS on
+ *            the blue LED (PF2), and pressing it again stops it at the end
+ *            of the message.
+ *          - Recorder: the I/O recorder. Every 10 ms it records any change
+ *            of the switches or LEDs in a compressed trace.
+ *          Every wait is a sleep: the core runs only when a timer or an
+ *          edge interrupt has work for a task. Each task's running time
+ *          is counted, and the host build prints it every 10 s.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#include "../Common/tm4c123.h"
+#include "../SysTick Timer/SysTick.h"
+#include "../Common/Clock.h"
+#include "../Common/Task.h"
+#include "../Common/Debounce.h"
+#include "../Common/Trace.h"
+#include "../Common/Pin.h"
+#include "../Common/Gpio.h"
+#ifdef HOST_BUILD
+#include <stdio.h>
+#endif
+
+#define AS              0x10        // PF4, SW1, low while pressed
+#define SW2             0x01        // PF0, low while pressed
+#define VT              PIN(GPIO_PORTF_BASE, 0x02)  // PF1, red LED
+#define STATUS          PIN(GPIO_PORTF_BASE, 0x04)  // PF2, blue LED
+#define READY           PIN(GPIO_PORTF_BASE, 0x08)  // PF3, green LED
+#define LEDS            PIN(GPIO_PORTF_BASE, 0x0E)
+
+/* Events signalled by the port F edge interrupt */
+#define EVENT_AS        0x01
+#define EVENT_SW2       0x02
+
+/* Tasks sleep in ticks of 1 us */
+#define MS              1000
+#define DEBOUNCE_MS     10
+#define AV_DELAY_MS     250         // atrial sense to ventricular trigger
+#define VT_PULSE_MS     250
+#define HALF_SECOND     (500 * MS)
+#define SW2_POLLS       8           // 4 ms apart after an SW2 edge, past its bounce
+#define RECORD_MS       10
+#define REPORT_MS       10000
+
+/* Switches sampled by the debouncer every 2 ms */
+const unsigned long Switches[1] = {PIN_ADDR(GPIO_PORTF_BASE, 0x11)};
+
+unsigned long CyclesPerMs;
+volatile unsigned long long EdgeTime;   // when the latest AS edge was seen
+
+// AS edge to VT, in cycles, for the latest beat and over all beats
+unsigned long long Latency;
+unsigned long long LatencyMin = 0xFFFFFFFFFFFFFFFFULL, LatencyMax;
+unsigned long Beats;
+
+// the latest changes, times in units of 256 cycles
+unsigned char Log[1024];
+Trace Blackbox;
+
+Task PacerTask, StatusTask, RecordTask;
+#ifdef HOST_BUILD
+Task ReportTask;
+#endif
+
+/** @fn     PortF_Init(void)
+ *  @brief  Sets up the switches on PF4 and PF0 with pull-ups and their
+ *          edge interrupts, and the LEDs on PF3-1.
+ *  @return NULL
+ */
+void PortF_Init(void);
+
+/** @fn     GPIOPortF_Handler(void)
+ *  @brief  Edge interrupt of PF4 and PF0. Timestamps an AS edge first,
+ *          acknowledges, and signals the tasks.
+ *  @return NULL
+ */
+void GPIOPortF_Handler(void);
+
+/** @fn     char Pacer(Task *)
+ *  @brief  The pacemaker loop: Ready until the atrial sensor is pressed,
+ *          then VT 250 ms after it is released, for 250 ms.
+ *  @param  Its task.
+ *  @return Task state.
+ */
+char Pacer(Task *t);
+
+/** @fn     char Status(Task *)
+ *  @brief  The SOS loop: flashes SOS on the blue LED from one SW2 press to
+ *          the end of the message during which it is pressed again.
+ *  @param  Its task.
+ *  @return Task state.
+ */
+char Status(Task *t);
+
+/** @fn     char Record(Task *)
+ *  @brief  The Functional Debugging recorder: records the switches and
+ *          LEDs in Blackbox whenever they change.
+ *  @param  Its task.
+ *  @return Task state.
+ */
+char Record(Task *t);
+
+#ifdef HOST_BUILD
+/** @fn     char Report(Task *)
+ *  @brief  Prints the share of the time each task ran every 10 s.
+ *  @param  Its task.
+ *  @return Task state.
+ */
+char Report(Task *t);
+#endif
+
+/** @fn     main(void)
+ *  @brief  Sets up the port, the time base and the debouncer, creates the
+ *          tasks and runs them.
+ *  @return Does not return.
+ */
+int main(void) {
+    PortF_Init();
+    SysTick_Init();
+    CyclesPerMs = Clock_Hz() / 1000;
+    Trace_Init(&Blackbox, Log, sizeof(Log), TRACE_WRAP, 8);
+    Debounce_Start(Switches, 1, 0x11, Clock_Hz() / 500);   // negative logic
+    Task_Init(CyclesPerMs / MS);
+    Task_Create(&PacerTask, Pacer, "pacer");
+    Task_Create(&StatusTask, Status, "status");
+    Task_Create(&RecordTask, Record, "recorder");
+#ifdef HOST_BUILD
+    Task_Create(&ReportTask, Report, "report");
+#endif
+    Task_Run();
+    return 0;
+}
+
+/* Initialize port F */
+void PortF_Init(void) {
+    Gpio_Clocks(SYSCTL_RCGC2_GPIOF);
+    GPIO_CONFIG(F, 0x11, 0x0E, 0x11, 0, 0, 0, 0);  // unlocks PF0
+    GPIO_PORTF_IS_R &= ~0x11;           // edge-sensitive
+    GPIO_PORTF_IBE_R &= ~0x11;          // on the one edge chosen by IEV
+    GPIO_PORTF_IEV_R &= ~SW2;           // SW2 on the press
+    GPIO_PORTF_ICR_R = 0x11;            // clear any edge from the setup
+    GPIO_PORTF_IM_R = SW2;              // AS is armed by the pacer
+    NVIC_PRI7_R = (NVIC_PRI7_R & ~NVIC_PRI7_INT30_M) | (2 << NVIC_PRI7_INT30_S);   // below SysTick
+    NVIC_EN0_R = NVIC_EN0_INT30;
+}
+
+void GPIOPortF_Handler(void) {
+    unsigned long long now = SysTick_Now();    // first, so it lags the edge by a fixed time
+    unsigned long edges = GPIO_PORTF_MIS_R;
+    GPIO_PORTF_ICR_R = edges;           // acknowledge
+    if (edges & AS) {
+        EdgeTime = now;
+        Task_Signal(EVENT_AS);
+    }
+    if (edges & SW2) {
+        Task_Signal(EVENT_SW2);
+    }
+}
+
+/* Arms the AS edge interrupt for the given level, and tells whether AS
+   is already there */
+static int armAS(unsigned long level) {
+    int there;
+    DisableInterrupts();
+    GPIO_PORTF_IM_R &= ~AS;             // mask while changing the edge
+    GPIO_PORTF_IEV_R = (GPIO_PORTF_IEV_R & ~AS) | level;
+    GPIO_PORTF_ICR_R = AS;
+    GPIO_PORTF_IM_R |= AS;
+    there = (GPIO_PORTF_DATA_R & AS) == level;
+    EnableInterrupts();
+    return there;
+}
+
+static void disarmAS(void) {
+    DisableInterrupts();
+    GPIO_PORTF_IM_R &= ~AS;
+    EnableInterrupts();
+}
+
+/* Times kept across waits are static */
+char Pacer(Task *t) {
+    static unsigned long long pressed, sensed, vt;
+    TASK_BEGIN(t);
+    while (1) {
+        READY = 0x08;
+
+        // sleep until the switch is pressed
+        if (armAS(0)) {
+            pressed = SysTick_Now();
+        } else {
+            TASK_WAIT_EVENT(t, EVENT_AS, 0);
+            pressed = EdgeTime;
+        }
+        disarmAS();
+        READY = 0;
+
+        // let it bounce for 10 ms, then sleep until it is released: that
+        // is the atrial sense
+        TASK_SLEEP_UNTIL(t, Task_Tick(pressed + DEBOUNCE_MS * CyclesPerMs));
+        if (armAS(AS)) {
+            sensed = SysTick_Now();
+        } else {
+            TASK_WAIT_EVENT(t, EVENT_AS, 0);
+            sensed = EdgeTime;
+        }
+        disarmAS();
+
+        // VT 250 ms after the sense, for 250 ms
+        TASK_SLEEP_UNTIL(t, Task_Tick(sensed + AV_DELAY_MS * CyclesPerMs));
+        VT = 0x02;
+        vt = SysTick_Now();
+        Latency = vt - sensed;
+        if (Latency < LatencyMin) {
+            LatencyMin = Latency;
+        }
+        if (Latency > LatencyMax) {
+            LatencyMax = Latency;
+        }
+        Beats++;
+#ifdef HOST_BUILD
+        printf("beat %lu: AS->VT %llu cycles (%+lld from %d ms), min %llu max %llu\n",
+            Beats, Latency, (long long)(Latency - AV_DELAY_MS * CyclesPerMs),
+            AV_DELAY_MS, LatencyMin, LatencyMax);
+#endif
+        TASK_SLEEP_UNTIL(t, Task_Tick(vt + VT_PULSE_MS * CyclesPerMs));
+        VT = 0;
+    }
+    TASK_END(t);
+}
+
+/* On for odd steps, in half seconds: S, O, S, then 5 s dark */
+static const unsigned char Halves[19] = {
+    1, 1, 1, 1, 1, 1, 4, 4, 4, 4, 4, 4, 1, 1, 1, 1, 1, 1, 10
+};
+
+/* An edge on SW2 wakes the task, and the debouncer decides whether it
+   was a press: it is polled until the bounce must be over. The message
+   is timed from its start, so it does not drift. */
+char Status(Task *t) {
+    static unsigned long polls, step;
+    static unsigned long long due;
+    TASK_BEGIN(t);
+    while (1) {
+        polls = 0;
+        while (!(Debounce_Pressed() & SW2)) {
+            if (polls) {
+                polls--;
+                TASK_SLEEP(t, 4 * MS);
+            } else {
+                TASK_WAIT_EVENT(t, EVENT_SW2, 0);
+                polls = SW2_POLLS;
+            }
+        }
+        due = Wheel_Ticks();
+        do {
+            for (step = 0; step < 19; step++) {
+                STATUS = step < 18 && !(step & 1) ? 0x04 : 0;
+                due += Halves[step] * HALF_SECOND;
+                TASK_SLEEP_UNTIL(t, due);
+            }
+        } while (!(Debounce_Pressed() & SW2));
+    }
+    TASK_END(t);
+}
+
+#ifdef HOST_BUILD
+/* Stands in for a UART on the host: prints the events of every completed
+   trace block as "<cycles> <hex>" lines */
+static void stream(void) {
+    unsigned char block[TRACE_BLOCK];
+    Event e[TRACE_BLOCK];
+    unsigned long n, k;
+    while (Trace_Drain(&Blackbox, block)) {
+        n = Trace_Decode(block, e, TRACE_BLOCK);
+        for (k = 0; k < n; k++) {
+            printf("%llu %02lX\n", e[k].Time, e[k].Data);
+        }
+    }
+}
+#endif
+
+/* PF4-PF0 as 5 bits: the switches debounced, 1 while pressed, and the
+   LEDs as last written */
+char Record(Task *t) {
+    static unsigned long state, prevState = 0xFF;
+    static unsigned long long due;
+    TASK_BEGIN(t);
+    due = Wheel_Ticks();
+    while (1) {
+        state = (Debounce_State() & 0x11) | LEDS;
+        if (state != prevState) {
+            Trace_Record(&Blackbox, SysTick_Now(), state);
+            prevState = state;
+        }
+#ifdef HOST_BUILD
+        stream();
+#endif
+        due += RECORD_MS * MS;
+        TASK_SLEEP_UNTIL(t, due);
+    }
+    TASK_END(t);
+}
+
+#ifdef HOST_BUILD
+/* Share of the time each task ran, and the sleep */
+char Report(Task *t) {
+    static unsigned long long start;
+    unsigned long long total;
+    Task *all[4];
+    unsigned long i;
+    TASK_BEGIN(t);
+    start = SysTick_Now();
+    while (1) {
+        TASK_SLEEP(t, REPORT_MS * MS);
+        total = SysTick_Now() - start;
+        all[0] = &PacerTask;
+        all[1] = &StatusTask;
+        all[2] = &RecordTask;
+        all[3] = &ReportTask;
+        printf("tasks at %.0f s:", total / (CyclesPerMs * 1000.0));
+        for (i = 0; i < 4; i++) {
+            printf(" %s %.4f%% (%lu runs, %.1f cycles each, worst %lu),", all[i]->Name,
+                100.0 * all[i]->Cycles / total, all[i]->Runs,
+                (double)all[i]->Cycles / all[i]->Runs, all[i]->WorstRun);
+        }
+        printf(" idle %.4f%%, %lu switches\n", 100.0 * Task_Idle() / total, Task_Switches());
+    }
+    TASK_END(t);
+}
+#endif
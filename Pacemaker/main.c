@@ -14,21 +14,61 @@
  * 		250 ms (simulates the time between atrial and ventricular contraction)
  * 		and sets VT as high which will pulse the ventricles. It then waits for
  * 		another 250 ms and then clears VT (set as low).
+ *
+ * 		The switch is sensed by the PF4 edge interrupt, which timestamps each
+ * 		edge with SysTick_Now() as the first thing it does. The 250 ms are
+ * 		counted from that timestamp and the core sleeps in between, so VT
+ * 		follows the release by 250 ms plus a few microseconds at most, not
+ * 		plus up to a 10 ms polling period. The latency of every beat is
+ * 		kept in Latency, LatencyMin and LatencyMax.
+ *
+ * 		The pacing loop runs as the highest-priority thread of the
+ * 		preemptive kernel in Common/Kernel.h. A low-priority logger thread
+ * 		records the port every millisecond in a compressed trace and sends
+ * 		each full block out at 9600 baud, busy for 67 ms at a time. The
+ * 		pacer preempts it whenever it has to act, so the drain never
+ * 		delays VT.
  * 	@author	Mustafa Siddiqui
  * 	@date	06/26/20
  */
 
-/* Define ports */
-#define GPIO_PORTF_DATA_R       (*((volatile unsigned long *)0x400253FC))
-#define GPIO_PORTF_DIR_R        (*((volatile unsigned long *)0x40025400))
-#define GPIO_PORTF_AFSEL_R      (*((volatile unsigned long *)0x40025420))
-#define GPIO_PORTF_PUR_R        (*((volatile unsigned long *)0x40025510))
-#define GPIO_PORTF_DEN_R        (*((volatile unsigned long *)0x4002551C))
-#define GPIO_PORTF_LOCK_R       (*((volatile unsigned long *)0x40025520))
-#define GPIO_PORTF_CR_R         (*((volatile unsigned long *)0x40025524))
-#define GPIO_PORTF_AMSEL_R      (*((volatile unsigned long *)0x40025528))
-#define GPIO_PORTF_PCTL_R       (*((volatile unsigned long *)0x4002552C))
-#define SYSCTL_RCGC2_R          (*((volatile unsigned long *)0x400FE108))
+#include "../Common/tm4c123.h"
+#include "../SysTick Timer/SysTick.h"
+#include "../Common/Clock.h"
+#include "../SysTick Timer/Delay.h"
+#include "../Common/Pin.h"
+#include "../Common/Gpio.h"
+#include "../Common/Kernel.h"
+#include "../Common/Trace.h"
+#ifdef HOST_BUILD
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+#define AS		0x10		// PF4, low while the switch is pressed
+#define VT		PIN(GPIO_PORTF_BASE, 0x02)	// PF1, red LED
+#define READY		PIN(GPIO_PORTF_BASE, 0x08)	// PF3, green LED
+#define DEBOUNCE_MS	10
+#define AV_DELAY_MS	250		// atrial sense to ventricular trigger
+#define VT_PULSE_MS	250
+#define SAMPLE_MS	1		// logger sampling period
+#define BYTE_US		1042		// one byte at 9600 baud
+#define EVENT_AS	0x01		// signalled to the pacer by the edge interrupt
+
+unsigned long CyclesPerMs;
+volatile unsigned long long EdgeTime;	// when the latest AS edge was seen
+
+Thread Pacer, Logger;
+unsigned long PacerStack[KERNEL_STACK(128)], LoggerStack[KERNEL_STACK(128)];
+
+// port F as the logger last saw it, times in units of 256 cycles
+unsigned char Log[512];
+Trace Blackbox;
+
+// AS edge to VT, in cycles, for the latest beat and over all beats
+unsigned long long Latency;
+unsigned long long LatencyMin = 0xFFFFFFFFFFFFFFFFULL, LatencyMax;
+unsigned long Beats;
 
 /**	@fn	void PortF_Init(void)
  * 	@brief	Initializes Port F on the microcontroller to allow digital function and sets 
@@ -37,28 +77,61 @@
  */
 void PortF_Init(void);
 
-/**	@fn	void Delay1ms(unsigned long)
- * 	@brief	A function to cause delay for approximately some milliseconds. It assumes an 80 MHz clock.
- * 	@param	The number of milliseconds to be delayed for.
+/**	@fn	unsigned long long WaitForASLow(void)
+ * 	@brief 	Sleeps until the AS input goes low (switch pressed). Returns at once if
+ * 		it already is low.
+ * 	@return	Time of the falling edge in cycles, or the current time if AS was low.
+ */
+unsigned long long WaitForASLow(void);
+
+/**	@fn	unsigned long long WaitForASHigh(void)
+ * 	@brief 	Sleeps until the AS input goes high (switch released). Returns at once if
+ * 		it already is high.
+ * 	@return	Time of the rising edge in cycles, or the current time if AS was high.
+ */
+unsigned long long WaitForASHigh(void);
+
+/**	@fn	void GPIOPortF_Handler(void)
+ * 	@brief	PF4 edge interrupt. Timestamps the edge, acknowledges it and
+ * 		signals the pacer.
  */
-void Delay1ms(unsigned long msec);
+void GPIOPortF_Handler(void);
 
-/**	@fn	void WaitForASLow(void)
- * 	@brief 	This functions reads the AS input and waits for the signal to be low. If it is
- * 		low, it returns. If not, it waits and calls itself (recursive function) until it
- * 		detects the signal to be low.
+/**	@fn	void Pace(void)
+ * 	@brief	The pacer thread, at priority 0. Sets 'Ready' as high and waits
+ * 		for the input (SW1) to go low because of negative logic (switch
+ * 		is being pressed). Waits 10 ms from the press to let the switch
+ * 		stop bouncing. It then clears 'Ready' and waits for the input
+ * 		(SW1) to be high (switch being released). 250 ms after it went
+ * 		high, it sets 'VT' for 250 ms. This process is repeated over. All
+ * 		the waits block the thread.
  */
-void WaitForASLow(void);
+void Pace(void);
 
-/**	@fn	void WaitForASHigh(void)
- * 	@brief 	This functions reads the AS input and waits for the signal to be high. If it is
- * 		high, it returns. If not, it waits and calls itself (recursive function) until it
- * 		detects the signal to be high.
+/**	@fn	void Log_Port(void)
+ * 	@brief	The logger thread, at priority 1. Samples PF4 and PF3-1 every
+ * 		millisecond, records changes in Blackbox, and sends every full
+ * 		block out with Send().
  */
-void WaitForASHigh(void);
+void Log_Port(void);
+
+/**	@fn	void Send(const unsigned char *)
+ * 	@brief	Sends a trace block the way a polled 9600 baud UART would, busy
+ * 		for a byte time per byte. The LaunchPad lab has no UART wired
+ * 		up, so the bytes go nowhere; the host build prints the events.
+ */
+void Send(const unsigned char *block);
+
+#if defined(HOST_BUILD) && defined(KERNEL_LATENCY)
+/**	@fn	void Report(void)
+ * 	@brief	Prints the histogram of the pacer's wake-up latency on exit.
+ */
+static void Report(void);
+#endif
 
 /**	@fn	void SetVT(void)
- * 	@brief	This functions sets VT - PF1 - high. It does not affect the other bits in the port.
+ * 	@brief	This functions sets VT - PF1 - high. It does not affect the other bits in the port,
+ * 		even if an interrupt changes them at the same time.
  */
 void SetVT(void);
 
@@ -79,117 +152,202 @@ void ClearReady(void);
 
 /**	@fn	main()
  * 	@brief 	Main function of the program which simulates the working of a heart pacemaker.
- * 		Sets 'Ready' as high initially and then waits for the input (SW1) to go low
- * 		because of negative logic (switch is being pressed). Delays for 10 ms to allow
- * 		any bouncing in the switch to be eliminated. It then clears 'Ready' and waits 
- * 		for the input(SW1) to be high (switch being released). When it goes high, it
- * 		waits for 250 ms and then sets 'VT' for 250 ms. This process is repeated over.
- * 	@return	An integer when successfully run.
+ * 		Sets up the port, the time base and the trace, and starts the
+ * 		pacer and logger threads.
+ * 	@return	Does not return.
  */ 
 int main(void){
-
-	// initialize port F
+	// initialize port F and the time base
 	PortF_Init();  
+	SysTick_Init();
+	Delay_Init();
+	CyclesPerMs = Clock_Hz() / 1000;
+	Trace_Init(&Blackbox, Log, sizeof(Log), TRACE_WRAP, 8);
+	Kernel_Init();
+	Kernel_Create(&Pacer, Pace, PacerStack, KERNEL_STACK(128), 0, "pacer");
+	Kernel_Create(&Logger, Log_Port, LoggerStack, KERNEL_STACK(128), 1, "logger");
+#if defined(HOST_BUILD) && defined(KERNEL_LATENCY)
+	atexit(Report);
+#endif
+	Kernel_Start();
+	return 0;
+}
+
+void Pace(void){
+	unsigned long long pressed, sensed, vt;
 	while(1) {
 
 		// ready signal goes high
 		SetReady();
 
-		// wait for switch to be pressed
-		WaitForASLow();
+		// sleep until the switch is pressed
+		pressed = WaitForASLow();
 
 		// ready signal goes low
 		ClearReady();
 
-		// delay for 10 ms
-		Delay1ms(10);
-
-		// wait for switch to be released
-		WaitForASHigh();
+		// let it bounce for 10 ms
+		Kernel_SleepUntil(pressed + DEBOUNCE_MS * CyclesPerMs);
 
-		// delay for 250 ms
-		Delay1ms(250);
+		// sleep until the switch is released: that is the atrial sense
+		sensed = WaitForASHigh();
 
-		// VT signal goes high
+		// VT signal goes high 250 ms after the sense
+		Kernel_SleepUntil(sensed + AV_DELAY_MS * CyclesPerMs);
 		SetVT();
-		Delay1ms(250);
+		vt = SysTick_Now();
+		Latency = vt - sensed;
+		if (Latency < LatencyMin) {
+			LatencyMin = Latency;
+		}
+		if (Latency > LatencyMax) {
+			LatencyMax = Latency;
+		}
+		Beats++;
+#ifdef HOST_BUILD
+		printf("beat %lu: AS->VT %llu cycles (%+lld from %d ms), min %llu max %llu\n",
+			Beats, Latency, (long long)(Latency - AV_DELAY_MS * CyclesPerMs),
+			AV_DELAY_MS, LatencyMin, LatencyMax);
+#endif
 
-		// VT signals goes low
+		// VT signals goes low 250 ms later
+		Kernel_SleepUntil(vt + VT_PULSE_MS * CyclesPerMs);
 		ClearVT();
   }
 }
 
+/* Records PF4 and PF3-1 as 4 bits whenever they change, on a 1 ms
+   schedule that skips ahead over the time spent sending */
+void Log_Port(void){
+	unsigned char block[TRACE_BLOCK];
+	unsigned long state, prevState = 0xFF;
+	unsigned long long due = SysTick_Now();
+	while(1) {
+		state = ((PIN(GPIO_PORTF_BASE, 0x1E) >> 1) & 0x0F);
+		if (state != prevState) {
+			Trace_Record(&Blackbox, SysTick_Now(), state);
+			prevState = state;
+		}
+		while (Trace_Drain(&Blackbox, block)) {
+			Send(block);
+		}
+		do {
+			due += SAMPLE_MS * CyclesPerMs;
+		} while (due <= SysTick_Now());
+		Kernel_SleepUntil(due);
+	}
+}
+
+void Send(const unsigned char *block){
+	unsigned long i;
+#ifdef HOST_BUILD
+	Event e[TRACE_BLOCK];
+	unsigned long n = Trace_Decode(block, e, TRACE_BLOCK);
+	for (i = 0; i < n; i++) {
+		printf("%llu %02lX\n", e[i].Time, e[i].Data);
+	}
+#else
+	(void)block;	// only the UART's timing is modelled
+#endif
+	for (i = 0; i < TRACE_BLOCK; i++) {
+		Delay_us(BYTE_US);
+	}
+}
+
+#if defined(HOST_BUILD) && defined(KERNEL_LATENCY)
+/* Wake-up latency of the pacer, from the edge interrupt or alarm */
+static void Report(void){
+	unsigned long i, n = 0;
+	for (i = 0; i < KERNEL_BUCKETS; i++) {
+		n += Pacer.Latency[i];
+	}
+	printf("pacer wake-ups: %lu, worst %lu cycles, mean %.1f\n", n, Pacer.WorstLatency,
+		n ? (double)Pacer.TotalLatency / n : 0.0);
+	for (i = 0; i < KERNEL_BUCKETS; i++) {
+		if (Pacer.Latency[i]) {
+			printf("  < %lu: %lu\n", 1UL << i, Pacer.Latency[i]);
+		}
+	}
+}
+#endif
+
 /* Initialize port F */
 void PortF_Init(void) { 
-	volatile unsigned long delay;
-  	SYSCTL_RCGC2_R |= 0x00000020;      // F clock
-  	delay = SYSCTL_RCGC2_R;            // delay to allow clock to stabilize     
-  	GPIO_PORTF_AMSEL_R &= 0x00;        // disable analog function
-  	GPIO_PORTF_PCTL_R &= 0x00000000;   // GPIO clear bit PCTL  
-  	GPIO_PORTF_DIR_R &= ~0x10;         // PF4 input
-  	GPIO_PORTF_DIR_R |= 0x0E;          // PF3,2,1 output  
-  	GPIO_PORTF_AFSEL_R &= 0x00;        // no alternate function
-  	GPIO_PORTF_PUR_R |= 0x10;          // enable pullup resistor on PF4       
-  	GPIO_PORTF_DEN_R |= 0x1E;          // enable digital pins PF4-PF1
+  	Gpio_Clocks(SYSCTL_RCGC2_GPIOF);   // F clock
+  	GPIO_CONFIG(F, 0x10, 0x0E, 0x10, 0, 0, 0, 0);  // PF4 input with pullup, PF3-1 output
+  	GPIO_PORTF_IS_R &= ~0x10;          // PF4 is edge-sensitive
+  	GPIO_PORTF_IBE_R &= ~0x10;         // on the one edge chosen by IEV
+  	GPIO_PORTF_IM_R &= ~0x10;          // masked until a wait arms it
+  	GPIO_PORTF_ICR_R = 0x10;           // clear any edge from the setup
+  	NVIC_PRI7_R = (NVIC_PRI7_R & ~NVIC_PRI7_INT30_M) | (2 << NVIC_PRI7_INT30_S);   // below SysTick
+  	NVIC_EN0_R = NVIC_EN0_INT30;       // enable interrupt 30 in NVIC
 }
 
-/* Wait for AS to be low */
-void WaitForASLow(void){
-	// PF4 denotes AS
-	unsigned long AS = (GPIO_PORTF_DATA_R & 0x10) >> 4;
-	if (AS == 0) {
-		return;
+/* Sleep until AS reaches the level, and return when it did. The edge
+   interrupt is only unmasked while waiting, so bounces in between cost
+   nothing. */
+static unsigned long long WaitForAS(unsigned long level){
+	unsigned long long t;
+	int there;
+	Kernel_Take(EVENT_AS);             // drop bounces of the last wait
+	DisableInterrupts();
+	GPIO_PORTF_IM_R &= ~AS;            // mask while changing the edge
+	GPIO_PORTF_IEV_R = level;          // rising edge for high, falling for low
+	GPIO_PORTF_ICR_R = AS;
+	GPIO_PORTF_IM_R |= AS;
+	there = (GPIO_PORTF_DATA_R & AS) == level;
+	EnableInterrupts();
+	if (there) {
+		t = SysTick_Now();             // already there
 	} else {
-		Delay1ms(10);
-		WaitForASLow();
+		Kernel_Wait(EVENT_AS);         // the pacer blocks until the edge
+		t = EdgeTime;
 	}
+	DisableInterrupts();
+	GPIO_PORTF_IM_R &= ~AS;
+	EnableInterrupts();
+	return t;
+}
+
+/* Wait for AS to be low */
+unsigned long long WaitForASLow(void){
+	return WaitForAS(0);
 }
 
 /* Wait for AS to be high */
-void WaitForASHigh(void){
-	// PF4 denotes AS
-	unsigned long AS = (GPIO_PORTF_DATA_R & 0x10) >> 4;
-	if (AS == 1) {
-		return;
-	} else {
-		Delay1ms(10);
-		WaitForASHigh();
-	}
+unsigned long long WaitForASHigh(void){
+	return WaitForAS(AS);
 }
 
-/* Set VT */
+/* AS edge */
+void GPIOPortF_Handler(void){
+	unsigned long long now = SysTick_Now();   // first, so it lags the edge by a fixed time
+	GPIO_PORTF_ICR_R = AS;             // acknowledge
+	EdgeTime = now;
+	Kernel_Signal(&Pacer, EVENT_AS);
+}
+
+/* Set VT: one store to PF1's DATA aperture */
 void SetVT(void){
 	// PF1 dentoes VT
-	GPIO_PORTF_DATA_R |= 0x2;
+	VT = 0x2;
 }
 
 /* Clear VT */
 void ClearVT(void){
 	// PF1 denotes VT
-	GPIO_PORTF_DATA_R &= ~0x2;
+	VT = 0;
 }
 
 /* Set Ready */
 void SetReady(void){
 	// PF3 denotes Ready
-	GPIO_PORTF_DATA_R |= 0x8;
+	READY = 0x8;
 }
 
 /* Clear Ready */
 void ClearReady(void){
 	// PF3 denotes Ready
-	GPIO_PORTF_DATA_R &= ~0x8;
-}
-
-/* Delay function */
-void Delay1ms(unsigned long msec){
-	unsigned long count;
-	while (msec > 0) {
-		count = 14333;
-		while (count > 0) {
-			count--;
-		}
-		msec--;
-	}
+	READY = 0;
 }
 
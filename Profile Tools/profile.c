@@ -0,0 +1,181 @@
+/** @file   profile.c
+ *  @brief  Host-side check and benchmark of the cycle profiling in
+ *          Common/Profile.c, run on the register emulator. By default it
+ *          profiles regions of known length and checks what the table
+ *          says about them: an empty region reads 0, a region of n cycles
+ *          reads n, also across a wrap of CYCCNT, the min, max, mean and
+ *          histogram match the runs, an interrupt inside a region counts
+ *          in it, and clearing keeps the names. With -b it measures what a
+ *          start and stop probe cost, in emulated cycles and in host time.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tm4c123.h"
+#include "Profile.h"
+
+#define CHECK_RUNS      100000UL
+#define BENCH_PROBES    10000000UL
+#define IRQ_REGION      5000        // cycles of the region the timer interrupts
+
+enum {PROF_EMPTY, PROF_KNOWN, PROF_IRQ, PROF_BENCH};
+
+/* Cheap deterministic random numbers */
+static unsigned long Seed = 1;
+static unsigned long rnd(void) {
+    Seed = Seed * 1103515245UL + 12345UL;
+    return (Seed >> 16) & 0x7FFF;
+}
+
+static unsigned long Errors, Irqs;
+
+static void error(const char *what, unsigned long got, unsigned long want) {
+    if (Errors++ < 10) {
+        printf("%s: %lu, expected %lu\n", what, got, want);
+    }
+}
+
+void Timer0A_Handler(void) {
+    TIMER0_ICR_R = TIMER_ICR_TATOCINT;
+    Irqs++;
+    CPU_CYCLES(100);
+}
+
+static unsigned long bucket_of(unsigned long cycles) {
+    unsigned long b = 0;
+    while (b < PROFILE_BUCKETS - 1 && (cycles >> b)) {
+        b++;
+    }
+    return b;
+}
+
+static int check(void) {
+    static unsigned long hist[PROFILE_BUCKETS];
+    unsigned long long total = 0;
+    unsigned long i, n, min = 0xFFFFFFFF, max = 0, inside;
+    volatile unsigned long delay;
+    Region *g = &Profile_Regions[PROF_KNOWN];
+
+    PROFILE_INIT();
+    PROFILE_NAME(PROF_EMPTY, "empty");
+    PROFILE_NAME(PROF_KNOWN, "known");
+    PROFILE_NAME(PROF_IRQ, "interrupted");
+    printf("overhead %lu\n", Profile_Overhead);
+
+    // nothing between the probes
+    for (i = 0; i < 1000; i++) {
+        PROFILE_START(PROF_EMPTY);
+        PROFILE_STOP(PROF_EMPTY);
+    }
+    if (Profile_Regions[PROF_EMPTY].Max != 0) {
+        error("empty region", Profile_Regions[PROF_EMPTY].Max, 0);
+    }
+
+    // regions of random lengths, from 0 to about 1.6 million cycles
+    for (i = 0; i < CHECK_RUNS; i++) {
+        n = rnd() >> (rnd() % 15);
+        n <<= rnd() % 7;
+        if (i % 1000 == 0) {
+            DWT_CYCCNT_R = 0xFFFFFFFF - rnd();      // wraps inside the region
+        }
+        PROFILE_START(PROF_KNOWN);
+        CPU_CYCLES(n);
+        PROFILE_STOP(PROF_KNOWN);
+        hist[bucket_of(n)]++;
+        total += n;
+        min = n < min ? n : min;
+        max = n > max ? n : max;
+        if (g->Count == i + 1 && g->Total != total) {
+            error("region length", (unsigned long)(g->Total - (total - n)), n);
+            total = g->Total;
+        }
+    }
+    if (g->Count != CHECK_RUNS) {
+        error("runs", g->Count, CHECK_RUNS);
+    }
+    if (g->Min != min) {
+        error("min", g->Min, min);
+    }
+    if (g->Max != max) {
+        error("max", g->Max, max);
+    }
+    for (i = 0; i < PROFILE_BUCKETS; i++) {
+        if (g->Hist[i] != hist[i]) {
+            error("histogram bucket", g->Hist[i], hist[i]);
+        }
+    }
+    printf("runs %lu\n", g->Count);
+    printf("mean %.1f\n", (double)g->Total / g->Count);
+
+    // a timer interrupt in the middle of a region
+    SYSCTL_RCGCTIMER_R |= SYSCTL_RCGCTIMER_R0;
+    delay = SYSCTL_RCGCTIMER_R;
+    (void)delay;
+    TIMER0_CTL_R = 0;
+    TIMER0_CFG_R = TIMER_CFG_32_BIT_TIMER;
+    TIMER0_TAMR_R = TIMER_TAMR_TAMR_1_SHOT;
+    TIMER0_IMR_R = TIMER_IMR_TATOIM;
+    NVIC_EN0_R = NVIC_EN0_INT19;
+    EnableInterrupts();
+    for (i = 0; i < 100; i++) {
+        TIMER0_TAILR_R = 100 + rnd() % (IRQ_REGION - 200);
+        TIMER0_CTL_R = TIMER_CTL_TAEN;
+        PROFILE_START(PROF_IRQ);
+        CPU_CYCLES(IRQ_REGION);
+        PROFILE_STOP(PROF_IRQ);
+    }
+    inside = Profile_Regions[PROF_IRQ].Min - IRQ_REGION;
+    if (Irqs != 100 || Profile_Regions[PROF_IRQ].Max != Profile_Regions[PROF_IRQ].Min || inside < 100) {
+        error("interrupted region", Profile_Regions[PROF_IRQ].Max, IRQ_REGION);
+    }
+    printf("interrupt_in_region %lu\n", inside);
+
+    // clearing keeps the names
+    Profile_Clear();
+    if (g->Count || g->Total || g->Max || g->Min != 0xFFFFFFFF || !g->Name || strcmp(g->Name, "known")) {
+        error("clear", g->Count, 0);
+    }
+    printf("errors %lu\n", Errors);
+    return Errors != 0;
+}
+
+static double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int bench(unsigned long probes) {
+    unsigned long i;
+    unsigned long long c0;
+    double t0;
+    PROFILE_INIT();
+    PROFILE_NAME(PROF_BENCH, "bench");
+    c0 = Mmio_Cycles();
+    t0 = seconds();
+    for (i = 0; i < probes; i++) {
+        PROFILE_START(PROF_BENCH);
+        PROFILE_STOP(PROF_BENCH);
+    }
+    printf("probes %lu\n", probes);
+    printf("overhead %lu\n", Profile_Overhead);
+    printf("cycles_per_pair %.2f\n", (double)(Mmio_Cycles() - c0) / probes);
+    printf("host_ns_per_pair %.2f\n", (seconds() - t0) * 1e9 / probes);
+    Profile_Clear();
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 2 && !strcmp(argv[1], "-b")) {
+        return bench(argc >= 3 ? strtoul(argv[2], 0, 0) : BENCH_PROBES);
+    }
+    if (argc > 1) {
+        fprintf(stderr, "usage: %s\n       %s -b [probes]\n", argv[0], argv[0]);
+        return 2;
+    }
+    return check();
+}
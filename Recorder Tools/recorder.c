@@ -0,0 +1,117 @@
+/** @file   recorder.c
+ *  @brief  Host-side stress check of the ring-buffer recorder in
+ *          Common/Recorder.c. The producer is a SIGALRM handler that fires
+ *          every 10 us and records a burst of events; it preempts the main
+ *          loop at any instruction, as an interrupt handler does on the
+ *          LaunchPad, while the main loop drains the buffer in random
+ *          amounts and now and then stalls so that it fills up. Each event
+ *          carries its sequence number as its time and the number's
+ *          complement as its data, so a torn or stale slot shows. Both modes
+ *          are run. The check passes if every event comes out once, in
+ *          order and intact, or is counted as lost (wrap mode) or dropped
+ *          (stop mode), and exits with 1 otherwise.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+#include "Recorder.h"
+
+#define CAPACITY        64          // small, so that it fills up often
+#define INTERVAL_US     50
+#define DRAIN_MAX       8
+
+static Recorder Rec;
+static Event Storage[CAPACITY];
+static volatile unsigned long long Produced;     // sequence number of the next event
+static unsigned long long Target;
+
+/* Cheap deterministic random numbers, one generator for each side */
+static unsigned long rnd(unsigned long *seed) {
+    *seed = *seed * 1103515245UL + 12345UL;
+    return (*seed >> 16) & 0x7FFF;
+}
+static unsigned long ProducerSeed = 1, ConsumerSeed = 2;
+
+static void producer(int sig) {
+    unsigned long n = 1 + rnd(&ProducerSeed) % 16;
+    (void)sig;
+    while (n-- > 0 && Produced < Target) {
+        Recorder_Record(&Rec, Produced, (unsigned long)~Produced);
+        Produced++;
+    }
+}
+
+static void timer(long us) {
+    struct itimerval t;
+    memset(&t, 0, sizeof(t));
+    t.it_interval.tv_usec = t.it_value.tv_usec = us;
+    setitimer(ITIMER_REAL, &t, 0);
+}
+
+/* Runs one mode and returns the number of errors */
+static unsigned long run(int mode, const char *name) {
+    Event out[DRAIN_MAX];
+    unsigned long long delivered = 0, gaps = 0, next = 0;
+    unsigned long errors = 0, i, n, spin;
+    volatile unsigned long sink = 0;
+    Recorder_Init(&Rec, Storage, CAPACITY, mode);
+    Produced = 0;
+    timer(INTERVAL_US);
+    for (;;) {
+        int done = Produced >= Target;     // read first: after it, nothing more comes
+        if (done) {
+            timer(0);
+        }
+        n = Recorder_Drain(&Rec, out, 1 + rnd(&ConsumerSeed) % DRAIN_MAX);
+        for (i = 0; i < n; i++) {
+            if (out[i].Time < next || out[i].Data != (unsigned long)~out[i].Time) {
+                if (errors++ < 10) {
+                    printf("%s: event %llu, data %lx, expected from %llu\n",
+                           name, out[i].Time, out[i].Data, next);
+                }
+            } else {
+                gaps += out[i].Time - next;
+            }
+            next = out[i].Time + 1;
+        }
+        delivered += n;
+        if (done && !n) {
+            break;
+        }
+        if (rnd(&ConsumerSeed) % 64 == 0) {
+            for (spin = rnd(&ConsumerSeed) * 8; spin > 0; spin--) {
+                sink += spin;               // stall, so the buffer fills
+            }
+        }
+    }
+    gaps += Produced - next;                // events after the last one out
+    if (mode == RECORDER_WRAP ? gaps != Rec.Lost : gaps != Rec.Dropped) {
+        errors++;
+        printf("%s: %llu events missing, %lu counted\n", name, gaps,
+               mode == RECORDER_WRAP ? Rec.Lost : Rec.Dropped);
+    }
+    if (delivered + (mode == RECORDER_WRAP ? Rec.Lost : Rec.Dropped) != Produced) {
+        errors++;
+        printf("%s: %llu out and %lu missing of %llu\n", name, delivered,
+               mode == RECORDER_WRAP ? Rec.Lost : Rec.Dropped, Produced);
+    }
+    printf("%s: %llu events, %llu out, %lu lost, %lu dropped\n",
+           name, Produced, delivered, Rec.Lost, Rec.Dropped);
+    return errors;
+}
+
+int main(int argc, char **argv) {
+    unsigned long errors;
+    Target = argc > 1 ? strtoull(argv[1], 0, 0) : 1000000ULL;
+    signal(SIGALRM, producer);
+    errors = run(RECORDER_WRAP, "wrap") + run(RECORDER_STOP, "stop");
+    if (errors) {
+        printf("errors: %lu\n", errors);
+    }
+    return errors != 0;
+}
@@ -7,26 +7,31 @@
  * 		- O: toggle light 3 times with 2 sec gap between on/off
  * 		- S: toggle light 3 times with 1/2 sec gap between on/off
  * 		- 5 second delay between SOS messages
- * 		Pressing SW2 stops SOS.
+ * 		Pressing SW2 stops SOS after the message being sent.
+ * 		The switches are debounced by Common/Debounce.c, so a press is
+ * 		seen once even if it ends while the LED is flashing.
  *  @author 	Mustafa Siddiqui
  *  @date 	06/25/20
  */
 
-/* Define Ports */
-#define GPIO_PORTF_DATA_R	(*((volatile unsigned long*)0x400253FC))
-#define GPIO_PORTF_DIR_R	(*((volatile unsigned long*)0x40025400))
-#define GPIO_PORTF_AFSEL_R	(*((volatile unsigned long*)0x40025420))
-#define GPIO_PORTF_PUR_R	(*((volatile unsigned long*)0x40025510))
-#define GPIO_PORTF_DEN_R	(*((volatile unsigned long*)0x4002551C))
-#define GPIO_PORTF_LOCK_R	(*((volatile unsigned long*)0x40025520))
-#define GPIO_PORTF_CR_R		(*((volatile unsigned long*)0x40025524))
-#define GPIO_PORTF_AMSEL_R	(*((volatile unsigned long*)0x40025528))
-#define GPIO_PORTF_PCTL_R	(*((volatile unsigned long*)0x4002552C))
-#define SYSCTL_RCGC2_R		(*((volatile unsigned long*)0x400FE108))
+#include "../Common/tm4c123.h"
+#include "../SysTick Timer/SysTick.h"
+#include "../SysTick Timer/Speed.h"
+#include "../Common/Clock.h"
+#include "../Common/Debounce.h"
+#include "../Common/Pin.h"
+#include "../Common/Gpio.h"
+
+/* PF4 and PF0 through their bit-specific address, sampled every 2 ms */
+const unsigned long Switches[1] = {PIN_ADDR(GPIO_PORTF_BASE, 0x11)};
+
+/* PF3 alone: turning it on or off is a single store */
+#define GREEN	PIN(GPIO_PORTF_BASE, 0x08)
 
 /* Global Variables */
-unsigned long SW1;					// input from PF4
-unsigned long SW2;					// input from PF0
+unsigned long SW1;					// SW1 (PF4) pressed
+unsigned long SW2;					// SW2 (PF0) pressed
+unsigned long HalfSecond;				// in cycles of the full-speed clock
 
 /** @fn		void portF_Init(void)
  *  @brief 	Initializes port F pins for input and output. PF4 is input
@@ -41,7 +46,8 @@ void portF_Init(void);
 void flash_SOS(void);
 
 /** @fn		void delay(unsigned long)
- *  @brief 	Subroutine to delay in units of half-seconds.
+ *  @brief 	Subroutine to delay in units of half-seconds, on the
+ * 		slowest clock for most of it.
  *  @param 	Half-seconds to be delayed for.
 */
 void delay(unsigned long halfSecs);
@@ -55,16 +61,21 @@ void delay(unsigned long halfSecs);
 int main(void) {
 	
 	portF_Init();
+	SysTick_Init();
+	HalfSecond = Clock_Hz() / 2;
+	Debounce_Start(Switches, 1, 0x11, Clock_Hz() / 500);	// negative logic
+	Speed_Init();
 	while (1) {
 		do {
-			// PF4 into SW1
-			SW1 = GPIO_PORTF_DATA_R & 0x10;
-		} while (SW1 == 0x10);
+			// sleep until SW1 is pressed
+			WaitForInterrupt();
+			SW1 = Debounce_Pressed() & 0x10;
+		} while (SW1 == 0);
 		do {
 			flash_SOS();
-			// PF0 into SW2
-			SW2 = GPIO_PORTF_DATA_R & 0x01;
-		} while (SW2 == 0x01);
+			// SW2 pressed at any time during the message
+			SW2 = Debounce_Pressed() & 0x01;
+		} while (SW2 == 0);
 	}
 	
 	return 0;
@@ -72,38 +83,11 @@ int main(void) {
 
 /* Initialize port */
 void portF_Init(void) {
-	volatile unsigned long delay;
-	
-	// F clock & delay
-	SYSCTL_RCGC2_R |= 0x00000020;
-	delay = SYSCTL_RCGC2_R;
-	
-	// unlock port F PF0
-	GPIO_PORTF_LOCK_R = 0x4C4F434B;
-	
-	// allow changes to PF4-0
-	GPIO_PORTF_CR_R |= 0x1F;
-	
-	// disable analog function
-	GPIO_PORTF_AMSEL_R &= 0x0;
+	// F clock
+	Gpio_Clocks(SYSCTL_RCGC2_GPIOF);
 	
-	// GPIO clear bit PCTL
-	GPIO_PORTF_PCTL_R &= 0x0;
-	
-	// PF4, PF0 input
-	GPIO_PORTF_DIR_R &= ~0x11;
-	
-	// PF3 output
-	GPIO_PORTF_DIR_R |= 0x08;
-	
-	// no alternate functions
-	GPIO_PORTF_AFSEL_R &= ~0x1F;
-	
-	// enable pullup resistors on PF4, PF0
-	GPIO_PORTF_PUR_R |= 0x11;
-	
-	// enable digital pins on PF4-0
-	GPIO_PORTF_DEN_R |= 0x1F;
+	// PF4, PF0 inputs with pullup resistors, PF3 output (unlocks PF0)
+	GPIO_CONFIG(F, 0x11, 0x08, 0x11, 0, 0, 0, 0);
 }
 
 /* 	Flash SOS */
@@ -120,45 +104,45 @@ void portF_Init(void) {
 void flash_SOS(void) {
 	
 	// S
-	GPIO_PORTF_DATA_R |= 0x08;
+	GREEN = 0x08;
 	delay(1);
-	GPIO_PORTF_DATA_R &= ~0x08;
+	GREEN = 0;
 	delay(1);
-	GPIO_PORTF_DATA_R |= 0x08;
+	GREEN = 0x08;
 	delay(1);
-	GPIO_PORTF_DATA_R &= ~0x08;
+	GREEN = 0;
 	delay(1);
-	GPIO_PORTF_DATA_R |= 0x08;
+	GREEN = 0x08;
 	delay(1);
-	GPIO_PORTF_DATA_R &= ~0x08;
+	GREEN = 0;
 	delay(1);
 	
 	// O
-	GPIO_PORTF_DATA_R |= 0x08;
+	GREEN = 0x08;
 	delay(4);
-	GPIO_PORTF_DATA_R &= ~0x08;
+	GREEN = 0;
 	delay(4);
-	GPIO_PORTF_DATA_R |= 0x08;
+	GREEN = 0x08;
 	delay(4);
-	GPIO_PORTF_DATA_R &= ~0x08;
+	GREEN = 0;
 	delay(4);
-	GPIO_PORTF_DATA_R |= 0x08;
+	GREEN = 0x08;
 	delay(4);
-	GPIO_PORTF_DATA_R &= ~0x08;
+	GREEN = 0;
 	delay(4);
 	
 	// S
-	GPIO_PORTF_DATA_R |= 0x08;
+	GREEN = 0x08;
 	delay(1);
-	GPIO_PORTF_DATA_R &= ~0x08;
+	GREEN = 0;
 	delay(1);
-	GPIO_PORTF_DATA_R |= 0x08;
+	GREEN = 0x08;
 	delay(1);
-	GPIO_PORTF_DATA_R &= ~0x08;
+	GREEN = 0;
 	delay(1);
-	GPIO_PORTF_DATA_R |= 0x08;
+	GREEN = 0x08;
 	delay(1);
-	GPIO_PORTF_DATA_R &= ~0x08;
+	GREEN = 0;
 	delay(1);
 	
 	// delay for 5 sec between flashes
@@ -166,17 +150,12 @@ void flash_SOS(void) {
 }
 
 /* Delay */
-/* Originally count = 400,000 which took 0.13 sec to complete
-   Changed it to 400000 * 0.5 / 0.13 = 1538460 so that it takes
-   0.5 seconds to complete.
+/* Originally a loop of 1538460 passes, measured by hand to take 0.5 sec
+   at one clock rate. Now the time is idled away on PIOSC/4, coming back
+   to full speed just before it is up.
 */
 void delay(unsigned long halfSecs) {
-	unsigned long count;
-	while (halfSecs > 0) {
-		count = 1538460;
-		while (count > 0) {
-			count--;
-		}
-		halfSecs--;
-	}
+	unsigned long long end = SysTick_Now() + (unsigned long long)halfSecs * HalfSecond;
+	Speed_Sleep(end, SPEED_PIOSC_QUARTER);
+	SysTick_WaitUntil(end);
 }
@@ -0,0 +1,82 @@
+#include "SysTick.h"
+#include "Delay.h"
+#include "../Common/Clock.h"
+
+#define SHORT_RUN       64          // passes timed by the calibration
+#define LONG_RUN        576
+#define TRIALS          5
+#define CHUNK_US        1000000     // longest single spin
+
+static unsigned long Hz;            // full-speed clock
+static unsigned long PassesPerUs;   // at full speed, 16.16 fixed point
+static unsigned long Overhead;      // cost of a call, in passes
+
+/* The delay loop. Whatever a pass costs with the compiler and clock in
+   use, Delay_Init() measures it. */
+static void spin(unsigned long passes) {
+    volatile unsigned long count = passes;
+    CPU_CYCLES(10);     // call, return and setup
+    while (count) {
+        count--;
+        CPU_CYCLES(11); // one pass of this loop
+    }
+}
+
+/* Fewest cycles out of a few tries, so that interrupts don't count. With
+   no passes, only the time it takes to read the time is measured. */
+static unsigned long timed(unsigned long passes) {
+    unsigned long best = 0xFFFFFFFF, cycles, i;
+    unsigned long long start;
+    for (i = 0; i < TRIALS; i++) {
+        start = SysTick_Now();
+        if (passes) {
+            spin(passes);
+        }
+        cycles = (unsigned long)(SysTick_Now() - start);
+        if (cycles < best) {
+            best = cycles;
+        }
+    }
+    return best;
+}
+
+/* Two run lengths give the cost per pass and the fixed cost of a call.
+   SysTick times them in full-speed cycles, 'scale' per cycle of the clock
+   they ran on; a pass takes as many cycles at any clock, so at full speed
+   it takes 'scale' times less time. */
+void Delay_Init(void) {
+    unsigned long scale = SysTick_Scale();
+    unsigned long reading = timed(0);
+    unsigned long shortRun = timed(SHORT_RUN) - reading;
+    unsigned long longRun = timed(LONG_RUN) - reading;
+    unsigned long long perPass = ((unsigned long long)(longRun - shortRun) << 16) / (LONG_RUN - SHORT_RUN);
+    // the short run less its passes; noise can make it come out negative
+    long long fixed = ((long long)shortRun << 16) - (long long)(perPass * SHORT_RUN);
+    Hz = Clock_Hz() * scale;
+    PassesPerUs = (unsigned long)(((unsigned long long)Hz << 32) / 1000000 * scale / perPass);
+    Overhead = fixed > 0 ? (unsigned long)((fixed + (long long)(perPass / 2)) / (long long)perPass) : 0;
+}
+
+void Delay_us(unsigned long us) {
+    unsigned long passes;
+    while (us > CHUNK_US) {
+        Delay_us(CHUNK_US);
+        us -= CHUNK_US;
+    }
+    passes = (unsigned long)(((unsigned long long)us * PassesPerUs / SysTick_Scale() + 0x8000) >> 16);
+    if (passes > Overhead) {
+        spin(passes - Overhead);
+    }
+}
+
+void Delay_ms(unsigned long ms) {
+    while (ms >= 1000) {
+        Delay_us(1000000);
+        ms -= 1000;
+    }
+    Delay_us(ms * 1000);
+}
+
+unsigned long Delay_Clock(void) {
+    return Hz;
+}
@@ -0,0 +1,55 @@
+/** @file   Delay.h
+ *  @brief  Busy-wait delays in microseconds and milliseconds that are right
+ *          at any clock rate. Instead of a loop count tuned by hand for one
+ *          clock, Delay_Init() reads the system clock from RCC/RCC2 and
+ *          times the delay loop against SysTick, so the same source gives
+ *          the same delays at 16, 50 or 80 MHz.
+ *
+ *          They stay right while the clock is slowed down with
+ *          SysTick_Resume(), as long as a pass of the delay loop takes as
+ *          many cycles at the slower clock.
+ *
+ *          The delays spin, so they also work with interrupts disabled and
+ *          before anything else is set up; use SysTick_Wait() to sleep
+ *          through long waits instead. Interrupts taken during a delay
+ *          lengthen it.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef DELAY_H
+#define DELAY_H
+
+/** @fn     Delay_Init(void)
+ *  @brief  Calibrates the delays for the current clock. SysTick_Init() must
+ *          have been called. Call it again after the full-speed clock
+ *          changes.
+ *  @param  NULL
+ *  @return NULL
+ */
+void Delay_Init(void);
+
+/** @fn     Delay_us(unsigned long)
+ *  @brief  Waits for the given number of microseconds. Delays come out
+ *          within half a pass of the delay loop, about 0.35 us at 16 MHz
+ *          and 0.07 us at 80 MHz, which is within 1% from 35 us and 7 us.
+ *  @param  Number of microseconds to wait.
+ *  @return NULL
+ */
+void Delay_us(unsigned long us);
+
+/** @fn     Delay_ms(unsigned long)
+ *  @brief  Waits for the given number of milliseconds, to within 1%.
+ *  @param  Number of milliseconds to wait.
+ *  @return NULL
+ */
+void Delay_ms(unsigned long ms);
+
+/** @fn     Delay_Clock(void)
+ *  @brief  Full-speed system clock that the delays were calibrated for.
+ *  @param  NULL
+ *  @return Frequency in Hz.
+ */
+unsigned long Delay_Clock(void);
+
+#endif
@@ -0,0 +1,26 @@
+#include "SysTick.h"
+#include "Periodic.h"
+
+/* Release 0 is now */
+void Periodic_Start(Periodic *p, unsigned long period) {
+    p->Period = period;
+    p->Start = p->Next = SysTick_Now();
+    p->Releases = 0;
+    p->Late = p->WorstLate = 0;
+    p->Overruns = 0;
+}
+
+/* Next deadline = previous deadline + periods, never now + periods */
+void Periodic_Wait(Periodic *p, unsigned long periods) {
+    unsigned long long woke;
+    p->Releases += periods;
+    p->Next += (unsigned long long)periods * p->Period;
+    if (SysTick_Now() >= p->Next) {
+        p->Overruns++;
+    }
+    woke = SysTick_WaitUntil(p->Next);
+    p->Late = (unsigned long)(woke - p->Next);
+    if (p->Late > p->WorstLate) {
+        p->WorstLate = p->Late;
+    }
+}
@@ -0,0 +1,45 @@
+/** @file   Periodic.h
+ *  @brief  Phase-locked periodic scheduling on top of the SysTick timebase.
+ *          Every release is an absolute deadline, a whole number of periods
+ *          after the start, so the time spent between waits (writing
+ *          outputs, reading sensors, call overhead) never adds up as drift.
+ *          The statistics show how far behind the ideal time the caller
+ *          actually woke up.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef PERIODIC_H
+#define PERIODIC_H
+
+/* State of a periodic schedule. All times are in clock cycles. */
+typedef struct {
+    unsigned long Period;           // length of one period
+    unsigned long long Start;       // time of release 0
+    unsigned long long Releases;    // periods since the start
+    unsigned long long Next;        // deadline of the latest release
+    unsigned long Late;             // how late the latest release woke up
+    unsigned long WorstLate;        // worst lateness seen so far
+    unsigned long Overruns;         // releases that were already due when waited for
+} Periodic;
+
+/** @fn     Periodic_Start(Periodic *, unsigned long)
+ *  @brief  Starts a schedule whose release 0 is now.
+ *  @param  Schedule to start.
+ *  @param  Length of a period in clock cycles.
+ *  @return NULL
+ */
+void Periodic_Start(Periodic *p, unsigned long period);
+
+/** @fn     Periodic_Wait(Periodic *, unsigned long)
+ *  @brief  Sleeps until the release the given number of periods after the
+ *          latest one, and updates the statistics. If that release is
+ *          already due it returns at once and counts an overrun, staying
+ *          in phase with the schedule.
+ *  @param  Schedule to wait on.
+ *  @param  Number of periods to advance.
+ *  @return NULL
+ */
+void Periodic_Wait(Periodic *p, unsigned long periods);
+
+#endif
@@ -0,0 +1,134 @@
+#include "SysTick.h"
+#include "Speed.h"
+#include "../Common/Clock.h"
+
+/* Running from an internal oscillator with the PLL bypassed and powered
+   down; USBPWRDN keeps the USB PLL off as it is after reset */
+#define RCC2_IDLE       (SYSCTL_RCC2_USERCC2 + SYSCTL_RCC2_USBPWRDN + SYSCTL_RCC2_PWRDN2 + SYSCTL_RCC2_BYPASS2)
+
+static unsigned long Rcc2[SPEED_LEVELS];    // RCC2 value of each level, 0 if none
+static unsigned long Scale[SPEED_LEVELS];   // full-speed clock / clock of each level
+static unsigned long Pll;                   // levels that run from the PLL, one bit each
+static unsigned long LockScale;             // scale while the PLL locks on its reference
+static unsigned long Level;
+static unsigned long long Since;            // time of the latest switch
+static unsigned long TimerPeriod;           // timer 0A period at full speed
+static SpeedStats Stats;
+
+/* Switches the clock and carries SysTick and timer 0A over to it */
+static void change(unsigned long rcc2, unsigned long scale) {
+    int timer = (SYSCTL_RCGCTIMER_R & SYSCTL_RCGCTIMER_R0) && (TIMER0_CTL_R & TIMER_CTL_TAEN);
+    if (timer && SysTick_Scale() == 1) {
+        TimerPeriod = TIMER0_TAILR_R + 1;
+    }
+    SysTick_Hold();
+    SYSCTL_RCC2_R = rcc2;
+    SysTick_Resume(scale);
+    if (timer && TimerPeriod) {
+        TIMER0_TAILR_R = TimerPeriod / scale - 1;   // restarts the period in progress
+    }
+}
+
+/* Levels are worked out from the full-speed RCC/RCC2 without touching them */
+void Speed_Init(void) {
+    unsigned long rcc = SYSCTL_RCC_R;
+    unsigned long full, hz, div, i;
+    Rcc2[SPEED_FULL] = SYSCTL_RCC2_R;
+    Rcc2[SPEED_PLL_QUARTER] = 0;
+    full = Clock_HzOf(rcc, Rcc2[SPEED_FULL]);
+    Pll = 0;
+    if ((Rcc2[SPEED_FULL] & (SYSCTL_RCC2_USERCC2 + SYSCTL_RCC2_BYPASS2 + SYSCTL_RCC2_PWRDN2)) == SYSCTL_RCC2_USERCC2) {
+        // on the PLL: 400 MHz divided by 'div'
+        div = (Rcc2[SPEED_FULL] & SYSCTL_RCC2_DIV400) ? ((Rcc2[SPEED_FULL] >> 22) & 0x7F) + 1
+                                                     : 2 * (((Rcc2[SPEED_FULL] >> 23) & 0x3F) + 1);
+        if (4 * div <= 128) {
+            Rcc2[SPEED_PLL_QUARTER] = (Rcc2[SPEED_FULL] & ~(SYSCTL_RCC2_DIV400 + SYSCTL_RCC2_SYSDIV2_M + SYSCTL_RCC2_SYSDIV2LSB))
+                                      + SYSCTL_RCC2_DIV400 + ((4 * div - 1) << 22);
+        }
+        Pll = (1 << SPEED_FULL) | (1 << SPEED_PLL_QUARTER);
+        hz = Clock_HzOf(rcc, Rcc2[SPEED_FULL] + SYSCTL_RCC2_BYPASS2);
+        LockScale = full % hz == 0 ? full / hz : 0;
+    }
+    if (!Pll || LockScale) {
+        // the PLL can only be powered down if it can be brought back
+        Rcc2[SPEED_PIOSC] = RCC2_IDLE + SYSCTL_RCC2_OSCSRC2_IO;
+        Rcc2[SPEED_PIOSC_QUARTER] = RCC2_IDLE + SYSCTL_RCC2_OSCSRC2_IO4;
+    } else {
+        Rcc2[SPEED_PIOSC] = Rcc2[SPEED_PIOSC_QUARTER] = 0;
+    }
+    for (i = 0; i < SPEED_LEVELS; i++) {
+        hz = Rcc2[i] ? Clock_HzOf(rcc, Rcc2[i]) : 0;
+        Stats.Hz[i] = hz && full % hz == 0 ? hz : 0;    // time must scale exactly
+        Scale[i] = Stats.Hz[i] ? full / hz : 0;
+        Stats.Latency[i] = Stats.WorstLatency[i] = Stats.WorstRestore[i] = 0;
+    }
+    Level = SPEED_FULL;
+    for (i = 1; i < SPEED_LEVELS; i++) {
+        if (Speed_Set(i)) {
+            Speed_Set(SPEED_FULL);      // times the way there and back
+        }
+    }
+    for (i = 0; i < SPEED_LEVELS; i++) {
+        Stats.Residency[i] = 0;
+        Stats.Switches[i] = 0;
+    }
+    Since = SysTick_Now();
+}
+
+/* A switch counts toward the level it leaves. Bringing the PLL back goes
+   through its reference clock until it has locked again. */
+int Speed_Set(unsigned long level) {
+    unsigned long long start, end;
+    unsigned long took, from = Level;
+    if (level >= SPEED_LEVELS || !Stats.Hz[level]) {
+        return 0;
+    }
+    if (level == from) {
+        return 1;
+    }
+    start = SysTick_Now();
+    if (((Pll >> level) & 1) && !((Pll >> from) & 1)) {
+        SYSCTL_MISC_R = SYSCTL_MISC_PLLLMIS;        // clear the lock from before
+        change(Rcc2[level] + SYSCTL_RCC2_BYPASS2, LockScale);
+        while ((SYSCTL_RIS_R & SYSCTL_RIS_PLLLRIS) == 0) {}
+    }
+    change(Rcc2[level], Scale[level]);
+    Level = level;
+    end = SysTick_Now();
+    took = (unsigned long)(end - start);
+    Stats.Residency[from] += end - Since;
+    Since = end;
+    Stats.Switches[level]++;
+    Stats.Latency[level] = took;
+    if (took > Stats.WorstLatency[level]) {
+        Stats.WorstLatency[level] = took;
+    }
+    if (level == SPEED_FULL && took > Stats.WorstRestore[from]) {
+        Stats.WorstRestore[from] = took;
+    }
+    return 1;
+}
+
+/* Sleeping low only pays if it lasts well beyond the way back */
+void Speed_Sleep(unsigned long long deadline, unsigned long level) {
+    unsigned long long back = 2 * (unsigned long long)Stats.WorstRestore[level];
+    if (deadline > SysTick_Now() + 2 * back && Speed_Set(level)) {
+        SysTick_WaitUntil(deadline - back);
+    }
+    Speed_Set(SPEED_FULL);
+}
+
+void Speed_SleepEvent(unsigned long long deadline, unsigned long level, volatile unsigned long *event) {
+    unsigned long long back = 2 * (unsigned long long)Stats.WorstRestore[level];
+    if (!*event && deadline > SysTick_Now() + 2 * back && Speed_Set(level)) {
+        SysTick_WaitEvent(deadline - back, event);
+    }
+    Speed_Set(SPEED_FULL);
+}
+
+const SpeedStats *Speed_Stats(void) {
+    unsigned long long now = SysTick_Now();
+    Stats.Residency[Level] += now - Since;
+    Since = now;
+    return &Stats;
+}
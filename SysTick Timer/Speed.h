@@ -0,0 +1,90 @@
+/** @file   Speed.h
+ *  @brief  Runs the system clock slower while the program is idle. Speed
+ *          levels range from the full-speed clock set up before
+ *          Speed_Init() (the PLL, or the reset clock) down to the internal
+ *          oscillator divided by 4 with the PLL powered down. Every switch
+ *          carries SysTick over with SysTick_Hold()/SysTick_Resume(), so
+ *          SysTick time, waits, Periodic schedules and Delay_us() stay in
+ *          full-speed cycles and keep their timing, and the period of
+ *          timer 0A (the debouncer) is rescaled with it.
+ *
+ *          The time spent at each level and how long switches take are
+ *          kept in SpeedStats. Coming back to a PLL clock after it was
+ *          powered down waits for it to lock again, about 0.5 ms;
+ *          Speed_Sleep() wakes early enough to be back at full speed by
+ *          its deadline.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef SPEED_H
+#define SPEED_H
+
+/* Speed levels, fastest first */
+#define SPEED_FULL              0   // the clock at Speed_Init()
+#define SPEED_PLL_QUARTER       1   // the PLL divided 4 times further, still locked
+#define SPEED_PIOSC             2   // 16 MHz internal oscillator, PLL off
+#define SPEED_PIOSC_QUARTER     3   // 4 MHz internal oscillator, PLL off
+#define SPEED_LEVELS            4
+
+/* Times are SysTick times, in full-speed cycles */
+typedef struct {
+    unsigned long Hz[SPEED_LEVELS];                 // clock of each level, 0 if not available
+    unsigned long long Residency[SPEED_LEVELS];     // time at each level, switches counting toward the level left
+    unsigned long Switches[SPEED_LEVELS];           // switches to each level
+    unsigned long Latency[SPEED_LEVELS];            // latest switch to each level took
+    unsigned long WorstLatency[SPEED_LEVELS];       // longest switch to each level
+    unsigned long WorstRestore[SPEED_LEVELS];       // longest switch from each level back to full speed
+} SpeedStats;
+
+/** @fn     Speed_Init(void)
+ *  @brief  Takes the current clock as full speed and works out the other
+ *          levels. A level is left out if it needs a PLL the full-speed
+ *          clock does not use, or if it does not divide the full-speed
+ *          clock exactly. Each level is then tried once, to time the way
+ *          there and back. SysTick_Init() must have been called.
+ *  @param  NULL
+ *  @return NULL
+ */
+void Speed_Init(void);
+
+/** @fn     Speed_Set(unsigned long)
+ *  @brief  Switches the system clock to the given level.
+ *  @param  SPEED_FULL to SPEED_PIOSC_QUARTER.
+ *  @return 1 if the clock now runs at that level, 0 if it is not available.
+ */
+int Speed_Set(unsigned long level);
+
+/** @fn     Speed_Sleep(unsigned long long, unsigned long)
+ *  @brief  Sleeps at the given level, and switches back to full speed in
+ *          time for the deadline, leaving twice the longest restore seen
+ *          so far. Returns at full speed at once if the wait is too short
+ *          to be worth it, and otherwise before the deadline: follow it
+ *          with the wait for the deadline itself.
+ *  @param  Deadline, in SysTick time.
+ *  @param  Level to sleep at.
+ *  @return NULL
+ */
+void Speed_Sleep(unsigned long long deadline, unsigned long level);
+
+/** @fn     Speed_SleepEvent(unsigned long long, unsigned long, volatile unsigned long *)
+ *  @brief  As Speed_Sleep(), but also wakes when an interrupt handler makes
+ *          the word non-zero, see SysTick_WaitEvent(). It does not sleep at
+ *          all if the word is already set. The switch back to full speed
+ *          then takes up to the longest restore after the word was set.
+ *  @param  Deadline, in SysTick time.
+ *  @param  Level to sleep at.
+ *  @param  Word that ends the sleep when it is not 0.
+ *  @return NULL
+ */
+void Speed_SleepEvent(unsigned long long deadline, unsigned long level, volatile unsigned long *event);
+
+/** @fn     Speed_Stats(void)
+ *  @brief  Residency and switch times, with the current level counted up
+ *          to now.
+ *  @param  NULL
+ *  @return The statistics.
+ */
+const SpeedStats *Speed_Stats(void);
+
+#endif
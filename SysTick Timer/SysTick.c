@@ -1,21 +1,251 @@
 #include "SysTick.h"
+#include "../Common/Clock.h"
+
+#define MAX_PERIOD      0x01000000UL    // longest period, 2^24 cycles
+#define MIN_PERIOD      1024            // shortest period the handler can keep up with
+#define FOLLOW_UP       4096            // period after a wait expires
+#define MARGIN          256             // cycles needed to reprogram before a wrap
+#define RESYNC_CYCLES   2               // from reading CURRENT to its reload
+#define NO_DEADLINE     0xFFFFFFFFFFFFFFFFULL
+
+/* The counter counts every period down to zero and interrupts there.
+   Periods are pipelined: 'Running' is the one counting now, which started
+   at cycle 'Base', and 'Loaded' sits in RELOAD for the one after it.
+   Periods are in counter ticks, which are 'Scale' cycles of time each
+   while the clock runs slower than it did at scale 1 (SysTick_Resume()).
+   'Sequence' changes whenever any of them do, so SysTick_Now() can read
+   them without disabling interrupts. */
+static volatile unsigned long long Base;
+static volatile unsigned long Running;
+static volatile unsigned long Loaded;
+static volatile unsigned long Scale = 1;
+static volatile unsigned long Sequence;
+static volatile unsigned long long Deadline = NO_DEADLINE;
+static unsigned long long (*Alarm)(unsigned long long now);
+
+/* Length in ticks of the period starting at the given cycle. A deadline
+   between two ticks ends the period on the one before it. */
+static unsigned long choose(unsigned long long start) {
+    unsigned long long left;
+    if (Deadline == NO_DEADLINE) {
+        return MAX_PERIOD;              // tickless: only extend the counter
+    }
+    if (Deadline <= start) {
+        return FOLLOW_UP;               // room for the waiter to arm again
+    }
+    left = (Deadline - start) / Scale;
+    if (left > MAX_PERIOD) {
+        // never leave a remainder too short to program
+        return left < MAX_PERIOD + MIN_PERIOD ? (unsigned long)(left / 2) : MAX_PERIOD;
+    }
+    return left < MIN_PERIOD ? MIN_PERIOD : (unsigned long)left;
+}
+
+/* Cycles since SysTick_Init(). Interrupts must be disabled and the
+   counter must not be about to wrap. */
+static unsigned long long now(unsigned long current) {
+    return Base + (unsigned long long)(Running - current) * Scale;
+}
+
+/* Reads CURRENT with interrupts disabled, letting the handler run first
+   if the counter has wrapped or is within MARGIN cycles of doing so */
+static unsigned long settle(void) {
+    unsigned long current;
+    DisableInterrupts();
+    while ((current = NVIC_ST_CURRENT_R) < MARGIN ||
+           (NVIC_INT_CTRL_R & NVIC_INT_CTRL_PENDSTSET)) {
+        EnableInterrupts();
+        DisableInterrupts();
+    }
+    return current;
+}
+
+/* Ends the running period early, at the deadline: restarts the counter,
+   reading it right before the clear so no cycles go missing in between.
+   'start' is the time now, 'end' that of the end of the running period. */
+static void restart(unsigned long long start, unsigned long long end) {
+    unsigned long current;
+    Running = choose(start + RESYNC_CYCLES * Scale);
+    NVIC_ST_RELOAD_R = Running - 1;
+    current = NVIC_ST_CURRENT_R;
+    NVIC_ST_CURRENT_R = 0;              // reloads on the next clock
+    Base = end - (unsigned long long)(current - RESYNC_CYCLES) * Scale;
+    while (NVIC_ST_CURRENT_R == 0) {}
+    Loaded = choose(Base + (unsigned long long)Running * Scale);
+    NVIC_ST_RELOAD_R = Loaded - 1;
+}
+
+/* Makes the given cycle the end of a period. Returns 0 if it has passed.
+   An earlier deadline already armed stays. */
+static int arm(unsigned long long deadline) {
+    unsigned long current = settle();
+    unsigned long long start = now(current);
+    unsigned long long end = Base + (unsigned long long)Running * Scale;  // start of the loaded period
+    if (deadline >= Deadline) {
+        EnableInterrupts();
+        return 1;
+    }
+    if (deadline <= start + (unsigned long long)MIN_PERIOD * Scale) {
+        EnableInterrupts();
+        return 0;
+    }
+    Deadline = deadline;
+    if (deadline >= end + (unsigned long long)Loaded * Scale) {
+        // the handler programs it when the loaded period starts
+    } else if (deadline >= end + (unsigned long long)MIN_PERIOD * Scale) {
+        Loaded = (unsigned long)((deadline - end) / Scale);
+        NVIC_ST_RELOAD_R = Loaded - 1;
+    } else {
+        restart(start, end);            // due before the running period ends
+    }
+    Sequence++;
+    EnableInterrupts();
+    return 1;
+}
+
+/* Absolute time, counted in cycles since SysTick_Init(). Lock-free: if
+   the handler runs in between, the sequence number changes and the read
+   is retried. A wrap the handler has not seen yet (interrupts disabled)
+   shows as a pending SysTick interrupt, and CURRENT has then already
+   reloaded with the loaded period. */
+unsigned long long SysTick_Now(void) {
+    unsigned long seq, pending, current, scale;
+    unsigned long long t;
+    for (;;) {
+        seq = Sequence;
+        pending = NVIC_INT_CTRL_R & NVIC_INT_CTRL_PENDSTSET;
+        current = NVIC_ST_CURRENT_R;
+        if ((NVIC_INT_CTRL_R & NVIC_INT_CTRL_PENDSTSET) != pending) {
+            continue;                   // wrapped while reading CURRENT
+        }
+        scale = Scale;
+        t = Base + (unsigned long long)Running * scale;
+        if (!pending) {
+            t -= (unsigned long long)current * scale;
+        } else if (current) {
+            t += (unsigned long long)(Loaded - current) * scale;
+        }
+        if (seq == Sequence) {
+            return t;
+        }
+    }
+}
+
+/* Sleeps until the deadline unless it is too close to be worth it */
+unsigned long long SysTick_WaitUntil(unsigned long long deadline) {
+    unsigned long long t;
+    if (arm(deadline)) {
+        DisableInterrupts();
+        while (Deadline != NO_DEADLINE) {
+            WaitForInterrupt();         // wakes on the pending interrupt
+            EnableInterrupts();
+            DisableInterrupts();
+        }
+        EnableInterrupts();
+    }
+    while ((t = SysTick_Now()) < deadline) {}
+    return t;
+}
+
+/* The same sleep, also ended by the word. A deadline left armed when an
+   event ends the wait is dropped. */
+unsigned long long SysTick_WaitEvent(unsigned long long deadline, volatile unsigned long *event) {
+    unsigned long long t;
+    if (deadline == NO_DEADLINE || arm(deadline)) {
+        DisableInterrupts();
+        while (!*event && (Deadline != NO_DEADLINE || deadline == NO_DEADLINE)) {
+            WaitForInterrupt();
+            EnableInterrupts();
+            DisableInterrupts();
+        }
+        Deadline = NO_DEADLINE;
+        EnableInterrupts();
+    }
+    do {
+        t = SysTick_Now();
+    } while (!*event && t < deadline);
+    return t;
+}
+
+int SysTick_Alarm(unsigned long long deadline) {
+    return arm(deadline);
+}
+
+void SysTick_OnAlarm(unsigned long long (*alarm)(unsigned long long now)) {
+    Alarm = alarm;
+}
 
 /* Initialize SysTick */
-void SysTick_init(void) {
-    NVIC_ST_CTRL_R = 0;             // disable SysTick during setup
-    NVIC_ST_CTRL_R = 0x00000005;    // enable SysTick with core clock
+void SysTick_Init(void) {
+    NVIC_ST_CTRL_R = 0;                 // disable SysTick during setup
+    Base = 0;
+    Scale = 1;
+    Running = Loaded = MAX_PERIOD;
+    Deadline = NO_DEADLINE;
+    NVIC_ST_RELOAD_R = MAX_PERIOD - 1;
+    NVIC_ST_CURRENT_R = 0;              // any value written to the register clears it
+    NVIC_ST_CTRL_R = NVIC_ST_CTRL_ENABLE + NVIC_ST_CTRL_INTEN + NVIC_ST_CTRL_CLK_SRC;
+    EnableInterrupts();
 }
 
 /* The delay parameter is in units of the 80 MHz core clock. (12.5 ns) */
 void SysTick_Wait(unsigned long delay) {
-    NVIC_ST_RELOAD_R = delay - 1;                   // number of counts to wait
-    NVIC_ST_CURRENT_R = 0;                          // any value written to the register clears it
-    while ((NVIC_ST_CTRL_R & 0x00010000) == 0) {}   // wait for count flag (bit #4)
+    SysTick_WaitUntil(SysTick_Now() + delay);
 }
 
-/* 800000 * 12.5 ns = 10 ms */
+/* 10 ms of the clock in use, counted in full-speed cycles like all times */
 void SysTick_Wait10ms(unsigned long delay) {
-    for (unsigned long i = 0; i < delay; i++) {
-        SysTick_Wait(800000);       // wait 10 ms
+    unsigned long long tenMs = (unsigned long long)(Clock_Hz() / 100) * Scale;
+    SysTick_WaitUntil(SysTick_Now() + delay * tenMs);
+}
+
+void SysTick_Handler(void) {
+    unsigned long long end;
+    Base += (unsigned long long)Running * Scale;
+    Running = Loaded;                   // already counting
+    if (Base + Scale > Deadline) {
+        Deadline = NO_DEADLINE;         // wakes the waiting caller
+        if (Alarm) {
+            Deadline = Alarm(Base);
+            end = Base + (unsigned long long)Running * Scale;
+            if (Deadline < end + (unsigned long long)MIN_PERIOD * Scale) {
+                // due before the next period could end on it
+                // the counter has only just reloaded, so it is far from zero
+                restart(end - (unsigned long long)NVIC_ST_CURRENT_R * Scale, end);
+                Sequence++;
+                return;
+            }
+        }
     }
+    Loaded = choose(Base + (unsigned long long)Running * Scale);
+    NVIC_ST_RELOAD_R = Loaded - 1;
+    Sequence++;
+}
+
+/* Keeps the counter from wrapping until SysTick_Resume() */
+void SysTick_Hold(void) {
+    settle();
+}
+
+/* Everything counted since the hold is taken at the old scale: call it
+   right after the clock switch. The period is then restarted at the new
+   scale, the same way arm() does. */
+void SysTick_Resume(unsigned long scale) {
+    unsigned long current = NVIC_ST_CURRENT_R;
+    unsigned long long t = now(current);
+    Scale = scale;
+    Running = choose(t + RESYNC_CYCLES * scale);
+    NVIC_ST_RELOAD_R = Running - 1;
+    t += (unsigned long long)(current - NVIC_ST_CURRENT_R) * scale;
+    NVIC_ST_CURRENT_R = 0;              // reloads on the next clock
+    Base = t + RESYNC_CYCLES * scale;
+    while (NVIC_ST_CURRENT_R == 0) {}
+    Loaded = choose(Base + (unsigned long long)Running * scale);
+    NVIC_ST_RELOAD_R = Loaded - 1;
+    Sequence++;
+    EnableInterrupts();
+}
+
+unsigned long SysTick_Scale(void) {
+    return Scale;
 }
@@ -1,6 +1,11 @@
 /** @file   SysTick.h
  *  @brief  Header file for functions related to the SysTick timer present
  *          on Cortex M microcontrollers.
+ *
+ *          SysTick runs as an interrupt-driven, tickless timebase: the
+ *          counter is never stopped or cleared while waiting, and the
+ *          interrupt only fires when a wait expires or the 24-bit counter
+ *          has to be extended. Waiting callers sleep with WFI in between.
  *  @author Mustafa Siddiqui
  *  @date   07/15/2020
  */
@@ -8,31 +13,123 @@
 #ifndef SYSTICK_H
 #define SYSTICK_H
 
-/* Define registers */
-#define NVIC_ST_CTRL_R      (*((volatile unsigned long*)0xE000E010))
-#define NVIC_ST_RELOAD_R    (*((volatile unsigned long*)0xE000E014))
-#define NVIC_ST_CURRENT_R   (*((volatile unsigned long*)0xE000E018))
+#include "../Common/tm4c123.h"
 
-/** @fn     SysTick_init(void)
- *  @brief  Initializes SysTick to be used with the system clock.
+/** @fn     SysTick_Init(void)
+ *  @brief  Initializes SysTick to run from the system clock with its
+ *          interrupt enabled, and enables interrupts.
  *  @param  NULL
  *  @return NULL
  */
-void SysTick_init(void);
+void SysTick_Init(void);
+
+/** @fn     SysTick_Now(void)
+ *  @brief  Reads the time since SysTick_Init() in clock cycles as a 64-bit
+ *          count that never wraps (7000 years at 80 MHz). While the clock
+ *          is slowed down with SysTick_Resume(), time still counts in
+ *          cycles of the full-speed clock. Lock-free and safe
+ *          to call with interrupts disabled or from handlers of lower
+ *          priority than SysTick, which must stay the highest priority.
+ *          The handler must not be held off for more than one wrap: keep
+ *          interrupts disabled for less than 1024 cycles.
+ *  @param  NULL
+ *  @return Number of cycles.
+ */
+unsigned long long SysTick_Now(void);
+
+/** @fn     SysTick_WaitUntil(unsigned long long)
+ *  @brief  Waits until the given absolute time. The deadline does not
+ *          depend on when the function is called, so waits chained from
+ *          one deadline to the next never drift.
+ *  @param  Time to wake up, in cycles since SysTick_Init().
+ *  @return The time the caller actually woke up.
+ */
+unsigned long long SysTick_WaitUntil(unsigned long long deadline);
+
+/** @fn     SysTick_WaitEvent(unsigned long long, volatile unsigned long *)
+ *  @brief  Waits until the given absolute time, or until an interrupt
+ *          handler makes the word non-zero, whichever comes first. The word
+ *          is checked with interrupts disabled before each sleep, so a
+ *          handler setting it just before is not missed.
+ *  @param  Time to wake up, in cycles since SysTick_Init(), or all ones
+ *          to wait for the word alone.
+ *  @param  Word that ends the wait when it is not 0.
+ *  @return The time the caller woke up.
+ */
+unsigned long long SysTick_WaitEvent(unsigned long long deadline, volatile unsigned long *event);
+
+/** @fn     SysTick_Alarm(unsigned long long)
+ *  @brief  Arms the SysTick interrupt for an absolute time without waiting
+ *          for it, unless an earlier time is armed already. When it comes,
+ *          the handler calls the function set with SysTick_OnAlarm(). For
+ *          a scheduler, which must not also use the waits here.
+ *  @param  Time, in cycles since SysTick_Init().
+ *  @return 0 if the time is less than about a thousand cycles away, too
+ *          close to be armed, otherwise 1.
+ */
+int SysTick_Alarm(unsigned long long deadline);
+
+/** @fn     SysTick_OnAlarm(unsigned long long (*)(unsigned long long))
+ *  @brief  Sets the function the SysTick handler calls when an alarm is
+ *          due. It gets the time the alarm was due and returns the next
+ *          time to arm, or all ones for none.
+ *  @param  Function, or 0 for none.
+ *  @return NULL
+ */
+void SysTick_OnAlarm(unsigned long long (*alarm)(unsigned long long now));
 
 /** @fn     SysTick_Wait(unsigned long)
- *  @brief  Given that the system is running on an 80 MHz clock, this function
- *          causes a delay of 12.5 ns.
+ *  @brief  Waits for the given number of clock cycles (12.5 ns each at
+ *          80 MHz). Sleeps until the SysTick interrupt for anything longer
+ *          than a few hundred cycles.
  *  @param  Number of bus cycles to wait.
  *  @return NULL
  */
 void SysTick_Wait(unsigned long delay);
 
 /** @fn     SysTick_Wait10ms(unsigned long)
- *  @brief  This function causes a delay of 10 ms. It makes use of SysTick_Wait().
+ *  @brief  This function causes a delay of a multiple of 10 ms at the
+ *          system clock in use, read with Clock_Hz(). The whole delay is a
+ *          single wait, so the SysTick interrupt only fires when the 24-bit
+ *          counter wraps.
  *  @param  The number of '10 ms' to be delayed.
  *  @return NULL
  */
 void SysTick_Wait10ms(unsigned long delay);
 
+/** @fn     SysTick_Hold(void)
+ *  @brief  Disables interrupts, first letting the handler run if the
+ *          counter is about to wrap, so the system clock can be switched.
+ *          Call SysTick_Resume() right after the switch.
+ *  @param  NULL
+ *  @return NULL
+ */
+void SysTick_Hold(void);
+
+/** @fn     SysTick_Resume(unsigned long)
+ *  @brief  Carries the time base over a switch of the system clock and
+ *          enables interrupts again. Time keeps counting in cycles of the
+ *          full-speed clock, each counter tick now being 'scale' of them,
+ *          and waits end on the tick at or just before their deadline.
+ *          Each switch may shift the time by the few ticks between the
+ *          switch and this call.
+ *  @param  Full-speed clock divided by the new clock, 1 at full speed.
+ *  @return NULL
+ */
+void SysTick_Resume(unsigned long scale);
+
+/** @fn     SysTick_Scale(void)
+ *  @brief  Cycles of time per counter tick, as last set by SysTick_Resume().
+ *  @param  NULL
+ *  @return Full-speed clock divided by the current clock.
+ */
+unsigned long SysTick_Scale(void);
+
+/** @fn     SysTick_Handler(void)
+ *  @brief  SysTick interrupt handler. Accounts for the period that just
+ *          ended, wakes a wait that expired and programs the next period.
+ *  @return NULL
+ */
+void SysTick_Handler(void);
+
 #endif
@@ -0,0 +1,180 @@
+#include "SysTick.h"
+#include "Wheel.h"
+
+#define MASK            (WHEEL_SLOTS - 1)
+#define TOP             (WHEEL_LEVELS - 1)
+
+static WheelTimer *Slots[WHEEL_LEVELS * WHEEL_SLOTS];
+static unsigned long Used[WHEEL_LEVELS];    // bit s: slot s of the level has timers
+static unsigned long long Ticks;            // the latest tick done
+static unsigned long long Start;            // time of tick 0
+static unsigned long Tick;                  // cycles per tick
+
+/* Position of the lowest bit set in a non-zero word, by multiplying that
+   bit with a de Bruijn sequence: no loop and no CLZ needed */
+static const unsigned char Lowest[32] = {
+    0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+    31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+};
+static unsigned long lowest(unsigned long word) {
+    return Lowest[(((word & (0 - word)) * 0x077CB531UL) & 0xFFFFFFFFUL) >> 27];
+}
+
+/* The level is the one whose slots are as long as the time left allows:
+   level 0 for the next 32 ticks, level 1 for the next 1024, and so on.
+   A timer due beyond the top level comes up early there, and is just put
+   back in when it does. */
+static void insert(WheelTimer *t) {
+    unsigned long long left = t->Expires - Ticks;
+    unsigned long level = 0;
+    while (level < TOP && (left >> (WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    t->Slot = level * WHEEL_SLOTS + ((unsigned long)(t->Expires >> (WHEEL_BITS * level)) & MASK);
+    t->Next = Slots[t->Slot];
+    if (t->Next) {
+        t->Next->Prev = &t->Next;
+    }
+    Slots[t->Slot] = t;
+    t->Prev = &Slots[t->Slot];
+    Used[level] |= 1UL << (t->Slot & MASK);
+}
+
+static void unlink(WheelTimer *t) {
+    if (t->Next) {
+        t->Next->Prev = t->Prev;
+    }
+    *t->Prev = t->Next;
+    t->Prev = 0;
+    if (!Slots[t->Slot]) {
+        Used[t->Slot >> WHEEL_BITS] &= ~(1UL << (t->Slot & MASK));
+    }
+}
+
+/* The work of one tick: the higher-level slots that come up at it move
+   down, then the level 0 slot is due. A callback cannot put a timer back
+   in that slot, since every delay is at least a tick. */
+static void step(void) {
+    unsigned long level, index;
+    WheelTimer *t, *list;
+    for (level = TOP; level > 0; level--) {
+        if (Ticks & ((1ULL << (WHEEL_BITS * level)) - 1)) {
+            continue;
+        }
+        index = level * WHEEL_SLOTS + ((unsigned long)(Ticks >> (WHEEL_BITS * level)) & MASK);
+        list = Slots[index];
+        if (list) {
+            Slots[index] = 0;
+            Used[level] &= ~(1UL << (index & MASK));
+            while (list) {
+                t = list;
+                list = t->Next;
+                insert(t);
+            }
+        }
+    }
+    index = (unsigned long)Ticks & MASK;
+    while ((t = Slots[index]) != 0) {
+        unlink(t);
+        if (t->Period) {
+            t->Expires += t->Period;    // from when it was due, not from now
+            insert(t);
+        }
+        t->Callback(t->Arg);
+    }
+}
+
+void Wheel_Init(unsigned long tick) {
+    unsigned long i;
+    for (i = 0; i < WHEEL_LEVELS * WHEEL_SLOTS; i++) {
+        Slots[i] = 0;
+    }
+    for (i = 0; i < WHEEL_LEVELS; i++) {
+        Used[i] = 0;
+    }
+    Ticks = 0;
+    Tick = tick;
+    Start = SysTick_Now();
+}
+
+void Wheel_Start(WheelTimer *t, unsigned long delay, unsigned long period,
+                 void (*callback)(void *), void *arg) {
+    Wheel_Cancel(t);
+    t->Expires = Ticks + (delay ? delay : 1);
+    t->Period = period;
+    t->Callback = callback;
+    t->Arg = arg;
+    insert(t);
+}
+
+void Wheel_Cancel(WheelTimer *t) {
+    if (t->Prev) {
+        unlink(t);
+    }
+}
+
+int Wheel_Pending(const WheelTimer *t) {
+    return t->Prev != 0;
+}
+
+unsigned long long Wheel_Ticks(void) {
+    return Ticks;
+}
+
+unsigned long long Wheel_Time(unsigned long long tick) {
+    return Start + tick * Tick;
+}
+
+unsigned long long Wheel_TickAt(unsigned long long time) {
+    return time <= Start ? 0 : (time - Start + Tick - 1) / Tick;
+}
+
+/* On each level, the first slot in use after the current one comes up
+   next: rotate the bitmap to start there and take its lowest bit. A
+   level only comes up at whole slots, so the higher levels are passed
+   over as soon as their next slot is later than what was found. */
+unsigned long long Wheel_Next(void) {
+    unsigned long long next = WHEEL_NEVER, at, base;
+    unsigned long level, rot, used;
+    for (level = 0; level < WHEEL_LEVELS; level++) {
+        base = (Ticks >> (WHEEL_BITS * level)) + 1;
+        if ((base << (WHEEL_BITS * level)) >= next) {
+            break;
+        }
+        used = Used[level];
+        if (!used) {
+            continue;
+        }
+        rot = (unsigned long)base & MASK;
+        if (rot) {
+            used = ((used >> rot) | (used << (WHEEL_SLOTS - rot))) & 0xFFFFFFFFUL;
+        }
+        at = (base + lowest(used)) << (WHEEL_BITS * level);
+        if (at < next) {
+            next = at;
+        }
+    }
+    return next;
+}
+
+/* Nothing happens between the ticks Wheel_Next() finds, so jump them */
+void Wheel_Advance(unsigned long long tick) {
+    unsigned long long next;
+    while ((next = Wheel_Next()) <= tick) {
+        Ticks = next;
+        step();
+    }
+    if (tick > Ticks) {
+        Ticks = tick;
+    }
+}
+
+void Wheel_Run(void) {
+    unsigned long long next = Wheel_Next();
+    if (next == WHEEL_NEVER) {
+        WaitForInterrupt();
+        return;
+    }
+    SysTick_WaitUntil(Wheel_Time(next));
+    Wheel_Advance(next);
+}
@@ -0,0 +1,130 @@
+/** @file   Wheel.h
+ *  @brief  Software timers on top of the SysTick timebase, kept in a
+ *          hierarchical timer wheel. Any number of one-shot and periodic
+ *          timers share the one SysTick: Wheel_Run() sleeps until the next
+ *          tick that has something to do and calls the callbacks that are
+ *          due. Starting and cancelling a timer is O(1), and so is the work
+ *          per tick, however many timers are pending.
+ *
+ *          Time is counted in ticks of a fixed number of cycles. The wheel
+ *          has WHEEL_LEVELS levels of WHEEL_SLOTS slots: level 0 holds the
+ *          timers due in the next 32 ticks, one slot per tick, level 1 the
+ *          ones due in the next 1024 ticks, 32 ticks per slot, and so on.
+ *          When a slot of a higher level comes up its timers move down a
+ *          level, so each timer moves at most WHEEL_LEVELS - 1 times. A
+ *          bitmap of the slots in use lets the wheel skip empty ticks.
+ *
+ *          The wheel belongs to the main loop: start and cancel timers from
+ *          there or from the callbacks, not from interrupt handlers.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#ifndef WHEEL_H
+#define WHEEL_H
+
+#define WHEEL_BITS              5
+#define WHEEL_SLOTS             (1 << WHEEL_BITS)   // slots per level, one bitmap word
+#define WHEEL_LEVELS            5                   // 2^25 ticks ahead before timers wait a lap
+#define WHEEL_NEVER             0xFFFFFFFFFFFFFFFFULL
+
+/* A timer. The caller owns the memory, which must be zeroed before the
+   first start (static timers are); the wheel links it into a slot. */
+typedef struct WheelTimer {
+    struct WheelTimer *Next;            // next timer in the same slot
+    struct WheelTimer **Prev;           // link that points at this timer, 0 if idle
+    unsigned long long Expires;         // tick the timer is due at
+    unsigned long Period;               // ticks between calls, 0 for one-shot
+    unsigned long Slot;                 // level * WHEEL_SLOTS + slot
+    void (*Callback)(void *arg);
+    void *Arg;
+} WheelTimer;
+
+/** @fn     Wheel_Init(unsigned long)
+ *  @brief  Starts the wheel with tick 0 now. SysTick_Init() must have been
+ *          called.
+ *  @param  Length of a tick in clock cycles.
+ *  @return NULL
+ */
+void Wheel_Init(unsigned long tick);
+
+/** @fn     Wheel_Start(WheelTimer *, unsigned long, unsigned long, void (*)(void *), void *)
+ *  @brief  Starts a timer, or restarts it if it is pending. A periodic
+ *          timer is due every 'period' ticks after the first call, whatever
+ *          time its callback takes, so it never drifts.
+ *  @param  Timer to start.
+ *  @param  Ticks from the current tick to the first call, at least 1.
+ *  @param  Ticks between later calls, or 0 for a one-shot timer.
+ *  @param  Function to call.
+ *  @param  Argument to pass it.
+ *  @return NULL
+ */
+void Wheel_Start(WheelTimer *t, unsigned long delay, unsigned long period,
+                 void (*callback)(void *), void *arg);
+
+/** @fn     Wheel_Cancel(WheelTimer *)
+ *  @brief  Stops a timer. Does nothing if it is not pending, so a callback
+ *          may cancel its own timer, periodic or not.
+ *  @param  Timer to stop.
+ *  @return NULL
+ */
+void Wheel_Cancel(WheelTimer *t);
+
+/** @fn     Wheel_Pending(const WheelTimer *)
+ *  @brief  Whether a timer is due to be called.
+ *  @param  Timer.
+ *  @return 1 if it is pending, 0 if not.
+ */
+int Wheel_Pending(const WheelTimer *t);
+
+/** @fn     Wheel_Ticks(void)
+ *  @brief  The current tick: the latest one whose callbacks have run.
+ *  @param  NULL
+ *  @return Ticks since Wheel_Init().
+ */
+unsigned long long Wheel_Ticks(void);
+
+/** @fn     Wheel_Time(unsigned long long)
+ *  @brief  SysTick time at which a tick starts.
+ *  @param  Tick.
+ *  @return Time in cycles since SysTick_Init().
+ */
+unsigned long long Wheel_Time(unsigned long long tick);
+
+/** @fn     Wheel_TickAt(unsigned long long)
+ *  @brief  The first tick that starts at or after a SysTick time.
+ *  @param  Time in cycles since SysTick_Init().
+ *  @return Tick.
+ */
+unsigned long long Wheel_TickAt(unsigned long long time);
+
+/** @fn     Wheel_Next(void)
+ *  @brief  The next tick the wheel has work at: a timer that is due, or
+ *          timers to move down a level. It is never later than the next
+ *          timer that is due.
+ *  @param  NULL
+ *  @return A tick after the current one, or WHEEL_NEVER with no timers.
+ */
+unsigned long long Wheel_Next(void);
+
+/** @fn     Wheel_Advance(unsigned long long)
+ *  @brief  Moves the wheel on to the given tick, calling every callback
+ *          due up to it in order of their ticks. Does not wait: Wheel_Run()
+ *          uses it after sleeping, and host tools can drive the wheel with
+ *          it directly.
+ *  @param  Tick to move on to.
+ *  @return NULL
+ */
+void Wheel_Advance(unsigned long long tick);
+
+/** @fn     Wheel_Run(void)
+ *  @brief  Sleeps until the next tick the wheel has work at, and does it.
+ *          Call it in the main loop. If the callbacks overrun, the ticks
+ *          that were missed are caught up at once on the next calls. With
+ *          no timers it sleeps until an interrupt.
+ *  @param  NULL
+ *  @return NULL
+ */
+void Wheel_Run(void);
+
+#endif
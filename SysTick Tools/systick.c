@@ -0,0 +1,106 @@
+/** @file   systick.c
+ *  @brief  Host-side check of the 64-bit timebase in SysTick Timer/SysTick.c,
+ *          run on the register emulator through thousands of wraps of the
+ *          24-bit counter. It sleeps to random deadlines, busy-waits for
+ *          random times, and reads the time with interrupts masked across a
+ *          wrap, so that the wrap is still pending when SysTick_Now() looks.
+ *          Every read is checked against the emulator's own cycle count
+ *          taken just before and just after it: the time must lie between
+ *          the two, so it never goes backwards, never skips a period and
+ *          never drifts. It prints the mean cost of a read.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#include <stdio.h>
+#include "tm4c123.h"
+#include "HostMMIO.h"
+#include "SysTick.h"
+
+#define WRAP            (1UL << 24)     // longest period of the counter
+#define ROUNDS          5000UL
+
+/* Cheap deterministic random numbers */
+static unsigned long Seed = 1;
+static unsigned long rnd(void) {
+    Seed = Seed * 1103515245UL + 12345UL;
+    return (Seed >> 16) & 0x7FFF;
+}
+static unsigned long rnd30(void) {
+    return (rnd() << 15) | rnd();
+}
+
+static unsigned long long Offset;       // emulator cycles at SysTick time 0
+static unsigned long long Last, Reads, ReadCycles;
+static unsigned long Errors, Pending;
+
+/* One read, bracketed by the emulator's cycle count */
+static unsigned long long check(const char *where) {
+    unsigned long long before = Mmio_Cycles();
+    unsigned long long t = SysTick_Now();
+    unsigned long long after = Mmio_Cycles();
+    Reads++;
+    ReadCycles += after - before;
+    if (t + Offset < before || t + Offset > after || t < Last) {
+        if (Errors++ < 10) {
+            printf("%s: read %llu, between %llu and %llu, last %llu\n",
+                   where, t, before - Offset, after - Offset, Last);
+        }
+    }
+    Last = t;
+    return t;
+}
+
+int main(void) {
+    unsigned long i, n, r;
+    unsigned long long t;
+    SysTick_Init();
+    Offset = Mmio_Cycles() - SysTick_Now();
+    Last = 0;
+    for (i = 0; i < ROUNDS; i++) {
+        switch (rnd() % 4) {
+        case 0:
+            // sleep to a deadline up to 3 wraps ahead
+            t = check("before a sleep") + 1 + rnd30() % (3 * WRAP);
+            SysTick_WaitUntil(t);
+            if (check("after a sleep") < t) {
+                Errors++;
+                printf("woke at %llu, before %llu\n", Last, t);
+            }
+            break;
+        case 1:
+            // busy, reading now and then
+            for (n = rnd() % 64; n > 0; n--) {
+                CPU_CYCLES(rnd30() % WRAP);
+                check("busy");
+            }
+            break;
+        case 2:
+            // a wrap the handler has not seen yet
+            DisableInterrupts();
+            r = NVIC_ST_CURRENT_R;
+            CPU_CYCLES(r + 1 + rnd() % 512);
+            if (NVIC_INT_CTRL_R & NVIC_INT_CTRL_PENDSTSET) {
+                Pending++;
+            }
+            check("wrap pending");
+            check("wrap pending");
+            EnableInterrupts();
+            check("after the handler");
+            break;
+        default:
+            // reads in a row, close to each other
+            for (n = rnd() % 256; n > 0; n--) {
+                check("in a row");
+                CPU_CYCLES(rnd() % 64);
+            }
+            break;
+        }
+    }
+    printf("%llu reads over %.0f wraps of 2^24 cycles, %lu with a wrap pending, %.1f cycles a read\n",
+           Reads, (double)Last / WRAP, Pending, (double)ReadCycles / Reads);
+    if (Errors) {
+        printf("errors: %lu\n", Errors);
+    }
+    return Errors != 0;
+}
@@ -0,0 +1,253 @@
+/** @file   task.c
+ *  @brief  Host-side check and benchmark of the cooperative tasks in
+ *          Common/Task.c, run on the register emulator. By default it runs
+ *          sleepers that sleep for random times and for absolute ticks,
+ *          waiters that wait for events with and without timeouts, a
+ *          signaller, yielders and tasks that exit, and checks that every
+ *          task wakes at or after its tick and never before, for an event
+ *          it waited for, that yields run in turn and that exited tasks
+ *          never run again. With -b it measures the cost of a switch
+ *          between two tasks that yield to each other, in emulated cycles
+ *          and in host time.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tm4c123.h"
+#include "SysTick.h"
+#include "Task.h"
+
+#define SLEEPERS        40
+#define WAITERS         20
+#define YIELDERS        4
+#define CHECK_ROUNDS    5000UL      // of 1000 ticks, 5 s of emulated time
+#define BENCH_SWITCHES  1000000UL
+#define TICK            16          // cycles, 1 us at 16 MHz
+
+/* Cheap deterministic random numbers */
+static unsigned long Seed = 1;
+static unsigned long rnd(void) {
+    Seed = Seed * 1103515245UL + 12345UL;
+    return (Seed >> 16) & 0x7FFF;
+}
+
+/* A task with the state it keeps across waits */
+typedef struct {
+    Task T;
+    unsigned long Index;
+    unsigned long Round;
+    unsigned long long Due;         // tick it must not wake before
+    unsigned long Events;           // events it waits for
+    unsigned long Since;            // signal count when it started waiting
+} Tester;
+
+static Tester Sleepers[SLEEPERS], Waiters[WAITERS], Yielders[YIELDERS];
+static Task Signaller, Checker;
+static unsigned long Rounds, Errors, Wakes, Timeouts, Woken, Yields, Exits;
+static unsigned long Signals[32];   // times each event was signalled
+static unsigned long Turn;          // yielder expected to run next
+
+static void error(const char *what, const Tester *t) {
+    if (Errors++ < 10) {
+        printf("%s: task %s %lu round %lu at tick %llu, due %llu\n", what,
+            t->T.Name, t->Index, t->Round, Wheel_Ticks(), t->Due);
+    }
+}
+
+/* Sleeps for a random number of ticks, or until a random tick, then now
+   and then exits and is created again by the checker */
+static char sleeper(Task *task) {
+    Tester *t = (Tester *)task;
+    TASK_BEGIN(task);
+    for (t->Round = 0; t->Round < 50; t->Round++) {
+        t->Due = Wheel_Ticks() + 1 + rnd() % 2000;
+        if (rnd() & 1) {
+            TASK_SLEEP(task, (unsigned long)(t->Due - Wheel_Ticks()));
+        } else {
+            TASK_SLEEP_UNTIL(task, t->Due);
+        }
+        Wakes++;
+        if (Wheel_Ticks() < t->Due || SysTick_Now() < Wheel_Time(t->Due)) {
+            error("early", t);
+        }
+        if (rnd() % 64 == 0) {
+            Exits++;
+            TASK_EXIT(task);
+        }
+    }
+    TASK_END(task);
+}
+
+/* Waits for one or two of the events, with a timeout or without */
+static char waiter(Task *task) {
+    Tester *t = (Tester *)task;
+    unsigned long ticks, i, seen;
+    TASK_BEGIN(task);
+    while (1) {
+        t->Events = (1UL << rnd() % 8) | (rnd() & 1 ? 1UL << rnd() % 8 : 0);
+        ticks = rnd() & 1 ? 1 + rnd() % 3000 : 0;
+        t->Due = ticks ? Wheel_Ticks() + ticks : WHEEL_NEVER;
+        for (i = 0, t->Since = 0; i < 8; i++) {
+            if (t->Events & (1UL << i)) {
+                t->Since += Signals[i];
+            }
+        }
+        TASK_WAIT_EVENT(task, t->Events, ticks);
+        for (i = 0, seen = 0; i < 8; i++) {
+            if (t->Events & (1UL << i)) {
+                seen += Signals[i];
+            }
+        }
+        if (task->Got) {
+            Woken++;
+            if ((task->Got & ~t->Events) || seen == t->Since) {
+                error("wrong event", t);
+            }
+        } else {
+            Timeouts++;
+            if (Wheel_Ticks() < t->Due) {
+                error("wrong timeout", t);
+            }
+        }
+        t->Round++;
+    }
+    TASK_END(task);
+}
+
+/* Signals a random event after a random pause */
+static char signaller(Task *task) {
+    static unsigned long ev;
+    TASK_BEGIN(task);
+    while (1) {
+        TASK_SLEEP(task, 1 + rnd() % 500);
+        ev = rnd() % 8;
+        Signals[ev]++;
+        Task_Signal(1UL << ev);
+    }
+    TASK_END(task);
+}
+
+/* The yielders run in turn, each one yield apart */
+static char yielder(Task *task) {
+    Tester *t = (Tester *)task;
+    TASK_BEGIN(task);
+    while (1) {
+        if (t->Index != Turn) {
+            error("out of turn", t);
+        }
+        Turn = (t->Index + 1) % YIELDERS;
+        Yields++;
+        t->Round++;
+        TASK_YIELD(task);
+    }
+    TASK_END(task);
+}
+
+/* Restarts exited sleepers, and ends the run after enough rounds */
+static char checker(Task *task) {
+    static unsigned long i;
+    unsigned long k;
+    TASK_BEGIN(task);
+    while (Rounds < CHECK_ROUNDS) {
+        TASK_SLEEP(task, 1000);
+        Rounds++;
+        for (i = 0; i < SLEEPERS; i++) {
+            if (Sleepers[i].T.Exited) {
+                Task_Create(&Sleepers[i].T, sleeper, "sleeper");
+            }
+        }
+    }
+    printf("rounds %lu\n", Rounds);
+    printf("ticks %llu\n", Wheel_Ticks());
+    printf("wakes %lu\n", Wakes);
+    printf("exits %lu\n", Exits);
+    printf("woken %lu\n", Woken);
+    printf("timeouts %lu\n", Timeouts);
+    printf("yields %lu\n", Yields);
+    printf("switches %lu\n", Task_Switches());
+    printf("errors %lu\n", Errors);
+    for (k = 0; k < YIELDERS; k++) {
+        if (Yielders[k].Round + 1 < Yields / YIELDERS) {
+            Errors++;
+        }
+    }
+    exit(Errors || !Wakes || !Woken || !Timeouts || !Yields || !Exits);
+    TASK_END(task);
+}
+
+static int check(void) {
+    unsigned long i;
+    Task_Init(TICK);
+    for (i = 0; i < SLEEPERS; i++) {
+        Sleepers[i].Index = i;
+        Task_Create(&Sleepers[i].T, sleeper, "sleeper");
+    }
+    for (i = 0; i < WAITERS; i++) {
+        Waiters[i].Index = i;
+        Task_Create(&Waiters[i].T, waiter, "waiter");
+    }
+    for (i = 0; i < YIELDERS; i++) {
+        Yielders[i].Index = i;
+        Task_Create(&Yielders[i].T, yielder, "yielder");
+    }
+    Task_Create(&Signaller, signaller, "signaller");
+    Task_Create(&Checker, checker, "checker");
+    Task_Run();
+    return 1;
+}
+
+static double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static Task Ping, Pong;
+static unsigned long Switches, Left;
+static unsigned long long Cycles0;
+static double Host0;
+
+/* Two tasks yield to each other until 'Left' runs out */
+static char pingpong(Task *task) {
+    TASK_BEGIN(task);
+    while (Left) {
+        Left--;
+        TASK_YIELD(task);
+    }
+    if (task == &Pong) {
+        printf("switches %lu\n", Switches);
+        printf("cycles_per_switch %.2f\n", (double)(SysTick_Now() - Cycles0) / Switches);
+        printf("ping_cycles_per_run %.2f\n", (double)Ping.Cycles / Ping.Runs);
+        printf("ping_worst_cycles %lu\n", Ping.WorstRun);
+        printf("host_ns_per_switch %.2f\n", (seconds() - Host0) * 1e9 / Switches);
+        exit(0);
+    }
+    TASK_END(task);
+}
+
+static int bench(unsigned long switches) {
+    Switches = Left = switches;
+    Task_Init(TICK);
+    Task_Create(&Ping, pingpong, "ping");
+    Task_Create(&Pong, pingpong, "pong");
+    Cycles0 = SysTick_Now();
+    Host0 = seconds();
+    Task_Run();
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    SysTick_Init();
+    if (argc >= 2 && !strcmp(argv[1], "-b")) {
+        return bench(argc >= 3 ? strtoul(argv[2], 0, 0) : BENCH_SWITCHES);
+    }
+    if (argc > 1) {
+        fprintf(stderr, "usage: %s\n       %s -b [switches]\n", argv[0], argv[0]);
+        return 2;
+    }
+    return check();
+}
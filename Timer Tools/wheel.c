@@ -0,0 +1,229 @@
+/** @file   wheel.c
+ *  @brief  Host-side check and benchmark of the timer wheel in
+ *          SysTick Timer/Wheel.c. By default it runs thousands of one-shot
+ *          and periodic timers with delays on every level of the wheel and
+ *          beyond it, starts, restarts and cancels them from the main loop
+ *          and from callbacks, moves the wheel on by single ticks and by
+ *          long jumps, and checks every call against a plain model: each
+ *          timer is called exactly at the tick it is due, in order, and
+ *          never when cancelled. With -b it measures the cost of a tick and
+ *          of starting and cancelling a timer as the number of timers grows,
+ *          against a countdown per timer.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "SysTick.h"
+#include "Wheel.h"
+
+#define CHECK_TIMERS    4000
+#define CHECK_ROUNDS    200000UL
+#define BENCH_TICKS     1000000UL
+#define BASE_WORK       (1UL << 26)     // timer visits the countdowns get per size
+#define RANGE           (1UL << 27)     // longest delay, past the top of the wheel
+
+/* Cheap deterministic random numbers */
+static unsigned long Seed = 1;
+static unsigned long rnd(void) {
+    Seed = Seed * 1103515245UL + 12345UL;
+    return (Seed >> 16) & 0x7FFF;
+}
+static unsigned long rnd30(void) {
+    return (rnd() << 15) | rnd();
+}
+
+/* Delays spread evenly over the levels: first a level, then a delay in it */
+static unsigned long delay(void) {
+    unsigned long bits = 1 + rnd() % 27;
+    unsigned long d = rnd30() & ((1UL << bits) - 1);
+    return d ? d : 1;
+}
+
+/* The model: when each timer is due, 0 if it is idle */
+static WheelTimer *Timers;
+static unsigned long long *Due;
+static unsigned long *Period;
+static unsigned long long Calls, Errors, LastCall;
+
+static void called(void *arg);
+
+static void start(unsigned long i) {
+    unsigned long d = delay();
+    unsigned long p = rnd() % 4 == 0 ? delay() : 0;
+    Wheel_Start(&Timers[i], d, p, called, (void *)i);
+    Due[i] = Wheel_Ticks() + d;
+    Period[i] = p;
+}
+
+static void called(void *arg) {
+    unsigned long i = (unsigned long)arg, j;
+    unsigned long long now = Wheel_Ticks();
+    Calls++;
+    if (now != Due[i] || now < LastCall) {
+        if (Errors++ < 10) {
+            printf("timer %lu called at %llu, due %llu\n", i, now, Due[i]);
+        }
+    }
+    LastCall = now;
+    Due[i] = Period[i] ? Due[i] + Period[i] : 0;
+    // now and then, restart or cancel this timer or another one
+    switch (rnd() % 8) {
+    case 0:
+        Wheel_Cancel(&Timers[i]);
+        Due[i] = 0;
+        break;
+    case 1:
+        start(i);
+        break;
+    case 2:
+        j = rnd30() % CHECK_TIMERS;
+        Wheel_Cancel(&Timers[j]);
+        Due[j] = 0;
+        break;
+    }
+}
+
+static int check(unsigned long rounds) {
+    unsigned long r, i, jumps = 0, steps = 0;
+    unsigned long long to, missed = 0;
+    Timers = calloc(CHECK_TIMERS, sizeof(WheelTimer));
+    Due = calloc(CHECK_TIMERS, sizeof(unsigned long long));
+    Period = calloc(CHECK_TIMERS, sizeof(unsigned long));
+    Wheel_Init(1);
+    for (r = 0; r < rounds; r++) {
+        i = rnd30() % CHECK_TIMERS;
+        if (!Wheel_Pending(&Timers[i])) {
+            start(i);
+        } else if (rnd() % 16 == 0) {
+            Wheel_Cancel(&Timers[i]);
+            Due[i] = 0;
+        }
+        // mostly single ticks, sometimes long jumps
+        if (rnd() % 64 == 0) {
+            to = Wheel_Ticks() + delay();
+            jumps++;
+        } else {
+            to = Wheel_Ticks() + 1 + rnd() % 4;
+            steps++;
+        }
+        Wheel_Advance(to);
+        if (r % 1024 == 0) {
+            for (i = 0; i < CHECK_TIMERS; i++) {
+                if ((Due[i] != 0) != Wheel_Pending(&Timers[i]) || (Due[i] && Due[i] <= to)) {
+                    missed++;
+                }
+            }
+        }
+    }
+    printf("timers %d\n", CHECK_TIMERS);
+    printf("rounds %lu\n", rounds);
+    printf("steps %lu\n", steps);
+    printf("jumps %lu\n", jumps);
+    printf("ticks %llu\n", Wheel_Ticks());
+    printf("calls %llu\n", Calls);
+    printf("wrong %llu\n", Errors);
+    printf("missed %llu\n", missed);
+    return Errors || missed || !Calls;
+}
+
+static double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static unsigned long long Fired;
+static void count(void *arg) {
+    (void)arg;
+    Fired++;
+}
+
+/* The usual alternative: every timer counts down each tick */
+typedef struct {
+    unsigned long Left, Period;
+} Countdown;
+static void countdown_tick(Countdown *c, unsigned long n) {
+    unsigned long i;
+    for (i = 0; i < n; i++) {
+        if (c[i].Left && --c[i].Left == 0) {
+            c[i].Left = c[i].Period;
+            Fired++;
+        }
+    }
+}
+
+/* Idle: timers due far beyond the run, only moving down levels. Busy:
+   periodic timers with periods around twice their number, so that about
+   one is due every other tick whatever the size. */
+static void bench_size(unsigned long n, unsigned long ticks) {
+    WheelTimer *t = calloc(n, sizeof(WheelTimer));
+    Countdown *c = calloc(n, sizeof(Countdown));
+    unsigned long i, k, base = BASE_WORK / n < ticks ? BASE_WORK / n : ticks;
+    unsigned long long from;
+    double t0;
+    int busy;
+    for (busy = 0; busy < 2; busy++) {
+        memset(t, 0, n * sizeof(WheelTimer));
+        Wheel_Init(1);
+        for (i = 0; i < n; i++) {
+            if (busy) {
+                Wheel_Start(&t[i], 1 + rnd30() % (2 * n), n + rnd30() % (2 * n), count, 0);
+            } else {
+                Wheel_Start(&t[i], ticks + 1 + rnd30() % RANGE, 0, count, 0);
+            }
+        }
+        Fired = 0;
+        from = Wheel_Ticks();
+        t0 = seconds();
+        for (k = 0; k < ticks; k++) {
+            Wheel_Advance(from + k + 1);
+        }
+        printf("wheel_%s_%lu_ns_per_tick %.2f\n", busy ? "busy" : "idle", n, (seconds() - t0) * 1e9 / ticks);
+        printf("wheel_%s_%lu_calls_per_tick %.3f\n", busy ? "busy" : "idle", n, (double)Fired / ticks);
+        for (i = 0; i < n; i++) {
+            c[i].Period = busy ? n + rnd30() % (2 * n) : 0;
+            c[i].Left = busy ? 1 + rnd30() % (2 * n) : ticks + 1 + rnd30() % RANGE;
+        }
+        t0 = seconds();
+        for (k = 0; k < base; k++) {
+            countdown_tick(c, n);
+        }
+        printf("countdown_%s_%lu_ns_per_tick %.2f\n", busy ? "busy" : "idle", n, (seconds() - t0) * 1e9 / base);
+    }
+    // start and cancel every timer, in a random order
+    t0 = seconds();
+    for (i = 0; i < n; i++) {
+        Wheel_Start(&t[i], delay(), 0, count, 0);
+    }
+    for (i = 0; i < n; i++) {
+        Wheel_Cancel(&t[(i * 2654435761UL) % n]);
+    }
+    printf("wheel_%lu_ns_per_start_cancel %.2f\n", n, (seconds() - t0) * 1e9 / n);
+    free(t);
+    free(c);
+}
+
+static int bench(unsigned long ticks) {
+    unsigned long n;
+    printf("ticks %lu\n", ticks);
+    for (n = 16; n <= 1048576; n *= 16) {
+        bench_size(n, ticks);
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    SysTick_Init();
+    if (argc >= 2 && !strcmp(argv[1], "-b")) {
+        return bench(argc >= 3 ? strtoul(argv[2], 0, 0) : BENCH_TICKS);
+    }
+    if (argc > 2 || (argc == 2 && argv[1][0] == '-')) {
+        fprintf(stderr, "usage: %s [rounds]\n       %s -b [ticks]\n", argv[0], argv[0]);
+        return 2;
+    }
+    return check(argc == 2 ? strtoul(argv[1], 0, 0) : CHECK_ROUNDS);
+}
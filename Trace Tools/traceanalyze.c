@@ -0,0 +1,403 @@
+/** @file   traceanalyze.c
+ *  @brief  Host-side timing analyzer for recorded pin activity. Reads a
+ *          capture in a single pass, rebuilds the waveform of every pin
+ *          from its edges and reports, per pin, histograms of the period
+ *          (rising edge to rising edge), the high time, the duty cycle and
+ *          the cycle-to-cycle jitter, and flags periods and pulses that are
+ *          far from the usual ones. Memory depends on the number of pins,
+ *          never on the length of the capture.
+ *
+ *          Accepted input, detected from the first byte:
+ *          - "<cycles> <hex>" lines, as printed by tracedec or by
+ *            Functional Debugging on the host
+ *          - "<ns> <cycles> P<port> <hex>" lines written by the emulator's
+ *            MMIO_TRACE
+ *          - binary trace blocks (Common/Trace.h) in time order, as drained
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "Trace.h"
+
+#define SUB_BITS        5           // histogram bins per octave = 2^SUB_BITS
+#define SUB             (1 << SUB_BITS)
+#define BINS            ((64 - SUB_BITS + 1) * SUB)
+#define ROWS            24          // most histogram rows printed
+#define WARMUP          8           // periods seen before flagging outliers
+#define REPORTED        10          // outliers printed per pin and kind
+#define DEFAULT_CLOCK   16000000.0  // Functional Debugging and the Pacemaker
+
+/* Log-linear histogram of signed values, about 3% wide bins */
+typedef struct {
+    unsigned long long Zero;
+    unsigned long long Pos[BINS];
+    unsigned long long Neg[BINS];
+} Hist;
+
+/* Running statistics */
+typedef struct {
+    double N, Mean, M2;
+    long long Min, Max;
+} Stats;
+
+/* What is known about one kind of interval of a pin */
+typedef struct {
+    Stats All;                      // every interval
+    Stats Ref;                      // intervals that were not outliers
+    Hist H;
+    unsigned long Outliers;
+} Interval;
+
+typedef struct {
+    char Port;
+    int Bit;
+    int High;                       // current level
+    int Rose;                       // Rise is valid
+    unsigned long long Rise, Fall;  // latest edges
+    long long Period;               // latest period, 0 before the first
+    unsigned long long Edges;
+    Interval Periods, Widths, Jitter;
+    unsigned long long Duty[101];   // percent
+} Pin;
+
+/* Latest level of a port's pins */
+typedef struct {
+    int Seen;
+    unsigned long Level;
+    Pin *Pins[32];
+} Port;
+
+static Port Ports[27];              // 'A'..'Z', and '@' for data without a port
+static double Clock = DEFAULT_CLOCK;
+static double Sigma = 6;            // outlier threshold in standard deviations
+static double Tolerance = 0.01;     // ... but never tighter than this fraction
+static unsigned long Mask;          // where packed data bits go, 0 if not packed
+static char Default = '@';          // port of data given without one
+static unsigned long long Events, Skipped;
+
+static int bin(unsigned long long v) {
+    int e = 63;
+    if (v < SUB) {
+        return (int)v;
+    }
+    while (!(v >> e)) {
+        e--;
+    }
+    return (e - SUB_BITS + 1) * SUB + (int)(v >> (e - SUB_BITS)) - SUB;
+}
+
+static unsigned long long bin_low(int b) {
+    if (b < SUB) {
+        return b;
+    }
+    return (unsigned long long)(b % SUB + SUB) << (b / SUB - 1);
+}
+
+static void hist_add(Hist *h, long long v) {
+    if (v > 0) {
+        h->Pos[bin(v)]++;
+    } else if (v < 0) {
+        h->Neg[bin(-(unsigned long long)v)]++;
+    } else {
+        h->Zero++;
+    }
+}
+
+static void stats_add(Stats *s, long long v) {
+    double d = v - s->Mean;
+    if (s->N == 0 || v < s->Min) {
+        s->Min = v;
+    }
+    if (s->N == 0 || v > s->Max) {
+        s->Max = v;
+    }
+    s->N++;
+    s->Mean += d / s->N;
+    s->M2 += d * (v - s->Mean);
+}
+
+static double stats_sd(const Stats *s) {
+    return s->N > 1 ? sqrt(s->M2 / (s->N - 1)) : 0;
+}
+
+static const char *name(const Pin *p) {
+    static char buf[16];
+    if (p->Port == '@') {
+        sprintf(buf, "bit%d", p->Bit);
+    } else {
+        sprintf(buf, "P%c%d", p->Port, p->Bit);
+    }
+    return buf;
+}
+
+static double ms(double cycles) {
+    return cycles * 1e3 / Clock;
+}
+
+/* Adds an interval, flagging it if it is far from the ones before */
+static void measure(Pin *p, Interval *in, const char *kind, long long v, unsigned long long t) {
+    double limit = Sigma * stats_sd(&in->Ref);
+    stats_add(&in->All, v);
+    hist_add(&in->H, v);
+    if (limit < Tolerance * fabs(in->Ref.Mean)) {
+        limit = Tolerance * fabs(in->Ref.Mean);
+    }
+    if (in->Ref.N >= WARMUP && fabs(v - in->Ref.Mean) > limit) {
+        if (in->Outliers++ < REPORTED) {
+            printf("outlier %s %s %lld cycles (%.3f ms) at %llu, usually %.0f +- %.0f\n",
+                   name(p), kind, v, ms(v), t, in->Ref.Mean, stats_sd(&in->Ref));
+        }
+        return;
+    }
+    stats_add(&in->Ref, v);
+}
+
+static void edge(Pin *p, int high, unsigned long long t) {
+    p->Edges++;
+    p->High = high;
+    if (!high) {
+        if (p->Rose) {
+            measure(p, &p->Widths, "high time", (long long)(t - p->Rise), t);
+        }
+        p->Fall = t;
+        return;
+    }
+    if (p->Rose) {
+        long long period = (long long)(t - p->Rise);
+        measure(p, &p->Periods, "period", period, t);
+        if (p->Period) {
+            measure(p, &p->Jitter, "jitter", period - p->Period, t);
+        }
+        if (p->Fall > p->Rise) {
+            p->Duty[(int)((p->Fall - p->Rise) * 100 / (unsigned long long)period)]++;
+        }
+        p->Period = period;
+    }
+    p->Rise = t;
+    p->Rose = 1;
+}
+
+/* Spreads the packed low bits of data over the bits set in Mask */
+static unsigned long unpack(unsigned long data) {
+    unsigned long out = 0, m = Mask, bit = 1;
+    while (m) {
+        unsigned long low = m & -m;
+        if (data & bit) {
+            out |= low;
+        }
+        m &= m - 1;
+        bit <<= 1;
+    }
+    return out;
+}
+
+static void event(char port, unsigned long long t, unsigned long level) {
+    Port *q = &Ports[port == '@' ? 26 : port - 'A'];
+    unsigned long changed;
+    int b;
+    Events++;
+    if (Mask) {
+        level = unpack(level);
+    }
+    if (!q->Seen) {
+        q->Seen = 1;                    // the first sample sets the levels
+        q->Level = level;
+        return;
+    }
+    changed = (q->Level ^ level) & 0xFFFFFFFFUL;
+    q->Level = level;
+    for (b = 0; changed; b++, changed >>= 1) {
+        if (changed & 1) {
+            if (!q->Pins[b]) {
+                q->Pins[b] = calloc(1, sizeof(Pin));
+                q->Pins[b]->Port = port;
+                q->Pins[b]->Bit = b;
+            }
+            edge(q->Pins[b], (int)((level >> b) & 1), t);
+        }
+    }
+}
+
+static void read_blocks(FILE *f) {
+    unsigned char block[TRACE_BLOCK];
+    Event e[TRACE_BLOCK];
+    unsigned long n, k;
+    while (fread(block, 1, TRACE_BLOCK, f) == TRACE_BLOCK) {
+        n = Trace_Decode(block, e, TRACE_BLOCK);
+        for (k = 0; k < n; k++) {
+            event(Default, e[k].Time, e[k].Data);
+        }
+    }
+}
+
+static void read_lines(FILE *f) {
+    char line[256], port;
+    unsigned long long ns, t;
+    unsigned long level;
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "%llu %llu P%c %lx", &ns, &t, &port, &level) == 4 && port >= 'A' && port <= 'Z') {
+            event(port, t, level);
+        } else if (sscanf(line, "%llu %lx", &t, &level) == 2) {
+            event(Default, t, level);
+        } else {
+            Skipped++;
+        }
+    }
+}
+
+/* Prints the non-empty part of a histogram, in at most ROWS rows */
+static void print_hist(const Hist *h) {
+    static long long lo[2 * BINS + 1], hi[2 * BINS + 1];
+    static unsigned long long count[2 * BINS + 1];
+    unsigned long long most = 0, sum;
+    int n = 0, first = -1, last = -1, i, j, group;
+    for (i = BINS - 1; i >= 0; i--, n++) {
+        lo[n] = i + 1 < BINS ? -(long long)bin_low(i + 1) + 1 : -0x7FFFFFFFFFFFFFFFLL;
+        hi[n] = -(long long)bin_low(i);
+        count[n] = h->Neg[i];
+    }
+    lo[n] = hi[n] = 0;
+    count[n++] = h->Zero;
+    for (i = 0; i < BINS; i++, n++) {
+        lo[n] = (long long)bin_low(i);
+        hi[n] = i + 1 < BINS ? (long long)bin_low(i + 1) - 1 : 0x7FFFFFFFFFFFFFFFLL;
+        count[n] = h->Pos[i];
+    }
+    for (i = 0; i < n; i++) {
+        if (count[i]) {
+            if (first < 0) {
+                first = i;
+            }
+            last = i;
+        }
+    }
+    if (first < 0) {
+        return;
+    }
+    group = (last - first) / ROWS + 1;
+    for (i = first; i <= last; i += group) {
+        for (j = i, sum = 0; j < i + group && j <= last; j++) {
+            sum += count[j];
+        }
+        if (sum > most) {
+            most = sum;
+        }
+    }
+    for (i = first; i <= last; i += group) {
+        j = i + group - 1 > last ? last : i + group - 1;
+        for (sum = 0; j >= i; j--) {
+            sum += count[j];
+        }
+        if (!sum) {
+            continue;                   // only the rows that hold something
+        }
+        j = i + group - 1 > last ? last : i + group - 1;
+        printf("    %12lld .. %-12lld %10llu |", lo[i], hi[j], sum);
+        for (j = 0; j < (int)(sum * 40 / most); j++) {
+            putchar('#');
+        }
+        putchar('\n');
+    }
+}
+
+static void print_interval(const char *kind, const Interval *in) {
+    if (!in->All.N) {
+        return;
+    }
+    printf("  %s: n %.0f, min %lld, mean %.1f, max %lld, sd %.1f cycles (mean %.3f ms), %lu outliers\n",
+           kind, in->All.N, in->All.Min, in->All.Mean, in->All.Max, stats_sd(&in->All),
+           ms(in->All.Mean), in->Outliers);
+    print_hist(&in->H);
+}
+
+static void report(const Pin *p) {
+    unsigned long long n = 0;
+    int i, first = -1, last = -1;
+    printf("\n%s: %llu edges, now %s\n", name(p), p->Edges, p->High ? "high" : "low");
+    if (p->Periods.All.N) {
+        printf("  frequency %.3f Hz\n", Clock / p->Periods.All.Mean);
+    }
+    print_interval("period", &p->Periods);
+    print_interval("high time", &p->Widths);
+    print_interval("jitter", &p->Jitter);
+    for (i = 0; i <= 100; i++) {
+        if (p->Duty[i]) {
+            if (first < 0) {
+                first = i;
+            }
+            last = i;
+            n += p->Duty[i];
+        }
+    }
+    if (first >= 0) {
+        printf("  duty cycle: %d%% .. %d%%\n", first, last);
+        for (i = first; i <= last; i++) {
+            if (p->Duty[i]) {
+                printf("    %3d%% %10llu\n", i, p->Duty[i]);
+            }
+        }
+    }
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-c hz] [-k sigma] [-t fraction] [-m hexmask] [-p port] [capture]\n"
+                    "  -c  clock rate, for times in ms (default 16000000)\n"
+                    "  -k  flag intervals this many standard deviations from the mean (default 6)\n"
+                    "  -t  ... or this fraction of the mean, whichever is wider (default 0.01)\n"
+                    "  -m  data holds packed bits, to be spread over these bits (13 for PF4,PF1,PF0)\n"
+                    "  -p  port letter of data that comes without one, for naming pins\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    FILE *f = stdin;
+    int i, b, c;
+    for (i = 1; i < argc && argv[i][0] == '-' && argv[i][1]; i++) {
+        if (i + 1 >= argc) {
+            usage(argv[0]);
+        }
+        switch (argv[i][1]) {
+        case 'c': Clock = atof(argv[++i]); break;
+        case 'k': Sigma = atof(argv[++i]); break;
+        case 't': Tolerance = atof(argv[++i]); break;
+        case 'm': Mask = strtoul(argv[++i], 0, 16); break;
+        case 'p':
+            Default = argv[++i][0];
+            if (Default < 'A' || Default > 'Z') {
+                usage(argv[0]);
+            }
+            break;
+        default: usage(argv[0]);
+        }
+    }
+    if (i < argc && !(f = fopen(argv[i], "rb"))) {
+        perror(argv[i]);
+        return 1;
+    }
+    c = getc(f);
+    if (c != EOF) {
+        ungetc(c, f);
+    }
+    if (c != EOF && (c & TRACE_TAG_M) == TRACE_TAG) {
+        read_blocks(f);
+    } else {
+        read_lines(f);
+    }
+    printf("\n%llu events", Events);
+    if (Skipped) {
+        printf(", %llu lines skipped", Skipped);
+    }
+    printf("\n");
+    for (i = 0; i < 27; i++) {
+        for (b = 0; b < 32; b++) {
+            if (Ports[i].Pins[b]) {
+                report(Ports[i].Pins[b]);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+/** @file   tracedec.c
+ *  @brief  Host-side decoder for the compressed traces written by
+ *          Common/Trace.c. Reads a dump of trace blocks (drained blocks
+ *          back to back, or a raw memory dump of the trace buffer in any
+ *          rotation) and prints one "<cycles> <hex>" line per event, oldest
+ *          first. With -b it instead measures how fast events are encoded
+ *          and decoded and how many bytes each one takes.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Trace.h"
+
+#define BENCH_EVENTS    10000000UL
+#define BENCH_SHIFT     4
+#define PERIOD          825011UL    // Functional Debugging's loop at 16 MHz
+
+/* A decoded block, ordered by its first event */
+typedef struct {
+    unsigned long long First;
+    unsigned long Count;
+    Event Events[TRACE_BLOCK];
+} Block;
+
+static int by_first(const void *a, const void *b) {
+    const Block *x = *(const Block * const *)a, *y = *(const Block * const *)b;
+    return (x->First > y->First) - (x->First < y->First);
+}
+
+/* Decodes every block in the file and prints the events in time order */
+static int decode(const char *path) {
+    FILE *f = fopen(path, "rb");
+    unsigned char raw[TRACE_BLOCK];
+    Block **blocks = 0;
+    unsigned long n = 0, cap = 0, i, k;
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    while (fread(raw, 1, TRACE_BLOCK, f) == TRACE_BLOCK) {
+        Block *b = malloc(sizeof(Block));
+        b->Count = Trace_Decode(raw, b->Events, TRACE_BLOCK);
+        if (!b->Count) {
+            free(b);                    // never written
+            continue;
+        }
+        b->First = b->Events[0].Time;
+        if (n == cap) {
+            cap = cap ? 2 * cap : 64;
+            blocks = realloc(blocks, cap * sizeof(Block *));
+        }
+        blocks[n++] = b;
+    }
+    fclose(f);
+    qsort(blocks, n, sizeof(Block *), by_first);
+    for (i = 0; i < n; i++) {
+        for (k = 0; k < blocks[i]->Count; k++) {
+            printf("%llu %02lX\n", blocks[i]->Events[k].Time, blocks[i]->Events[k].Data);
+        }
+        free(blocks[i]);
+    }
+    free(blocks);
+    return 0;
+}
+
+static double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Keeps the decode loop from being optimized away */
+static volatile unsigned long long Sink;
+
+/* Cheap deterministic random numbers */
+static unsigned long Seed = 1;
+static unsigned long rnd(void) {
+    Seed = Seed * 1103515245UL + 12345UL;
+    return (Seed >> 16) & 0x7FFF;
+}
+
+/* Switch presses and an LED blinking at 10 Hz, with loop jitter, long
+   idle gaps and the odd wide data value */
+static void synthesize(Event *e, unsigned long n) {
+    unsigned long long t = 0;
+    unsigned long state = 0x11, i;
+    for (i = 0; i < n; i++) {
+        unsigned long r = rnd();
+        if (r < 30) {
+            t += (unsigned long long)rnd() * rnd() * 64;    // idle
+            state ^= 0x10;
+        } else {
+            t += PERIOD - 8 + rnd() % 16;
+            state ^= 0x02;
+        }
+        e[i].Time = t;
+        e[i].Data = r % 1000 == 0 ? 0x1000 + r : ((state >> 2) & 4) | (state & 3);
+    }
+}
+
+static int bench(unsigned long n) {
+    Event *in = malloc(n * sizeof(Event));
+    Event out[TRACE_BLOCK];
+    unsigned long size = TRACE_BLOCK, blocks, i, k, got = 0, bad = 0;
+    unsigned char *buf;
+    Trace t;
+    double t0, enc, dec;
+    while (size < n * 2) {
+        size *= 2;                      // room for two bytes per event
+    }
+    buf = malloc(size);
+    synthesize(in, n);
+    Trace_Init(&t, buf, size, TRACE_STOP, BENCH_SHIFT);
+    t0 = seconds();
+    for (i = 0; i < n; i++) {
+        Trace_Record(&t, in[i].Time, in[i].Data);
+    }
+    enc = seconds() - t0;
+    blocks = t.Head + (t.Used != 0);
+    t0 = seconds();
+    for (i = 0; i < blocks; i++) {
+        k = Trace_Decode(buf + i * TRACE_BLOCK, out, TRACE_BLOCK);
+        got += k;
+        Sink += out[k - 1].Time;
+    }
+    dec = seconds() - t0;
+    // check the round trip
+    for (i = k = 0; i < blocks; i++) {
+        unsigned long m = Trace_Decode(buf + i * TRACE_BLOCK, out, TRACE_BLOCK), j;
+        for (j = 0; j < m; j++, k++) {
+            if (out[j].Time != in[k].Time >> BENCH_SHIFT << BENCH_SHIFT || out[j].Data != in[k].Data) {
+                bad++;
+            }
+        }
+    }
+    printf("events %lu\n", n);
+    printf("dropped %lu\n", t.Dropped);
+    printf("mismatches %lu\n", bad + (got != n));
+    printf("bytes_per_event %.3f\n", (double)blocks * TRACE_BLOCK / n);
+    printf("vs_recorder %.1fx\n", (double)sizeof(Event) * n / ((double)blocks * TRACE_BLOCK));
+    printf("encode_Mevents_per_s %.1f\n", n / enc / 1e6);
+    printf("decode_Mevents_per_s %.1f\n", got / dec / 1e6);
+    printf("decode_MB_per_s %.1f\n", blocks * TRACE_BLOCK / dec / 1e6);
+    free(buf);
+    free(in);
+    return bad || got != n;
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 2 && !strcmp(argv[1], "-b")) {
+        return bench(argc >= 3 ? strtoul(argv[2], 0, 0) : BENCH_EVENTS);
+    }
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <dump>\n       %s -b [events]\n", argv[0], argv[0]);
+        return 2;
+    }
+    return decode(argv[1]);
+}
@@ -0,0 +1,28 @@
+/* @file  Lights.c
+*  @brief The traffic light's FSM tables (see Lights.h).
+*  @author Mustafa Siddiqui
+*  @date  10/16/2026
+*/
+
+#include "Lights.h"
+
+/* A full table would hold 2^N next states a state for N sensors; this
+   one grows with the arcs */
+const FsmState FSM[LIGHTS_STATES]={
+  {3000, 0x21, 1, goN, 0},    // goN: a car east, whatever north does
+  {500, 0x22, 0, goE, 1},
+  {3000, 0x0C, 1, goE, 1},    // goE: a car north, whatever east does
+  {500, 0x14, 0, goN, 2}
+ };
+const FsmArc Arcs[LIGHTS_ARCS]={
+  {0x01, 0x01, waitN},
+  {0x02, 0x02, waitE}
+ };
+
+/* Checked against the arcs by FSM Tools/arcs.c */
+const unsigned char Index[LIGHTS_STATES << LIGHTS_SENSORS]={
+  goN, waitN, goN, waitN,     // goN
+  goE, goE, goE, goE,         // waitN
+  goE, goE, waitE, waitE,     // goE
+  goN, goN, goN, goN          // waitE
+ };
@@ -0,0 +1,34 @@
+/* @file  Lights.h
+*  @brief The traffic light's FSM, kept apart from main.c so the host
+*         checks and benchmarks in Traffic Tools, FSM Tools and Bench
+*         Tools run the lab's own tables rather than copies of them.
+*  @author Mustafa Siddiqui
+*  @date  10/16/2026
+*/
+
+#ifndef LIGHTS_H
+#define LIGHTS_H
+
+#include "../Common/Fsm.h"
+
+/* MACROs to improve readability */
+#define goN   0
+#define waitN 1
+#define goE   2
+#define waitE 3
+
+#define LIGHTS_STATES   4
+#define LIGHTS_ARCS     2
+#define LIGHTS_SENSORS  2     // PE1-0
+
+/* FSM data, kept in flash (see Common/Fsm.h): the time in 10 ms units,
+   the lights for PB5-0, and the next state, which is the default unless
+   one of the state's arcs matches the sensors */
+extern const FsmState FSM[LIGHTS_STATES];
+extern const FsmArc Arcs[LIGHTS_ARCS];
+
+/* The same transitions indexed by state and sensors, for the step: one
+   load, as with the packed table before the arcs */
+extern const unsigned char Index[LIGHTS_STATES << LIGHTS_SENSORS];
+
+#endif
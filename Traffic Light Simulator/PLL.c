@@ -21,52 +21,41 @@
  http://users.ece.utexas.edu/~valvano/
  */
  
+#include "../Common/tm4c123.h"
 #include "PLL.h"
 
-// The #define statement SYSDIV2 in PLL.h
-// initializes the PLL to the desired frequency.
+// PLL_HZ and PLL_XTAL_HZ in PLL.h choose the frequency; PLL.h works out
+// SYSDIV2, DIV400 and the XTAL field from them at compile time.
 
-// bus frequency is 400MHz/(SYSDIV2+1) = 400MHz/(7+1) = 50 MHz
+// bus frequency is 400MHz/(SYSDIV2+1) = 400MHz/(4+1) = 80 MHz by default
 // see the table at the end of this file
 
-#define SYSCTL_RIS_R            (*((volatile unsigned long *)0x400FE050))
-#define SYSCTL_RIS_PLLLRIS      0x00000040  // PLL Lock Raw Interrupt Status
-#define SYSCTL_RCC_R            (*((volatile unsigned long *)0x400FE060))
-#define SYSCTL_RCC_XTAL_M       0x000007C0  // Crystal Value
-#define SYSCTL_RCC_XTAL_6MHZ    0x000002C0  // 6 MHz Crystal
-#define SYSCTL_RCC_XTAL_8MHZ    0x00000380  // 8 MHz Crystal
-#define SYSCTL_RCC_XTAL_16MHZ   0x00000540  // 16 MHz Crystal
-#define SYSCTL_RCC2_R           (*((volatile unsigned long *)0x400FE070))
-#define SYSCTL_RCC2_USERCC2     0x80000000  // Use RCC2
-#define SYSCTL_RCC2_DIV400      0x40000000  // Divide PLL as 400 MHz vs. 200
-                                            // MHz
-#define SYSCTL_RCC2_SYSDIV2_M   0x1F800000  // System Clock Divisor 2
-#define SYSCTL_RCC2_SYSDIV2LSB  0x00400000  // Additional LSB for SYSDIV2
-#define SYSCTL_RCC2_PWRDN2      0x00002000  // Power-Down PLL 2
-#define SYSCTL_RCC2_BYPASS2     0x00000800  // PLL Bypass 2
-#define SYSCTL_RCC2_OSCSRC2_M   0x00000070  // Oscillator Source 2
-#define SYSCTL_RCC2_OSCSRC2_MO  0x00000000  // MOSC
+// RCC2 with the PLL powered up, fed from the main oscillator and divided
+// down as chosen; USBPWRDN keeps the USB PLL off as it is after reset
+#define RCC2_PLL  (SYSCTL_RCC2_USERCC2 + SYSCTL_RCC2_USBPWRDN + PLL_RCC2_DIV)
+
+// start the PLL: each register is written once with its final value
+void PLL_Start(void){
+  // 1) select the crystal value, with the oscillator source in RCC2 below
+  SYSCTL_RCC_R = (SYSCTL_RCC_R&~SYSCTL_RCC_XTAL_M)   // clear XTAL field, bits 10-6
+                 + (PLL_XTAL<<6);
+  // 2) use RCC2, keep the PLL bypassed, select the main oscillator,
+  //    activate the PLL (PWRDN2 clear) and set the system divider
+  SYSCTL_RCC2_R = RCC2_PLL + SYSCTL_RCC2_BYPASS2;
+}
+
+// switch to the PLL once it has locked
+void PLL_Wait(void){
+  // 3) wait for the PLL to lock by polling PLLLRIS
+  while((SYSCTL_RIS_R&SYSCTL_RIS_PLLLRIS)==0){};  // wait for PLLRIS bit
+  // 4) enable use of PLL by clearing BYPASS
+  SYSCTL_RCC2_R = RCC2_PLL;
+}
 
 // configure the system to get its clock from the PLL
 void PLL_Init(void){
-  // 0) Use RCC2
-  SYSCTL_RCC2_R |=  0x80000000;  // USERCC2
-  // 1) bypass PLL while initializing
-  SYSCTL_RCC2_R |=  0x00000800;  // BYPASS2, PLL bypass
-  // 2) select the crystal value and oscillator source
-  SYSCTL_RCC_R = (SYSCTL_RCC_R &~0x000007C0)   // clear XTAL field, bits 10-6
-                 + 0x00000540;   // 10101, configure for 16 MHz crystal
-  SYSCTL_RCC2_R &= ~0x00000070;  // configure for main oscillator source
-  // 3) activate PLL by clearing PWRDN
-  SYSCTL_RCC2_R &= ~0x00002000;
-  // 4) set the desired system divider
-  SYSCTL_RCC2_R |= 0x40000000;   // use 400 MHz PLL
-  SYSCTL_RCC2_R = (SYSCTL_RCC2_R&~ 0x1FC00000)  // clear system clock divider
-                  + (4<<22);      // configure for 80 MHz clock
-  // 5) wait for the PLL to lock by polling PLLLRIS
-  while((SYSCTL_RIS_R&0x00000040)==0){};  // wait for PLLRIS bit
-  // 6) enable use of PLL by clearing BYPASS
-  SYSCTL_RCC2_R &= ~0x00000800;
+  PLL_Start();
+  PLL_Wait();
 }
 
 
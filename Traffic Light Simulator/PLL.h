@@ -21,143 +21,87 @@
  http://users.ece.utexas.edu/~valvano/
  */
 
-// The #define statement SYSDIV2 initializes
-// the PLL to the desired frequency.
-#define SYSDIV2 4
-// bus frequency is 400MHz/(SYSDIV2+1) = 400MHz/(4+1) = 80 MHz
+// The clock is chosen at compile time: define PLL_HZ (the system clock
+// wanted) and PLL_XTAL_HZ (the crystal on the board) before this header
+// or on the command line. The settings below are worked out from them,
+// and a clock the PLL cannot make exactly, a reserved divider or an
+// unsupported crystal stops the build with #error.
+#ifndef PLL_HZ
+#define PLL_HZ          80000000    // 80 MHz
+#endif
+#ifndef PLL_XTAL_HZ
+#define PLL_XTAL_HZ     16000000    // LaunchPad crystal
+#endif
+
+// system clock = 400 MHz/(SYSDIV2+1), SYSDIV2 = 4 to 127 except 6
+// (see the table at the end of PLL.c); PLL_HZ may be rounded down to
+// whole Hz, e.g. 66666666
+#define PLL_DIVISOR     ((400000000 + PLL_HZ / 2) / PLL_HZ)
+#define SYSDIV2         (PLL_DIVISOR - 1)
+
+// System clock the settings give, for code that needs it at compile time
+#define PLL_CLOCK_HZ    (400000000 / PLL_DIVISOR)
+
+#if PLL_CLOCK_HZ != PLL_HZ
+#error "PLL_HZ must be 400 MHz divided by a whole number"
+#elif SYSDIV2 < 4 || SYSDIV2 == 6 || SYSDIV2 > 127
+#error "PLL_HZ needs a reserved SYSDIV2 divider"
+#endif
+
+// An even divisor n is 200 MHz/(n/2) with DIV400 clear; an odd one needs
+// the 400 MHz output and the extra divider bit SYSDIV2LSB
+#if PLL_DIVISOR % 2 == 0
+#define PLL_RCC2_DIV    ((PLL_DIVISOR / 2 - 1) << 23)
+#else
+#define PLL_RCC2_DIV    (0x40000000 + (SYSDIV2 << 22))
+#endif
+
+// RCC XTAL field for the crystal; the PLL needs 5 to 25 MHz
+#if   PLL_XTAL_HZ == 5000000
+#define PLL_XTAL        0x09
+#elif PLL_XTAL_HZ == 5120000
+#define PLL_XTAL        0x0A
+#elif PLL_XTAL_HZ == 6000000
+#define PLL_XTAL        0x0B
+#elif PLL_XTAL_HZ == 6144000
+#define PLL_XTAL        0x0C
+#elif PLL_XTAL_HZ == 7372800
+#define PLL_XTAL        0x0D
+#elif PLL_XTAL_HZ == 8000000
+#define PLL_XTAL        0x0E
+#elif PLL_XTAL_HZ == 8192000
+#define PLL_XTAL        0x0F
+#elif PLL_XTAL_HZ == 10000000
+#define PLL_XTAL        0x10
+#elif PLL_XTAL_HZ == 12000000
+#define PLL_XTAL        0x11
+#elif PLL_XTAL_HZ == 12288000
+#define PLL_XTAL        0x12
+#elif PLL_XTAL_HZ == 13560000
+#define PLL_XTAL        0x13
+#elif PLL_XTAL_HZ == 14318180
+#define PLL_XTAL        0x14
+#elif PLL_XTAL_HZ == 16000000
+#define PLL_XTAL        0x15
+#elif PLL_XTAL_HZ == 16384000
+#define PLL_XTAL        0x16
+#elif PLL_XTAL_HZ == 18000000
+#define PLL_XTAL        0x17
+#elif PLL_XTAL_HZ == 20000000
+#define PLL_XTAL        0x18
+#elif PLL_XTAL_HZ == 24000000
+#define PLL_XTAL        0x19
+#elif PLL_XTAL_HZ == 25000000
+#define PLL_XTAL        0x1A
+#else
+#error "PLL_XTAL_HZ is not a crystal the PLL can use"
+#endif
 
 // configure the system to get its clock from the PLL
 void PLL_Init(void);
 
+// start the PLL and return at once; the clock does not change yet
+void PLL_Start(void);
 
-/*
-SYSDIV2  Divisor  Clock (MHz)
- 0        1       reserved
- 1        2       reserved
- 2        3       reserved
- 3        4       reserved
- 4        5       80.000
- 5        6       66.667
- 6        7       reserved
- 7        8       50.000
- 8        9       44.444
- 9        10      40.000
- 10       11      36.364
- 11       12      33.333
- 12       13      30.769
- 13       14      28.571
- 14       15      26.667
- 15       16      25.000
- 16       17      23.529
- 17       18      22.222
- 18       19      21.053
- 19       20      20.000
- 20       21      19.048
- 21       22      18.182
- 22       23      17.391
- 23       24      16.667
- 24       25      16.000
- 25       26      15.385
- 26       27      14.815
- 27       28      14.286
- 28       29      13.793
- 29       30      13.333
- 30       31      12.903
- 31       32      12.500
- 32       33      12.121
- 33       34      11.765
- 34       35      11.429
- 35       36      11.111
- 36       37      10.811
- 37       38      10.526
- 38       39      10.256
- 39       40      10.000
- 40       41      9.756
- 41       42      9.524
- 42       43      9.302
- 43       44      9.091
- 44       45      8.889
- 45       46      8.696
- 46       47      8.511
- 47       48      8.333
- 48       49      8.163
- 49       50      8.000
- 50       51      7.843
- 51       52      7.692
- 52       53      7.547
- 53       54      7.407
- 54       55      7.273
- 55       56      7.143
- 56       57      7.018
- 57       58      6.897
- 58       59      6.780
- 59       60      6.667
- 60       61      6.557
- 61       62      6.452
- 62       63      6.349
- 63       64      6.250
- 64       65      6.154
- 65       66      6.061
- 66       67      5.970
- 67       68      5.882
- 68       69      5.797
- 69       70      5.714
- 70       71      5.634
- 71       72      5.556
- 72       73      5.479
- 73       74      5.405
- 74       75      5.333
- 75       76      5.263
- 76       77      5.195
- 77       78      5.128
- 78       79      5.063
- 79       80      5.000
- 80       81      4.938
- 81       82      4.878
- 82       83      4.819
- 83       84      4.762
- 84       85      4.706
- 85       86      4.651
- 86       87      4.598
- 87       88      4.545
- 88       89      4.494
- 89       90      4.444
- 90       91      4.396
- 91       92      4.348
- 92       93      4.301
- 93       94      4.255
- 94       95      4.211
- 95       96      4.167
- 96       97      4.124
- 97       98      4.082
- 98       99      4.040
- 99       100     4.000
- 100      101     3.960
- 101      102     3.922
- 102      103     3.883
- 103      104     3.846
- 104      105     3.810
- 105      106     3.774
- 106      107     3.738
- 107      108     3.704
- 108      109     3.670
- 109      110     3.636
- 110      111     3.604
- 111      112     3.571
- 112      113     3.540
- 113      114     3.509
- 114      115     3.478
- 115      116     3.448
- 116      117     3.419
- 117      118     3.390
- 118      119     3.361
- 119      120     3.333
- 120      121     3.306
- 121      122     3.279
- 122      123     3.252
- 123      124     3.226
- 124      125     3.200
- 125      126     3.175
- 126      127     3.150
- 127      128     3.125
-*/
+// wait for the PLL started by PLL_Start() to lock and switch to it
+void PLL_Wait(void);
@@ -1,42 +0,0 @@
-// SysTick.h
-// Runs on LM4F120 or TM4C123
-// Provide functions that initialize the SysTick module, wait at least a
-// designated number of clock cycles, and wait approximately a multiple
-// of 10 milliseconds using busy wait.  After a power-on-reset, the
-// LM4F120 gets its clock from the 16 MHz precision internal oscillator,
-// which can vary by +/- 1% at room temperature and +/- 3% across all
-// temperature ranges.  If you are using this module, you may need more
-// precise timing, so it is assumed that you are using the PLL to set
-// the system clock to 50 MHz.  This matters for the function
-// SysTick_Wait10ms(), which will wait longer than 10 ms if the clock is
-// slower.
-// Daniel Valvano
-// October 25, 2012
-
-/* This example accompanies the book
-   "Embedded Systems: Real Time Interfacing to Arm Cortex M Microcontrollers",
-   ISBN: 978-1463590154, Jonathan Valvano, copyright (c) 2012
-   Program 2.11, Section 2.6
-
- Copyright 2012 by Jonathan W. Valvano, valvano@mail.utexas.edu
-    You may use, edit, run or distribute this file
-    as long as the above copyright notice remains
- THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
- OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
- MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
- VALVANO SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR SPECIAL, INCIDENTAL,
- OR CONSEQUENTIAL DAMAGES, FOR ANY REASON WHATSOEVER.
- For more information about my classes, my research, and my books, see
- http://users.ece.utexas.edu/~valvano/
- */
-
-// Initialize SysTick with busy wait running at bus clock.
-void SysTick_Init(void);
-
-// Time delay using busy wait.
-// The delay parameter is in units of the core clock. (units of 12.5 nsec for 80 MHz clock)
-void SysTick_Wait(unsigned long delay);
-
-// Time delay using busy wait.
-// This assumes 80 MHz system clock.
-void SysTick_Wait10ms(unsigned long delay);
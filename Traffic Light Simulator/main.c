@@ -17,109 +17,261 @@
 *  @date  07/23/2020
 */
 
+#include "../Common/tm4c123.h"
 #include "PLL.h"
-#include "SysTick.h"
+#include "../SysTick Timer/SysTick.h"
+#include "../SysTick Timer/Periodic.h"
+#include "../SysTick Timer/Speed.h"
+#include "../Common/Debounce.h"
+#include "../Common/Pin.h"
+#include "../Common/Gpio.h"
+#include "../Common/Profile.h"
+#include "Lights.h"
+#ifdef COORD_CYCLE
+#include "../Common/Coord.h"
+#endif
+#ifdef ACTUATED
+#include "../Common/Actuated.h"
+#endif
+#ifdef PREEMPT
+#include "../Common/Preempt.h"
+#endif
+#ifdef HOST_BUILD
+#include <stdio.h>
+#endif
 
-/* Define PortB registers
-   Note: LIGHT and SENSOR are defined by use of bit-specific addressing
-*/
-#define LIGHT                   (*((volatile unsigned long*)0x400050FC))
-#define GPIO_PORTB_OUT          (*((volatile unsigned long*)0x400050FC)) // bits 5-0
-#define GPIO_PORTB_DIR_R        (*((volatile unsigned long*)0x40005400))
-#define GPIO_PORTB_AFSEL_R      (*((volatile unsigned long*)0x40005420))
-#define GPIO_PORTB_DEN_R        (*((volatile unsigned long*)0x4000551C))
-#define GPIO_PORTB_AMSEL_R      (*((volatile unsigned long*)0x40005528))
-#define GPIO_PORTB_PCTL_R       (*((volatile unsigned long*)0x4000552C))
-#define GPIO_PORTE_IN           (*((volatile unsigned long*)0x4002400C)) // bits 1-0
-#define SENSOR                  (*((volatile unsigned long*)0x4002400C))
-
-/* Define Port E registers */
-#define GPIO_PORTE_DIR_R        (*((volatile unsigned long*)0x40024400))
-#define GPIO_PORTE_AFSEL_R      (*((volatile unsigned long*)0x40024420))
-#define GPIO_PORTE_DEN_R        (*((volatile unsigned long*)0x4002451C))
-#define GPIO_PORTE_AMSEL_R      (*((volatile unsigned long*)0x40024528))
-#define GPIO_PORTE_PCTL_R       (*((volatile unsigned long*)0x4002452C))
-#define SYSCTL_RCGC2_R          (*((volatile unsigned long*)0x400FE108))
-#define SYSCTL_RCGC2_GPIOE      0x00000010  // port E Clock Gating Control
-#define SYSCTL_RCGC2_GPIOB      0x00000002  // port B Clock Gating Control
-
-/* MACROs to improve readability */
-#define goN   0
-#define waitN 1
-#define goE   2
-#define waitE 3
-
-/* @fn    PortE_Init(void)
-*  @brief Function to initialize registers of Port E.
-*/
-void PortE_Init(void);
+/* Bit-specific addresses of the lights (PB5-0) and sensors (PE1-0) */
+#define LIGHT                   PIN(GPIO_PORTB_BASE, 0x3F)
+#define GPIO_PORTB_OUT          PIN(GPIO_PORTB_BASE, 0x3F) // bits 5-0
+#define GPIO_PORTE_IN           PIN(GPIO_PORTE_BASE, 0x03) // bits 1-0
+#define SENSOR                  PIN(GPIO_PORTE_BASE, 0x03)
 
-/* @fn    PortB_Init(void)
-*  @brief Function to initialize register of Port B.
-*/
-void PortB_Init(void);
-
-/* Linked data structure to store FSM data */
-struct State {
-  unsigned long Out; 
-  unsigned long Time;  
-  unsigned long Next[4];
-} typedef STyp;
-
-/* Initialize FSM */
-STyp FSM[4]={
-  {0x21, 3000, {goN, waitN, goN, waitN}}, 
-  {0x22, 500, {goE, goE, goE, goE}},
-  {0x0C, 3000, {goE, goE, waitE, waitE}},
-  {0x14, 500, {goN, goN, goN, goN}}
+/* The sensors are debounced through the same address, sampled every tick */
+const unsigned long Sensors[1] = {PIN_ADDR(GPIO_PORTE_BASE, 0x03)};
+
+/* Profiled region, when built with PROFILE: reading the sensors and
+   taking the transition */
+enum {PROF_STEP};
+
+/* FSM times are in 10 ms units: 800000 cycles at 80 MHz */
+#define TICK  (PLL_CLOCK_HZ / 100)
+#if PLL_CLOCK_HZ % 100 != 0
+#error "the PLL clock must be a whole number of cycles per 10 ms"
+#endif
+
+/* Reset clock, the precision internal oscillator, until the PLL takes over */
+#define BOOT_HZ 16000000
+
+/* Corridor coordination, when built with COORD_CYCLE and COORD_OFFSET in
+   10 ms units (see Common/Coord.h): goNorth is the coordinated green, and
+   the sync pulse at the start of the common cycle comes on PE2 */
+#ifdef COORD_CYCLE
+#ifndef COORD_OFFSET
+#define COORD_OFFSET 0
+#endif
+#define SYNC  0x04
+CoordControl Coord;
+#endif
+
+/* Actuated control, when built with ACTUATED (see Common/Actuated.h), in
+   10 ms units: a green holds 10 s, then until 3 s go by without a car on
+   its road, or until the other road has waited 30 s; the yellows as before */
+#ifdef ACTUATED
+#ifdef COORD_CYCLE
+#error "ACTUATED and COORD_CYCLE do not go together"
+#endif
+const ActuatedTiming Actuation[4]={
+  {1000, 3000, 300, 0x02},    // goN: held by cars north
+  {500, 500, 0, 0},
+  {1000, 3000, 300, 0x01},    // goE: held by cars east
+  {500, 500, 0, 0}
  };
+ActuatedControl Act;
+#endif
+
+/* Preemption, when built with PREEMPT (see Common/Preempt.h), in 10 ms
+   units: an emergency vehicle's signal, on PE3 coming north and on PE4
+   coming east, holds its road's green for as long as it is on, and the
+   crosswalk button on PE5 gives 10 s of east green, which the walkway runs
+   alongside. Either cuts a green that has held its minimum, never a yellow. */
+#ifdef PREEMPT
+#if defined(ACTUATED) || defined(COORD_CYCLE)
+#error "PREEMPT goes with neither ACTUATED nor COORD_CYCLE"
+#endif
+#define EMERGENCY_N   0x08
+#define EMERGENCY_E   0x10
+#define WALK          0x20
+#define REQUEST_PINS  (EMERGENCY_N | EMERGENCY_E | WALK)
+#define REQUEST       PIN(GPIO_PORTE_BASE, REQUEST_PINS)
+#define HELD_TICKS    100     // a target held by a signal looks again every second
+const PreemptRequest Preemption[3]={
+  {goN, 500, 0},              // emergency north, PE3: bit 0, first
+  {goE, 500, 0},              // emergency east, PE4
+  {goE, 1000, 1000}           // walk, PE5
+ };
+PreemptControl Pre;
+#endif
 
 /* Index to the current state */
 unsigned long S;
 unsigned long Input; 
+unsigned long Wait;
 
-int main(void) { 
-  volatile unsigned long delay;
+/* The lab's own table: each state holds its time, and the step is the
+   indexed one */
+static unsigned long Table_Step(FsmControl *c, unsigned long input, unsigned long ticks) {
+  (void)ticks;          // each state holds its time, whenever it started
+  c->S = FSM_INDEXED(Index, LIGHTS_SENSORS, c->S, input);
+  return FSM[c->S].Time;
+}
+FsmControl Table = {Table_Step, goN, 0};
+
+/* What steps the lights: the table, or a controller built in */
+FsmControl *Control = &Table;
+
+/* Light timing: every state change is due a whole number of ticks after
+   the start, and Timing holds how late and how far off it actually was */
+Periodic Timing;
+
+/* Boot milestones in cycles since SysTick_Init(), right after reset, on
+   the 16 MHz reset clock: the first lights, and the switch to the PLL */
+unsigned long long BootOutput, BootLocked;
 
-  // initialize PLL at 80 Hz
-  PLL_Init();
+#ifdef COORD_CYCLE
+/* Sync pulses on PE2, on the rising edge */
+static void Sync_Init(void) {
+  GPIO_PORTE_IS_R &= ~SYNC;           // edge-sensitive
+  GPIO_PORTE_IBE_R &= ~SYNC;          // on the one edge chosen by IEV
+  GPIO_PORTE_IEV_R |= SYNC;           // rising
+  GPIO_PORTE_ICR_R = SYNC;            // clear any edge from the setup
+  GPIO_PORTE_IM_R |= SYNC;
+  NVIC_PRI1_R = (NVIC_PRI1_R & ~NVIC_PRI1_INT4_M) | (2 << NVIC_PRI1_INT4_S);   // below SysTick
+  NVIC_EN0_R = NVIC_EN0_INT4;
+}
+
+/* The common cycle starts: on the nearest tick of the light timing */
+void GPIOPortE_Handler(void) {
+  unsigned long long now = SysTick_Now();    // first, so it lags the edge by a fixed time
+  GPIO_PORTE_ICR_R = SYNC;
+  if (Coord.Coordinated) {
+    Coord_Sync(&Coord.Plan, (now - Timing.Start + TICK / 2) / TICK);
+  }
+}
+#endif
+
+#ifdef PREEMPT
+/* Emergency signals on both edges, on and off; the button when pressed */
+static void Requests_Init(void) {
+  GPIO_PORTE_IS_R &= ~REQUEST_PINS;
+  GPIO_PORTE_IBE_R = (GPIO_PORTE_IBE_R & ~WALK) | EMERGENCY_N | EMERGENCY_E;
+  GPIO_PORTE_IEV_R |= WALK;             // rising
+  GPIO_PORTE_ICR_R = REQUEST_PINS;      // clear any edge from the setup
+  GPIO_PORTE_IM_R |= REQUEST_PINS;
+  NVIC_PRI1_R = (NVIC_PRI1_R & ~NVIC_PRI1_INT4_M) | (2 << NVIC_PRI1_INT4_S);   // below SysTick
+  NVIC_EN0_R = NVIC_EN0_INT4;
+  Preempt_Set(&Pre.Ctl, (REQUEST & (EMERGENCY_N | EMERGENCY_E)) >> 3, 0);    // a signal on since reset
+}
+
+/* PE5-3 are request bits 2-0 */
+void GPIOPortE_Handler(void) {
+  unsigned long edges = GPIO_PORTE_MIS_R;
+  unsigned long level = REQUEST;
+  unsigned long on = ((level & (EMERGENCY_N | EMERGENCY_E)) | WALK) & edges;
+  unsigned long off = ~level & (EMERGENCY_N | EMERGENCY_E) & edges;
+  GPIO_PORTE_ICR_R = edges;
+  Preempt_Set(&Pre.Ctl, on >> 3, off >> 3);
+}
+#endif
+
+int main(void) { 
+  // start the PLL first, it takes about 0.5 ms to lock
+  PLL_Start();
   SysTick_Init();
 
   // inputs on PortE, outputs on PortB
-  PortE_Init();
-  PortB_Init();
+  Gpio_Clocks(SYSCTL_RCGC2_GPIOE | SYSCTL_RCGC2_GPIOB);
+#if defined(COORD_CYCLE)
+  GPIO_CONFIG(E, 0x07, 0, 0, 0, 0, 0, 0);   // sensors on PE1-0, sync on PE2
+#elif defined(PREEMPT)
+  GPIO_CONFIG(E, 0x3B, 0, 0, 0, 0, 0, 0);   // sensors on PE1-0, requests on PE5-3
+#else
+  GPIO_CONFIG(E, 0x03, 0, 0, 0, 0, 0, 0);   // sensors on PE1-0
+#endif
+  GPIO_CONFIG(B, 0, 0x3F, 0, 0, 0, 0, 0);   // lights on PB5-0
 
-  // initial state
+  // initial state, shown right away on the reset clock
   S = goN;  
+  LIGHT = FSM[S].Out;
+  BootOutput = SysTick_Now();
+
+  // timing starts on the PLL at 80 MHz
+  PLL_Wait();
+  BootLocked = SysTick_Now();
+#ifdef HOST_BUILD
+  printf("boot: first output %.3f us, PLL %lu Hz in use %.3f us\n",
+    BootOutput * 1e6 / BOOT_HZ, (unsigned long)PLL_CLOCK_HZ, BootLocked * 1e6 / BOOT_HZ);
+#endif
+  PROFILE_INIT();
+  PROFILE_NAME(PROF_STEP, "step");
+  Debounce_Start(Sensors, 1, 0, TICK);
+  Periodic_Start(&Timing, TICK);
+  Wait = FSM[S].Time;
+#ifdef COORD_CYCLE
+  Wait = Coord_Control(&Coord, FSM, Arcs, LIGHTS_STATES, COORD_CYCLE, COORD_OFFSET, S);
+  Control = &Coord.Control;
+  Sync_Init();
+#endif
+#ifdef ACTUATED
+  Wait = Actuated_Control(&Act, FSM, Arcs, Actuation, S);
+  Control = &Act.Control;
+#endif
+#ifdef PREEMPT
+  Wait = Preempt_Control(&Pre, FSM, Arcs, LIGHTS_STATES, Preemption, HELD_TICKS, S);
+  Control = &Pre.Control;
+  Requests_Init();
+#endif
+  Speed_Init();   // times its switches while the first lights are on
 
   while(1) {
 
-    // set lights
+    // set lights, then idle on PIOSC/4 until just before the state ends,
+    // or until the controller looks at the sensors again; not from tick to
+    // tick: each switch of the clock restarts the sensors' sampling period,
+    // which would then never run out
     LIGHT = FSM[S].Out;
-    SysTick_Wait10ms(FSM[S].Time);
+    if (Wait > 1 && Control->Event) {
+      // or until its event, e.g. a request coming or going, which is then
+      // taken at the next tick
+      Speed_SleepEvent(Timing.Next + (unsigned long long)Wait * TICK, SPEED_PIOSC_QUARTER, Control->Event);
+    } else if (Wait > 1) {
+      Speed_Sleep(Timing.Next + (unsigned long long)Wait * TICK, SPEED_PIOSC_QUARTER);
+    }
+    if (Control->Event && *Control->Event) {
+      unsigned long due = (unsigned long)((SysTick_Now() - Timing.Next) / TICK) + 1;
+      Wait = due < Wait ? due : Wait;
+    }
+    Periodic_Wait(&Timing, Wait);
 
-    // read sensors
-    Input = SENSOR;
-    S = FSM[S].Next[Input];  
+    // read sensors, a car must have been seen for 4 ticks
+    PROFILE_START(PROF_STEP);
+    Input = Debounce_State();
+    Wait = Control->Step(Control, Input, Wait);
+    PROFILE_STOP(PROF_STEP);
+#ifdef HOST_BUILD
+    if (Control->S == goN && S != goN) {
+      // once a cycle, as goN comes on: time spent at each clock, and the
+      // way back to 80 MHz
+      const SpeedStats *st = Speed_Stats();
+      unsigned long l;
+      for (l = 0; l < SPEED_LEVELS; l++) {
+        if (st->Hz[l]) {
+          printf("speed: %lu Hz %.3f s, %lu switches, %.1f us there, %.1f us back\n", st->Hz[l],
+            st->Residency[l] / (double)PLL_CLOCK_HZ, st->Switches[l],
+            st->WorstLatency[l] * 1e6 / PLL_CLOCK_HZ, st->WorstRestore[l] * 1e6 / PLL_CLOCK_HZ);
+        }
+      }
+    }
+#endif
+    S = Control->S;
   }
 }
-
-void PortE_Init(void) {
-  SYSCTL_RCGC2_R |= 0x12;      
-  delay = SYSCTL_RCGC2_R;           // no need to unlock
-  GPIO_PORTE_AMSEL_R &= ~0x03;      // disable analog function on PE1-0
-  GPIO_PORTE_PCTL_R &= ~0x000000FF; // enable regular GPIO
-  GPIO_PORTE_DIR_R &= ~0x03;        // inputs on PE1-0
-  GPIO_PORTE_AFSEL_R &= ~0x03;      // regular function on PE1-0
-  GPIO_PORTE_DEN_R |= 0x03;         // enable digital on PE1-0
-}
-
-void PortB_Init(void) {
-  SYSCTL_RCGC2_R |= 0x12;      
-  delay = SYSCTL_RCGC2_R;           // no need to unlock
-  GPIO_PORTB_AMSEL_R &= ~0x3F;      // disable analog function on PB5-0
-  GPIO_PORTB_PCTL_R &= ~0x00FFFFFF; // enable regular GPIO
-  GPIO_PORTB_DIR_R |= 0x3F;         // outputs on PB5-0
-  GPIO_PORTB_AFSEL_R &= ~0x3F;      // regular function on PB5-0
-  GPIO_PORTB_DEN_R |= 0x3F;         // enable digital on PB5-0
-}
@@ -0,0 +1,306 @@
+/** @file   corridor.c
+ *  @brief  Host simulator of a corridor of traffic lights along the north
+ *          road, each running the table of the Traffic Light Simulator,
+ *          on its own, with the coordination of Common/Coord.c, or with the
+ *          actuated control of Common/Actuated.c. Cars enter
+ *          the corridor at random and go through every light; cars on the
+ *          east road arrive at random at every light and cross it. A car
+ *          that finds red or a queue waits, and the queue leaves one car
+ *          every 2 s while its road has green.
+ *
+ *          Uncoordinated, each controller starts at a random time and runs
+ *          its table's own times, as the lab does. Coordinated, they share
+ *          a cycle of the table's length and get a sync pulse at its start,
+ *          and each one's offset is the travel time from the first light.
+ *          Actuated, each starts at a random time and ends a green once its
+ *          road is clear, as the sensors at the stop line see it. Every
+ *          controller's clock is off by up to 50 ppm, as a crystal.
+ *
+ *          For cars through the whole corridor, it prints the mean travel
+ *          time against the time with no lights, the stops a car, and the
+ *          throughput, and for the east road the mean wait and throughput
+ *          at a light. The delay is that of every car at a light, on both
+ *          roads. All modes see the same cars. It checks that no car is
+ *          lost, that every coordinated green ends on its plan, and that
+ *          every actuated green keeps its minimum and ends within its
+ *          maximum of a car waiting on the other road, and that a car that
+ *          comes at the end of a long wait still waits out the maximum from
+ *          when the controller sees it; it exits with 1 if not.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Fsm.h"
+#include "Coord.h"
+#include "Actuated.h"
+#include "../Traffic Light Simulator/Lights.h"
+
+#define TICKS_S         100         // controller ticks are 10 ms, and so are the steps
+#define MAX_LIGHTS      32
+#define RING            65536       // cars a queue can hold
+#define HEADWAY         (2 * TICKS_S)
+#define SPACING_M       400
+#define SPEED_MS        13.9        // 50 km/h
+#define PPM             50
+#define WARMUP          (600 * TICKS_S)
+#define DURATION        (7200 * TICKS_S)
+#define CYCLE           7000        // the table's own cycle with cars on both roads
+
+/* As in Traffic Light Simulator/main.c, built with ACTUATED */
+static const ActuatedTiming Actuation[4] = {
+    {1000, 3000, 300, 0x02},
+    {500, 500, 0, 0},
+    {1000, 3000, 300, 0x01},
+    {500, 500, 0, 0}
+};
+
+enum {UNCOORDINATED, COORDINATED, ACTUATED, MODES};
+static const char *Modes[MODES] = {"uncoordinated", "coordinated", "actuated"};
+
+/* A queue of cars in arrival order: the car and when it gets to the
+   stop line, or reached it */
+typedef struct {
+    unsigned long Car[RING];
+    unsigned long At[RING];
+    unsigned long Head, Tail;
+    unsigned long Free;             // when the stop line can let the next car go
+} Queue;
+
+typedef struct {
+    unsigned long S;
+    unsigned long long Due;         // local tick the state ends, or the controller looks again
+    unsigned long Wait;             // ticks it waited for Due
+    unsigned long Called;           // tick a car came on the other road, while green
+    long Start;                     // global tick the controller starts
+    double Rate;                    // local ticks per tick
+    CoordPlan Plan;
+    Actuated Ctl;
+    Queue North, East;
+} Light;
+
+typedef struct {
+    double Travel, Stops, Throughput, EastWait, EastThroughput, Delay;
+    unsigned long Cars, Lost, OffPlan, Unfair;
+} Result;
+
+static Light Lights[MAX_LIGHTS];
+static unsigned long *Entry, *Stops;
+static unsigned long NumCars, MaxCars;
+
+/* Cheap deterministic random numbers, one stream for the cars and one
+   for the controllers, so both modes see the same cars */
+static unsigned long long Seeds[2];
+static double rnd(int stream) {
+    unsigned long long x = Seeds[stream];
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    Seeds[stream] = x;
+    return (x >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static void push(Queue *q, unsigned long car, unsigned long at) {
+    q->Car[q->Tail % RING] = car;
+    q->At[q->Tail % RING] = at;
+    q->Tail++;
+}
+
+/* Whether a car is at the stop line */
+static int waiting(const Queue *q, unsigned long t) {
+    return q->Head != q->Tail && q->At[q->Head % RING] <= t;
+}
+
+static unsigned long long local(const Light *l, unsigned long t) {
+    return (unsigned long long)(((double)t - l->Start) * l->Rate);
+}
+
+static Result run(unsigned long n, double perHour, double eastPerHour, int mode) {
+    unsigned long travel = (unsigned long)(SPACING_M / SPEED_MS * TICKS_S + 0.5);
+    unsigned long t, i, done = 0, out = 0, outMeasured = 0, stops = 0, eastCars = 0, eastOut = 0;
+    double total = 0, eastTotal = 0;
+    int coordinated = mode == COORDINATED;
+    Result r = {0};
+    Seeds[0] = 88172645463325252ULL;
+    Seeds[1] = 1442695040888963407ULL;
+    NumCars = 0;
+    for (i = 0; i < n; i++) {
+        Light *l = &Lights[i];
+        l->S = goN;
+        l->Wait = mode == ACTUATED ? Actuated_Start(&l->Ctl, Actuation, goN) : 0;
+        l->Due = l->Wait;
+        l->Start = coordinated ? 0 : (long)(rnd(1) * CYCLE);
+        l->Rate = 1 + (rnd(1) * 2 - 1) * PPM * 1e-6;
+        l->Called = l->Start;
+        l->North.Head = l->North.Tail = l->North.Free = 0;
+        l->East.Head = l->East.Tail = l->East.Free = 0;
+        // a platoon leaving light 0 at the start of its green reaches light i
+        // i travel times later
+        Coord_Plan(&l->Plan, FSM, Arcs, LIGHTS_STATES, CYCLE, i * travel);
+    }
+    for (t = 0; t < DURATION; t++) {
+        if (rnd(0) < perHour / 3600 / TICKS_S && NumCars < MaxCars) {
+            Entry[NumCars] = t;
+            Stops[NumCars] = 0;
+            push(&Lights[0].North, NumCars++, t + travel);
+        }
+        for (i = 0; i < n; i++) {
+            Light *l = &Lights[i];
+            unsigned long long now;
+            if (rnd(0) < eastPerHour / 3600 / TICKS_S) {
+                push(&l->East, 0, t);
+            }
+            if ((long)t < l->Start) {
+                continue;
+            }
+            now = local(l, t);
+            if (coordinated && t % CYCLE == 0) {
+                Coord_Sync(&l->Plan, now);          // the sync pulse
+            }
+            // the controller: reads the sensors when the state's time is up
+            while (now >= l->Due) {
+                unsigned long in = waiting(&l->East, t) | waiting(&l->North, t) << 1;
+                unsigned long next;
+                if (mode == ACTUATED) {
+                    unsigned long held = l->Ctl.Held + l->Wait, s = l->S;
+                    l->Wait = Actuated_Step(&l->Ctl, FSM, Arcs, Actuation, in, l->Wait);
+                    l->Due += l->Wait;
+                    l->S = l->Ctl.S;
+                    // a green keeps its minimum, and a car on the other road
+                    // waits no more than its maximum, plus the minimum before
+                    // the controller looks
+                    if (l->S != s && (s == goN || s == goE) &&
+                        (held < Actuation[s].Min || t - l->Called > Actuation[s].Max + Actuation[s].Min)) {
+                        r.Unfair++;
+                    }
+                    continue;
+                }
+                next = coordinated ? Coord_Next(FSM, Arcs, l->S, in) : Fsm_Next(FSM, Arcs, l->S, in);
+                if (coordinated && l->S == goN && next != goN) {
+                    // within a tick, which the drift between two pulses may take
+                    unsigned long at = (unsigned long)((l->Due + CYCLE - l->Plan.Epoch) % CYCLE);
+                    unsigned long end = (l->Plan.Offset + l->Plan.Green) % CYCLE;
+                    if ((at + CYCLE - end) % CYCLE > 1 && (end + CYCLE - at) % CYCLE > 1) {
+                        r.OffPlan++;
+                    }
+                }
+                l->S = next;
+                l->Due += coordinated ? Coord_Wait(&l->Plan, FSM, l->S, l->Due) : FSM[l->S].Time;
+            }
+            if (!waiting(l->S == goN ? &l->East : &l->North, t) || (l->S != goN && l->S != goE)) {
+                l->Called = t;
+            }
+            // one car a headway from the road with green
+            if (l->S == goN && waiting(&l->North, t) && t >= l->North.Free) {
+                Queue *q = &l->North;
+                unsigned long car = q->Car[q->Head % RING];
+                if (t - q->At[q->Head % RING] > HEADWAY) {
+                    Stops[car]++;
+                }
+                q->Head++;
+                q->Free = t + HEADWAY;
+                if (i + 1 < n) {
+                    push(&Lights[i + 1].North, car, t + travel);
+                } else {
+                    out++;
+                    outMeasured += t >= WARMUP;
+                    if (Entry[car] >= WARMUP) {
+                        total += t - Entry[car];
+                        stops += Stops[car];
+                        done++;
+                    }
+                }
+            }
+            if (l->S == goE && waiting(&l->East, t) && t >= l->East.Free) {
+                Queue *q = &l->East;
+                eastOut += t >= WARMUP;
+                if (q->At[q->Head % RING] >= WARMUP) {
+                    eastTotal += t - q->At[q->Head % RING];
+                    eastCars++;
+                }
+                q->Head++;
+                q->Free = t + HEADWAY;
+            }
+        }
+    }
+    // every car is out or still in a queue
+    r.Lost = NumCars - out;
+    for (i = 0; i < n; i++) {
+        r.Lost -= Lights[i].North.Tail - Lights[i].North.Head;
+    }
+    r.Cars = done;
+    r.Travel = done ? total / done / TICKS_S : 0;
+    r.Stops = done ? (double)stops / done : 0;
+    r.Throughput = outMeasured * 3600.0 * TICKS_S / (DURATION - WARMUP);
+    r.EastWait = eastCars ? eastTotal / eastCars / TICKS_S : 0;
+    r.EastThroughput = eastOut * 3600.0 * TICKS_S / (DURATION - WARMUP) / n;
+    r.Delay = (total - (double)done * n * travel + eastTotal) / (done * n + eastCars) / TICKS_S;
+    return r;
+}
+
+/* A car east that comes at the last tick of goNorth's first, long wait,
+   with cars north all along so no gap ends it: the green must hold its
+   maximum from the step that saw the car, not from the wait before it.
+   Returns the ticks from that step to the end of the green. */
+static unsigned long late_call(void) {
+    Actuated a;
+    unsigned long wait = Actuated_Start(&a, Actuation, goN), seen = wait, held = 0;
+    while (a.S == goN) {
+        held += wait;
+        wait = Actuated_Step(&a, FSM, Arcs, Actuation, held < seen ? 0x02 : 0x03, wait);
+    }
+    return held - seen;
+}
+
+static void report(const char *mode, const Result *r) {
+    printf("%-14s %8.1f s %6.2f %7.0f/h %8.1f s %7.0f/h %8.1f s\n", mode, r->Travel, r->Stops,
+           r->Throughput, r->EastWait, r->EastThroughput, r->Delay);
+}
+
+int main(int argc, char **argv) {
+    unsigned long n = argc > 1 ? strtoul(argv[1], 0, 0) : 8;
+    double perHour = argc > 2 ? atof(argv[2]) : 600;
+    double eastPerHour = argc > 3 ? atof(argv[3]) : 200;
+    double freeFlow = n * (double)(unsigned long)(SPACING_M / SPEED_MS * TICKS_S + 0.5) / TICKS_S;
+    unsigned long failed = 0, m;
+    Result r[MODES];
+    if (argc > 4 || n < 1 || n > MAX_LIGHTS || perHour <= 0 || eastPerHour < 0) {
+        fprintf(stderr, "usage: %s [lights [cars/h [east cars/h]]]\n", argv[0]);
+        return 2;
+    }
+    MaxCars = (unsigned long)(perHour * 3 * DURATION / TICKS_S / 3600) + 1000;
+    Entry = malloc(MaxCars * sizeof(*Entry));
+    Stops = malloc(MaxCars * sizeof(*Stops));
+    if (!Entry || !Stops) {
+        fprintf(stderr, "out of memory\n");
+        return 2;
+    }
+    printf("%lu lights %u m apart, %.0f cars/h north, %.0f cars/h east at each, %.1f s with no lights\n",
+           n, SPACING_M, perHour, eastPerHour, freeFlow);
+    printf("%-14s %10s %6s %9s %10s %9s %10s\n", "", "travel", "stops", "north", "east wait", "east", "delay");
+    for (m = 0; m < MODES; m++) {
+        r[m] = run(n, perHour, eastPerHour, m);
+        report(Modes[m], &r[m]);
+        if (r[m].Lost) {
+            printf("cars lost: %lu\n", r[m].Lost);
+            failed++;
+        }
+    }
+    if (r[COORDINATED].OffPlan) {
+        printf("greens ended off their plan: %lu\n", r[COORDINATED].OffPlan);
+        failed++;
+    }
+    m = late_call();
+    if (m + 1 < Actuation[goN].Max || m > Actuation[goN].Max) {
+        printf("a late call ended the green %lu ticks after it was seen, maximum %u\n", m, Actuation[goN].Max);
+        failed++;
+    }
+    if (r[ACTUATED].Unfair) {
+        printf("greens out of their minimum and maximum: %lu\n", r[ACTUATED].Unfair);
+        failed++;
+    }
+    free(Entry);
+    free(Stops);
+    return failed != 0;
+}
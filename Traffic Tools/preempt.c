@@ -0,0 +1,224 @@
+/** @file   preempt.c
+ *  @brief  Host check of the preemption of Common/Preempt.c on the table
+ *          of the Traffic Light Simulator, built with PREEMPT. Each request
+ *          is raised at every tick of the table's cycle in turn, with the
+ *          sensors showing no car, a car on one road or on both, or cars
+ *          coming and going at random, and the controller runs tick by
+ *          tick as the firmware does: at the end of each wait, or at the
+ *          tick after a request came or went.
+ *
+ *          Every run checks that the lights only take the table's own
+ *          transitions, that every yellow runs its full time, that no green
+ *          is cut below the smallest minimum of the requests, and that the
+ *          first change and the request's target come within the bound of
+ *          Preempt_Bound(), one tick for the request to be seen included.
+ *          An emergency lets go 20 s after it got its green, and the walk
+ *          request must then hold its green its full 10 s. The same is done
+ *          with an emergency coming while the walk request is served, and
+ *          every request must be gone at the end of the run.
+ *
+ *          It prints each request's bound and the worst and mean latency
+ *          measured, and exits with 1 if any check failed.
+ *  @author Mustafa Siddiqui
+ *  @date   10/16/2026
+ */
+
+#include <stdio.h>
+#include "Fsm.h"
+#include "Preempt.h"
+#include "../Traffic Light Simulator/Lights.h"
+
+#define TICKS_S         100         // controller ticks are 10 ms
+#define CYCLE           7000        // the table's own cycle with cars on both roads
+#define HELD_TICKS      100         // as in main.c
+#define EMERGENCY       (20 * TICKS_S)
+#define RUN             (120 * TICKS_S)
+#define RANDOM          4           // sensor mode with cars coming and going
+
+/* As in Traffic Light Simulator/main.c, built with PREEMPT */
+static const PreemptRequest Preemption[3] = {
+    {goN, 500, 0},
+    {goE, 500, 0},
+    {goE, 1000, 1000}
+};
+static const char *Names[3] = {"emergency north", "emergency east", "walk"};
+#define REQUESTS 3
+#define WALK     2
+
+typedef struct {
+    unsigned long Runs;
+    unsigned long Worst[2];         // ticks to the first change, and to the target
+    double Sum[2];
+} Latency;
+
+static Latency Measured[REQUESTS];
+static unsigned long Bound[REQUESTS][2];
+static unsigned long Failed;
+
+/* Cars at the stop lines; at random, each road changes every 2 s or so */
+static unsigned long sensors(unsigned long mode, unsigned long seed, unsigned long t) {
+    unsigned long h;
+    if (mode != RANDOM) {
+        return mode;
+    }
+    h = (t / 200 + seed) * 2654435761UL;
+    return (h >> 13) & 3;
+}
+
+static int legal(unsigned long from, unsigned long to) {
+    unsigned long i;
+    if (FSM[from].Default == to) {
+        return 1;
+    }
+    for (i = 0; i < FSM[from].Count; i++) {
+        if (Arcs[FSM[from].First + i].Next == to) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void fail(const char *what, unsigned long k, unsigned long at, unsigned long mode, unsigned long t) {
+    if (Failed++ < 10) {
+        printf("%s: %s at tick %lu, sensors %lu, tick %lu\n", what, Names[k], at, mode, t);
+    }
+}
+
+/* Runs the controller from reset, raises request k at tick 'at' and, if
+   'then' is a request, that one 'after' ticks later. A request raised at a
+   tick came since the tick before, and its latency counts from then. */
+static void run(unsigned long k, unsigned long at, unsigned long mode,
+                unsigned long then, unsigned long after) {
+    Preempt p;
+    unsigned long due = Preempt_Start(&p, FSM, goN), last = 0, entered = 0, s = goN;
+    unsigned long raised[2] = {k, then}, when[2] = {at, at + after}, first[2] = {0, 0}, reached[2] = {0, 0};
+    unsigned long i, t, w, next, least = FSM[goN].Time;
+    for (i = 0; i < REQUESTS; i++) {
+        least = Preemption[i].Min < least ? Preemption[i].Min : least;
+    }
+    for (t = 1; t < when[0] + RUN; t = next) {
+        for (i = 0; i < 2; i++) {
+            if (raised[i] >= REQUESTS) {
+                continue;
+            }
+            if (t == when[i]) {
+                Preempt_Set(&p, 1UL << raised[i], 0);
+                if (p.S == Preemption[raised[i]].Target) {
+                    reached[i] = t;     // already there: nothing to change
+                    first[i] = t;
+                }
+            }
+            if (reached[i] && !Preemption[raised[i]].Hold && t == reached[i] + EMERGENCY) {
+                Preempt_Set(&p, 0, 1UL << raised[i]);
+            }
+        }
+        // nothing happens until the next wait is over, or a request comes or goes
+        next = due > t ? due : t + 1;
+        for (i = 0; i < 2; i++) {
+            if (raised[i] < REQUESTS) {
+                next = when[i] > t && when[i] < next ? when[i] : next;
+                next = reached[i] && reached[i] + EMERGENCY > t && reached[i] + EMERGENCY < next
+                     ? reached[i] + EMERGENCY : next;
+            }
+        }
+        if (!p.Changed && t != due) {
+            continue;
+        }
+        p.Changed = 0;
+        w = Preempt_Step(&p, FSM, Arcs, LIGHTS_STATES, Preemption, sensors(mode, at, t), t - last);
+        last = t;
+        due = t + (w == PREEMPT_IDLE ? HELD_TICKS : w);
+        next = due < next ? due : next;
+        if (p.S == s) {
+            continue;
+        }
+        if (!legal(s, p.S)) {
+            fail("not a transition of the table", k, at, mode, t);
+        }
+        if (FSM[s].Count == 0 ? t - entered != FSM[s].Time : t - entered < least) {
+            fail("state cut short", k, at, mode, t);
+        }
+        for (i = 0; i < 2; i++) {
+            if (raised[i] < REQUESTS && t >= when[i]) {
+                first[i] = first[i] ? first[i] : t;
+                if (!reached[i] && p.S == Preemption[raised[i]].Target) {
+                    reached[i] = t;
+                }
+            }
+        }
+        if (raised[0] == WALK && reached[0] && s == goE && p.S != goE && t - entered < Preemption[WALK].Hold
+            && !(raised[1] < REQUESTS && t >= when[1])) {
+            fail("walk cut short", k, at, mode, t);
+        }
+        s = p.S;
+        entered = t;
+    }
+    if (p.Requests) {
+        fail("request never done", k, at, mode, t);
+    }
+    for (i = 0; i < 2; i++) {
+        // the walk waits for an emergency behind it, so only the one of
+        // highest priority has its bound
+        unsigned long r = raised[i];
+        unsigned long from = when[i] - 1;
+        if (r >= REQUESTS || (i == 0 && then < REQUESTS)) {
+            continue;
+        }
+        if (!reached[i]) {
+            fail("target never reached", r, at, mode, t);
+            continue;
+        }
+        if (first[i] - from > Bound[r][0] + 1 || reached[i] - from > Bound[r][1] + 1) {
+            fail("over the bound", r, at, mode, t);
+        }
+        Measured[r].Runs++;
+        Measured[r].Sum[0] += first[i] - from;
+        Measured[r].Sum[1] += reached[i] - from;
+        if (first[i] - from > Measured[r].Worst[0]) {
+            Measured[r].Worst[0] = first[i] - from;
+        }
+        if (reached[i] - from > Measured[r].Worst[1]) {
+            Measured[r].Worst[1] = reached[i] - from;
+        }
+    }
+}
+
+int main(void) {
+    static const unsigned long afters[] = {1, 50, 300, 700};
+    unsigned long k, at, mode, a, runs = 0;
+    for (k = 0; k < REQUESTS; k++) {
+        Preempt_Bound(FSM, Arcs, LIGHTS_STATES, &Preemption[k], &Bound[k][0], &Bound[k][1]);
+        if (!Bound[k][0]) {
+            printf("%s cannot reach its target from every state\n", Names[k]);
+            return 1;
+        }
+    }
+    // a cycle from reset to settle, then every tick of the next one
+    for (mode = 0; mode <= RANDOM; mode++) {
+        for (at = CYCLE + 1; at <= 2 * CYCLE; at++) {
+            for (k = 0; k < REQUESTS; k++) {
+                run(k, at, mode, REQUESTS, 0);
+                runs++;
+            }
+            for (a = 0; a < sizeof(afters) / sizeof(afters[0]); a++) {
+                run(WALK, at, mode, 0, afters[a]);
+                run(WALK, at, mode, 1, afters[a]);
+                runs += 2;
+            }
+        }
+    }
+    printf("%lu runs, requests at every tick of the %.0f s cycle\n", runs, CYCLE / (double)TICKS_S);
+    printf("%-16s %12s %12s %12s %12s %12s %12s\n", "", "first bound", "worst", "mean",
+           "target bound", "worst", "mean");
+    for (k = 0; k < REQUESTS; k++) {
+        Latency *l = &Measured[k];
+        printf("%-16s %10.2f s %10.2f s %10.2f s %10.2f s %10.2f s %10.2f s\n", Names[k],
+               (Bound[k][0] + 1) / (double)TICKS_S, l->Worst[0] / (double)TICKS_S,
+               l->Sum[0] / l->Runs / TICKS_S, (Bound[k][1] + 1) / (double)TICKS_S,
+               l->Worst[1] / (double)TICKS_S, l->Sum[1] / l->Runs / TICKS_S);
+    }
+    if (Failed) {
+        printf("failed: %lu\n", Failed);
+    }
+    return Failed != 0;
+}